@@ -0,0 +1,304 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "osal.h"
+#include "ArgParser.h"
+#include "DbcFileCanMsgDatabase.h"
+#include "CanMsgDecoder.h"
+#include "CanMsgBatchDecoder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+using namespace std;
+
+
+/** \brief Decoder listener which sums the converted values of the decoded signals so that the decoding can't be optimized out */
+class ChecksumDecoderListener : public ICanMsgDecoderListener
+{
+    public:
+
+        /** \brief Constructor */
+        ChecksumDecoderListener()
+        : m_checksum(0.)
+        , m_signal_count(0u)
+        {}
+
+        /** \brief Called when message has been decoded, the decoded frame is only valid during the call */
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) override
+        {
+            (void)can_msg;
+            const vector<size_t>& decoded_signals = decoded_frame.getDecodedSignals();
+            for (size_t i = 0; i < decoded_signals.size(); i++)
+            {
+                m_checksum += decoded_frame.getConvertedValue(decoded_signals[i]).double_value;
+            }
+            m_signal_count += decoded_signals.size();
+        }
+
+        /** \brief Sum of the converted values */
+        double m_checksum;
+
+        /** \brief Number of decoded signals */
+        uint64_t m_signal_count;
+};
+
+
+/** \brief Write a DBC file with CAN messages made of signals of the same size which fill the whole payload */
+static bool writeDatabase(const string& dbc_file, const uint32_t msg_count, const uint8_t signal_count, const bool big_endian)
+{
+    const uint32_t size_in_bits = 64u / signal_count;
+
+    ostringstream dbc;
+    dbc << "VERSION \"\"" << endl << endl << "BU_: A B" << endl;
+    for (uint32_t msg = 0; msg < msg_count; msg++)
+    {
+        dbc << endl << "BO_ " << (0x100u + msg) << " Message_" << msg << ": 8 A" << endl;
+        for (uint32_t signal = 0; signal < signal_count; signal++)
+        {
+            // The start bit of a big endian signal is its most significant bit
+            uint32_t start_bit = signal * size_in_bits;
+            if (big_endian)
+            {
+                start_bit = ((start_bit / 8u) * 8u) + (7u - (start_bit % 8u));
+            }
+            dbc << " SG_ Signal_" << msg << "_" << signal << " : " << start_bit << "|" << size_in_bits << "@" << (big_endian ? "0" : "1")
+                << (((signal % 2u) == 0) ? "-" : "+") << " (0.5,-10) [-1E+30|1E+30] \"unit\" B" << endl;
+        }
+    }
+
+    ofstream file(dbc_file, ios::binary);
+    file << dbc.str();
+    return file.good();
+}
+
+/** \brief Build the CAN messages to decode, the ids of the database are received in turn */
+static void buildFrames(const uint32_t msg_count, const size_t frame_count, const bool repeat, vector<CanData>& frames)
+{
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+    frames.resize(frame_count);
+    for (size_t i = 0; i < frame_count; i++)
+    {
+        const uint32_t msg = static_cast<uint32_t>(i % msg_count);
+        random ^= (random << 13u);
+        random ^= (random >> 7u);
+        random ^= (random << 17u);
+
+        CanData& can_data = frames[i];
+        can_data = CanData();
+        can_data.header.type = CAN_DATA_RX_MSG;
+        can_data.header.timestamp_nsec = static_cast<uint32_t>(i);
+        can_data.msg.id = 0x100u + msg;
+        can_data.msg.size = CAN_MSG_MAX_LEN;
+        for (uint8_t j = 0; j < CAN_MSG_MAX_LEN; j++)
+        {
+            can_data.msg.data[j] = static_cast<uint8_t>(random >> (j * 8u));
+        }
+        if (repeat && (i >= msg_count))
+        {
+            // Same payload as the first reception of the CAN message
+            memcpy(can_data.msg.data, frames[msg].msg.data, CAN_MSG_MAX_LEN);
+        }
+    }
+}
+
+/** \brief Print a throughput line */
+static void printThroughput(const char* decoder, const double duration_ns, const size_t frame_count, const uint64_t signal_count, const double checksum)
+{
+    cout << "  " << decoder << " : " << (duration_ns / static_cast<double>(frame_count)) << " ns/frame, "
+         << ((static_cast<double>(frame_count) * 1000.) / duration_ns) << " Mframes/s, "
+         << ((static_cast<double>(signal_count) * 1000.) / duration_ns) << " Msignals/s (checksum = " << checksum << ")" << endl;
+}
+
+/** \brief Measure the decoding throughput for CAN messages with a given number of signals */
+static bool runBenchmark(const string& dbc_file, const uint32_t msg_count, const uint8_t signal_count, const bool big_endian,
+                         const vector<CanData>& frames, const uint32_t iterations)
+{
+    bool ret = writeDatabase(dbc_file, msg_count, signal_count, big_endian);
+    if (ret)
+    {
+        DbcFileCanMsgDatabase database;
+        ret = database.load(dbc_file);
+        remove(dbc_file.c_str());
+        if (ret)
+        {
+            cout << "Signals per CAN message : " << static_cast<uint32_t>(signal_count) << endl;
+
+            // Frame by frame decoding
+            CanMsgDecoder decoder;
+            ChecksumDecoderListener listener;
+            decoder.setCanMsgDatabase(database);
+            decoder.setListener(listener);
+            auto start = chrono::steady_clock::now();
+            for (uint32_t iteration = 0; iteration < iterations; iteration++)
+            {
+                for (size_t i = 0; i < frames.size(); i++)
+                {
+                    decoder.canDataReceived(frames[i]);
+                }
+            }
+            double duration_ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+            printThroughput("CanMsgDecoder     ", duration_ns, frames.size() * iterations, listener.m_signal_count, listener.m_checksum);
+            cout << "    decoded = " << decoder.getDecodeCount() << ", cache hits = " << decoder.getCacheHitCount() << endl;
+
+            // Batch decoding
+            vector<CanMsg> can_msgs(frames.size());
+            for (size_t i = 0; i < frames.size(); i++)
+            {
+                can_msgs[i] = frames[i].msg;
+            }
+            CanMsgBatchDecoder batch_decoder(database);
+            const size_t batch_size = 4096u;
+            uint64_t batch_signal_count = 0u;
+            double batch_checksum = 0.;
+            duration_ns = 0.;
+            for (uint32_t iteration = 0; iteration < iterations; iteration++)
+            {
+                for (size_t i = 0; i < can_msgs.size(); i += batch_size)
+                {
+                    start = chrono::steady_clock::now();
+                    batch_decoder.decode(&can_msgs[i], min(batch_size, can_msgs.size() - i));
+                    duration_ns += static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+
+                    const vector<CanMsgBatchDecoder::Column>& columns = batch_decoder.getColumns();
+                    for (size_t j = 0; j < columns.size(); j++)
+                    {
+                        for (size_t k = 0; k < columns[j].converted_values.size(); k++)
+                        {
+                            batch_checksum += columns[j].converted_values[k];
+                        }
+                        batch_signal_count += columns[j].raw_values.size();
+                    }
+                    batch_decoder.clear();
+                }
+            }
+            printThroughput("CanMsgBatchDecoder", duration_ns, can_msgs.size() * iterations, batch_signal_count, batch_checksum);
+        }
+        else
+        {
+            cerr << "Error : unable to load the generated database => " << database.getLastError() << endl;
+        }
+    }
+    else
+    {
+        cerr << "Error : unable to write the generated database => " << dbc_file << endl;
+    }
+
+    return ret;
+}
+
+
+/** \brief Application's entry point */
+int main(int argc, const char* argv[])
+{
+    int ret = 1;
+
+    vector<IArgument*> args = {
+                                new Argument<uint32_t>("--frames", "frames", "Number of CAN messages decoded per iteration (default = 100000)", false),
+                                new Argument<uint32_t>("--iterations", "iterations", "Number of iterations (default = 10)", false),
+                                new Argument<uint32_t>("--messages", "messages", "Number of CAN messages in the database (default = 16)", false),
+                                new Argument<uint8_t>("--signals", "signals", "Numbers of signals per CAN message to measure, 1 to 64 (default = 1 8 32)", false, 1u, 8u),
+                                new SingleArgument<bool>("--big_endian", "big_endian", "Use big endian (Motorola) signals", false),
+                                new SingleArgument<bool>("--repeat", "repeat", "Receive the same payload for each CAN message (measures the decoding cache)", false),
+                                new Argument<string>("--database", "database", "Path of the temporary DBC file (default = can_decoder_bench.dbc)", false)
+                              };
+    ArgParser arg_parser(args);
+    bool valid = arg_parser.parse(argc, argv);
+    if (!valid)
+    {
+        return ret;
+    }
+
+    // Extract parameters
+    uint32_t frame_count = 100000u;
+    if (arg_parser["frames"])
+    {
+        frame_count = arg_parser.value<uint32_t>("frames");
+    }
+    uint32_t iterations = 10u;
+    if (arg_parser["iterations"])
+    {
+        iterations = arg_parser.value<uint32_t>("iterations");
+    }
+    uint32_t msg_count = 16u;
+    if (arg_parser["messages"])
+    {
+        msg_count = arg_parser.value<uint32_t>("messages");
+    }
+    vector<uint8_t> signal_counts = { 1u, 8u, 32u };
+    if (arg_parser["signals"])
+    {
+        signal_counts.clear();
+        arg_parser.values<uint8_t>("signals", signal_counts);
+    }
+    const bool big_endian = arg_parser["big_endian"];
+    const bool repeat = arg_parser["repeat"];
+    string dbc_file = "can_decoder_bench.dbc";
+    if (arg_parser["database"])
+    {
+        dbc_file = arg_parser.value<string>("database");
+    }
+
+    cout << "-------------------------" << endl;
+    cout << "  CAN decoder benchmark" << endl;
+    cout << "-------------------------" << endl;
+    cout << endl;
+    cout << "CAN messages : " << frame_count << " x " << iterations << " iterations" << endl;
+    cout << "CAN messages in the database : " << msg_count << endl;
+    cout << "Byte order : " << (big_endian ? "big endian" : "little endian") << endl;
+    cout << "Repeated payloads : " << (repeat ? "on" : "off") << endl;
+    cout << endl;
+
+    valid = ((frame_count != 0) && (iterations != 0) && (msg_count != 0) && (msg_count <= 0x700u));
+    for (size_t i = 0; valid && (i < signal_counts.size()); i++)
+    {
+        valid = ((signal_counts[i] != 0) && (signal_counts[i] <= 64u));
+    }
+    if (valid)
+    {
+        // Initialize OS abstraction layer
+        if (OSAL_Init())
+        {
+            vector<CanData> frames;
+            buildFrames(msg_count, frame_count, repeat, frames);
+
+            ret = 0;
+            for (size_t i = 0; (ret == 0) && (i < signal_counts.size()); i++)
+            {
+                if (!runBenchmark(dbc_file, msg_count, signal_counts[i], big_endian, frames, iterations))
+                {
+                    ret = 1;
+                }
+            }
+        }
+        else
+        {
+            cerr << "Error : Unable to initialize OS abstraction layer" << endl;
+        }
+    }
+    else
+    {
+        cerr << "Error : Invalid parameters" << endl;
+    }
+
+    return ret;
+}
@@ -23,13 +23,14 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "CanMsgStreamLogger.h"
 #include "WhiteListCanMsgFilter.h"
 #include "BlackListCanMsgFilter.h"
+#include "ChangeDetectCanMsgFilter.h"
 #include "XmlFileCanMsgDatabase.h"
+#include "BinaryFileCanMsgDatabase.h"
 #include "CanMsgDecoder.h"
 #include "DecodedCanMsgStreamLogger.h"
 
-#include <cstdio>
-
 #include <iostream>
+#include <memory>
 using namespace std;
 
 /** \brief Application's entry point */
@@ -43,7 +44,10 @@ int main(int argc, const char* argv[])
                                 new Argument<uint16_t>("--bitrate", "bitrate", "CAN bitrate in kbit/s", true),
                                 new Argument<uint32_t>("--white_list", "white_list", "White list => only the selected CAN ids will be displayed", false, 1u, 1000u),
                                 new Argument<uint32_t>("--black_list", "black_list", "Black list => the selected CAN ids will never be displayed", false, 1u, 1000u),
-                                new Argument<string>("--database", "database", "XML CAN message database file", false)
+                                new Argument<uint32_t>("--change_only", "heartbeat", "Display a CAN message only when its payload has changed or every heartbeat ms (0 = no heartbeat)", false),
+                                new Argument<string>("--database", "database", "XML CAN message database file", false),
+                                new Argument<string>("--database_cache", "database_cache", "Binary cache of the XML CAN message database file, rebuilt when the database file changes", false),
+                                new SingleArgument<bool>("--lazy_database", "lazy_database", "Build the CAN messages of the database only when they are received (the database cache is not used)", false)
                               };
     ArgParser arg_parser(args);
     bool valid = arg_parser.parse(argc, argv);
@@ -70,11 +74,22 @@ int main(int argc, const char* argv[])
     {
         arg_parser.values<uint32_t>("black_list", black_list);
     }
+    uint32_t heartbeat = 0u;
+    if (arg_parser["heartbeat"])
+    {
+        heartbeat = arg_parser.value<uint32_t>("heartbeat");
+    }
     string database = "";
     if (arg_parser["database"])
     {
         database = arg_parser.value<string>("database");
     }
+    string database_cache = "";
+    if (arg_parser["database_cache"])
+    {
+        database_cache = arg_parser.value<string>("database_cache");
+    }
+    const bool lazy_database = arg_parser["lazy_database"];
 
     cout << "-------------------------" << endl;
     cout << "      CAN dump tool" << endl;
@@ -106,10 +121,22 @@ int main(int argc, const char* argv[])
             cout << "}" << std::dec << endl;
         }
     }
+    if (arg_parser["heartbeat"])
+    {
+        cout << "Change only : heartbeat = " << heartbeat << "ms" << endl;
+    }
     if (arg_parser["database"])
     {
         cout << "Database : " << database << endl;
     }
+    if (arg_parser["database_cache"])
+    {
+        cout << "Database cache : " << database_cache << endl;
+    }
+    if (lazy_database)
+    {
+        cout << "Lazy database : on" << endl;
+    }
     cout << endl;
 
     cout << "Opening CAN adapter..." << endl;
@@ -117,14 +144,29 @@ int main(int argc, const char* argv[])
     // Initialize OS abstraction layer
     if (OSAL_Init())
     {
-        // Open database
+        // Open database, the cache is used only if it has been built from the current content of the database file
         XmlFileCanMsgDatabase xml_database;
+        BinaryFileCanMsgDatabase bin_database;
+        const ICanMsgDatabase* can_msg_database = &xml_database;
         if (arg_parser["database"])
         {
-            valid = xml_database.load(database);
-            if (!valid)
+            uint64_t database_hash = 0;
+            const bool use_cache = (!lazy_database && arg_parser["database_cache"] && BinaryFileCanMsgDatabase::computeFileHash(database, database_hash));
+            if (use_cache && bin_database.load(database_cache, database_hash))
+            {
+                can_msg_database = &bin_database;
+            }
+            else
             {
-                cout << "Error : unable to load database file => " << xml_database.getLastError() << endl;
+                valid = xml_database.load(database, lazy_database);
+                if (!valid)
+                {
+                    cout << "Error : unable to load database file => " << xml_database.getLastError() << endl;
+                }
+                else if (use_cache && !bin_database.save(xml_database, database_cache, database_hash))
+                {
+                    cout << "Warning : unable to save database cache file => " << bin_database.getLastError() << endl;
+                }
             }
         }
         if (valid)
@@ -156,8 +198,10 @@ int main(int argc, const char* argv[])
                                 black_list_filter.add(black_list[i], false);
                             }
 
+                            ChangeDetectCanMsgFilter change_detect_filter(heartbeat);
+
                             CanMsgDecoder can_msg_decoder;
-                            can_msg_decoder.setCanMsgDatabase(xml_database);
+                            can_msg_decoder.setCanMsgDatabase(*can_msg_database);
                             DecodedCanMsgStreamLogger decoded_logger;
                             decoded_logger.setOutputOptions(cout, DecodedCanMsgStreamLogger::OUT_TEXT);
                             can_msg_decoder.setListener(decoded_logger);
@@ -175,6 +219,12 @@ int main(int argc, const char* argv[])
                                 listener = &can_logger;
                             }
 
+                            if (arg_parser["heartbeat"])
+                            {
+                                change_detect_filter.addChild(*listener);
+                                listener = &change_detect_filter;
+                            }
+
                             if (white_list.size() > 0)
                             {
                                 white_list_filter.addChild(*listener);
@@ -192,10 +242,30 @@ int main(int argc, const char* argv[])
                             // Start controller
                             if (controller->start(*listener))
                             {
-                                cout << "Waiting for CAN messages, press [Enter] to stop..." << endl;
+                                if (arg_parser["database"])
+                                {
+                                    cout << "Waiting for CAN messages, type [r] + [Enter] to reload the database, press [Enter] to stop..." << endl;
+                                }
+                                else
+                                {
+                                    cout << "Waiting for CAN messages, press [Enter] to stop..." << endl;
+                                }
 
-                                // Wait for enter key
-                                getchar();
+                                // Wait for enter key, the database is reloaded while the CAN messages are being decoded
+                                string command;
+                                while (getline(cin, command) && (command == "r") && arg_parser["database"])
+                                {
+                                    shared_ptr<XmlFileCanMsgDatabase> new_database = make_shared<XmlFileCanMsgDatabase>();
+                                    if (new_database->load(database, lazy_database))
+                                    {
+                                        can_msg_decoder.reloadCanMsgDatabase(new_database);
+                                        cout << "Database reloaded" << endl;
+                                    }
+                                    else
+                                    {
+                                        cout << "Error : unable to reload database file => " << new_database->getLastError() << endl;
+                                    }
+                                }
 
                                 // Stop controller
                                 controller->stop();
@@ -37,6 +37,7 @@ CanClient::CanClient(TcpClient* tcp_client, const uint32_t timeout)
 , m_disconnected_callback()
 , m_msg_received_callback()
 , m_controller_started(false)
+, m_filters()
 {}
 
 /** \brief Destructor */
@@ -69,7 +70,10 @@ void CanClient::sendMsg(const CanMsg& can_msg)
     if (m_controller_started)
     {
         const lock_guard<mutex> guard(m_mutex);
-        m_serializer.write(can_msg);
+        if (CanAdapterFilter_Accept(m_filters.data(), static_cast<uint32_t>(m_filters.size()), &can_msg))
+        {
+            m_serializer.write(can_msg);
+        }
     }
 }
 
@@ -112,6 +116,27 @@ void CanClient::commThread()
                     break;
                 }
 
+                case TcpCanSerializer::CMD_FILTERS:
+                {
+                    // Acceptance filters
+                    uint16_t count = 0;
+                    ret = m_serializer.read(count);
+                    vector<CanAdapterFilter> filters(count);
+                    for (uint16_t i = 0; ret && (i < count); i++)
+                    {
+                        uint8_t flags = 0;
+                        ret = m_serializer.read(filters[i].id) && m_serializer.read(filters[i].mask) && m_serializer.read(flags);
+                        filters[i].extended = ((flags & TcpCanSerializer::FLAG_EXT) != 0);
+                    }
+                    if (ret)
+                    {
+                        const lock_guard<mutex> guard(m_mutex);
+                        m_filters = filters;
+                        m_serializer.write(cmd);
+                    }
+                    break;
+                }
+
                 case TcpCanSerializer::CMD_MSG:
                 {
                     // CAN message received
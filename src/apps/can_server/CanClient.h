@@ -23,11 +23,13 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "TcpClient.h"
 #include "CanData.h"
 #include "TcpCanSerializer.h"
+#include "CanAdapterControllerApi.h"
 #include "NoCopy.h"
 
 #include <mutex>
 #include <thread>
 #include <functional>
+#include <vector>
 
 /** \brief Client connected to the CAN server */
 class CanClient : public INoCopy
@@ -81,6 +83,9 @@ class CanClient : public INoCopy
         /** \brief Indicate if the client's CAN controller is started */
         bool m_controller_started;
 
+        /** \brief Acceptance filters of the client */
+        std::vector<CanAdapterFilter> m_filters;
+
 
 
         /** \brief Communication thread */
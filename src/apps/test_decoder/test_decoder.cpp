@@ -0,0 +1,1270 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ICanMsgDatabase.h"
+#include "CanMsgDesc.h"
+#include "CanMsgSignal.h"
+#include "IntegerCanMsgValue.h"
+#include "FloatCanMsgValue.h"
+#include "DecodedFrame.h"
+#include "CanMsgEncoder.h"
+#include "CanMsgBatchDecoder.h"
+#include "CanMsgDecoder.h"
+#include "CanMsgSignalChangeDetector.h"
+#include "CanMsgSignalHistory.h"
+#include "XmlFileCanMsgDatabase.h"
+#include "BinaryFileCanMsgDatabase.h"
+#include "SharedMemorySignalTable.h"
+#include "SharedMemorySignalTableReader.h"
+#include "SignalPredicateCanMsgFilter.h"
+#include "ChangeDetectCanMsgFilter.h"
+#include "LinearCanMsgValueConverter.h"
+
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <map>
+using namespace std;
+
+
+/** \brief Maximum number of failures displayed by a test */
+static const size_t MAX_DISPLAYED_FAILURES = 20u;
+
+/** \brief Number of random payloads checked for each value layout */
+static const size_t PAYLOADS_PER_LAYOUT = 16u;
+
+
+/** \brief Result of a test */
+class TestResult
+{
+    public:
+
+        /** \brief Constructor */
+        TestResult(const std::string& name)
+        : m_name(name)
+        , m_check_count(0u)
+        , m_failure_count(0u)
+        {}
+
+        /** \brief Record a check, the failure description is only built when the check fails */
+        void check(const bool success, const std::function<std::string()>& description)
+        {
+            m_check_count++;
+            if (!success)
+            {
+                if (m_failure_count < MAX_DISPLAYED_FAILURES)
+                {
+                    cout << "  FAILED : " << description() << endl;
+                }
+                m_failure_count++;
+            }
+        }
+
+        /** \brief Display the result, return true if all the checks succeeded */
+        bool report() const
+        {
+            cout << "[" << ((m_failure_count == 0) ? "PASSED" : "FAILED") << "] " << m_name << " : "
+                 << m_check_count << " checks, " << m_failure_count << " failures" << endl;
+            return (m_failure_count == 0);
+        }
+
+    private:
+
+        /** \brief Test name */
+        const std::string m_name;
+
+        /** \brief Number of checks */
+        uint64_t m_check_count;
+
+        /** \brief Number of failed checks */
+        uint64_t m_failure_count;
+};
+
+
+/** \brief CAN messages database built by the tests */
+class TestCanMsgDatabase : public ICanMsgDatabase
+{
+    public:
+
+        /** \brief Add a CAN message, the name index must be built afterwards */
+        void addCanMsg(const std::shared_ptr<CanMsgDesc>& can_msg) { m_can_msgs[can_msg->getId()] = can_msg; }
+
+        /** \brief Build the name index */
+        bool buildNameIndex() { return m_name_index.build(*this); }
+
+        /** \brief Get the list of CAN messages */
+        virtual const std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& getCanMsgs() const override { return m_can_msgs; }
+
+        /** \brief Get the index of the names of the CAN messages and signals */
+        virtual const CanMsgNameIndex& getNameIndex() const override { return m_name_index; }
+
+    private:
+
+        /** \brief List of CAN messages */
+        std::map<uint32_t, std::shared_ptr<CanMsgDesc>> m_can_msgs;
+
+        /** \brief Index of the names of the CAN messages and signals */
+        CanMsgNameIndex m_name_index;
+};
+
+
+/** \brief Layout of a value in the payload */
+struct ValueLayout
+{
+    /** \brief Byte order */
+    CanMsgByteOrder byte_order;
+    /** \brief Byte position (of the least significant bit in little endian, of the most significant bit in big endian) */
+    uint8_t byte_position;
+    /** \brief Bit position inside the byte */
+    uint8_t bit_position;
+    /** \brief Size in bits */
+    uint8_t size_in_bits;
+
+    /** \brief Description of the layout */
+    std::string toString() const
+    {
+        ostringstream str;
+        str << ((byte_order == CANMSG_BIG_ENDIAN) ? "big endian" : "little endian") << ", byte " << static_cast<uint32_t>(byte_position)
+            << ", bit " << static_cast<uint32_t>(bit_position) << ", size " << static_cast<uint32_t>(size_in_bits);
+        return str.str();
+    }
+};
+
+/** \brief Reference bit by bit model of a layout : positions of the value's bits in the payload from its least significant bit,
+           the position of the bit b of the byte n of the payload is (8 * n + b). Return false if the value doesn't fit in the payload */
+static bool getReferenceBits(const ValueLayout& layout, std::vector<uint8_t>& bits)
+{
+    bool ret = true;
+
+    bits.clear();
+    int byte_position = layout.byte_position;
+    int bit_position = layout.bit_position;
+    for (uint8_t i = 0; ret && (i < layout.size_in_bits); i++)
+    {
+        ret = (byte_position < static_cast<int>(CAN_MSG_MAX_LEN));
+        if (ret)
+        {
+            bits.push_back(static_cast<uint8_t>((byte_position * 8) + bit_position));
+        }
+        if (layout.byte_order == CANMSG_BIG_ENDIAN)
+        {
+            // From the most significant bit towards the least significant bit of the next bytes
+            if (bit_position == 0)
+            {
+                byte_position++;
+                bit_position = 7;
+            }
+            else
+            {
+                bit_position--;
+            }
+        }
+        else
+        {
+            // From the least significant bit towards the most significant bit of the next bytes
+            if (bit_position == 7)
+            {
+                byte_position++;
+                bit_position = 0;
+            }
+            else
+            {
+                bit_position++;
+            }
+        }
+    }
+    if (layout.byte_order == CANMSG_BIG_ENDIAN)
+    {
+        reverse(bits.begin(), bits.end());
+    }
+
+    return ret;
+}
+
+/** \brief Reference extraction of a value's raw bits from a payload */
+static uint64_t extractReference(const std::vector<uint8_t>& bits, const uint8_t* payload)
+{
+    uint64_t value = 0u;
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        value |= (static_cast<uint64_t>((payload[bits[i] / 8u] >> (bits[i] % 8u)) & 1u) << i);
+    }
+    return value;
+}
+
+/** \brief Reference insertion of a value's raw bits into a payload */
+static void insertReference(const std::vector<uint8_t>& bits, const uint64_t value, uint8_t* payload)
+{
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        const uint8_t bit_mask = static_cast<uint8_t>(1u << (bits[i] % 8u));
+        if (((value >> i) & 1u) != 0)
+        {
+            payload[bits[i] / 8u] |= bit_mask;
+        }
+        else
+        {
+            payload[bits[i] / 8u] &= static_cast<uint8_t>(~bit_mask);
+        }
+    }
+}
+
+/** \brief Reference mask of a value's bits inside the payload loaded as a little endian 64 bits word */
+static uint64_t getReferenceMask(const std::vector<uint8_t>& bits)
+{
+    uint64_t mask = 0u;
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        mask |= (1ull << bits[i]);
+    }
+    return mask;
+}
+
+/** \brief Reference raw value of an extracted value's bits */
+static uint64_t getReferenceRawValue(const CanMsgValueType type, const uint8_t size_in_bits, const uint64_t value_bits)
+{
+    uint64_t raw_value = value_bits;
+    if ((type == CANMSGVALUE_INT) && (size_in_bits < 64u) && (((value_bits >> (size_in_bits - 1u)) & 1u) != 0))
+    {
+        // Sign extension
+        raw_value |= (0xFFFFFFFFFFFFFFFFull << size_in_bits);
+    }
+    else if (type == CANMSGVALUE_FLOAT)
+    {
+        // The single precision value is stored in the low bits of the value
+        float float_value;
+        uint32_t float_bits = static_cast<uint32_t>(value_bits);
+        memcpy(&float_value, &float_bits, sizeof(float_value));
+        CanMsgValueData data;
+        data.uint_value = 0u;
+        data.float_value = float_value;
+        raw_value = data.uint_value;
+    }
+    return raw_value;
+}
+
+/** \brief Get the bits of a raw value to compare with the reference raw value */
+static uint64_t getRawValueBits(const CanMsgValueType type, const CanMsgValueData& value)
+{
+    uint64_t raw_value = value.uint_value;
+    if (type == CANMSGVALUE_FLOAT)
+    {
+        CanMsgValueData data;
+        data.uint_value = 0u;
+        data.float_value = value.float_value;
+        raw_value = data.uint_value;
+    }
+    return raw_value;
+}
+
+/** \brief Pseudo random generator */
+static uint64_t nextRandom(uint64_t& state)
+{
+    state ^= (state << 13u);
+    state ^= (state >> 7u);
+    state ^= (state << 17u);
+    return state;
+}
+
+/** \brief Create a value with a layout, return false if the value rejects the layout */
+static bool createValue(const CanMsgValueType type, const ValueLayout& layout, std::shared_ptr<ICanMsgValue>& value)
+{
+    bool ret;
+
+    // Same order as the databases : size, byte order then positions
+    if ((type == CANMSGVALUE_FLOAT) || (type == CANMSGVALUE_DOUBLE))
+    {
+        auto float_value = make_shared<FloatCanMsgValue>();
+        float_value->setPrecision(type == CANMSGVALUE_FLOAT);
+        ret = (float_value->getSizeInBits() == layout.size_in_bits);
+        value = float_value;
+    }
+    else
+    {
+        auto int_value = make_shared<IntegerCanMsgValue>();
+        int_value->setSignedness(type == CANMSGVALUE_INT);
+        ret = int_value->setSizeInBits(layout.size_in_bits);
+        value = int_value;
+    }
+    if (ret)
+    {
+        value->setByteOrder(layout.byte_order);
+        ret = (value->setBitPosition(layout.bit_position) && value->setBytePosition(layout.byte_position));
+    }
+
+    return ret;
+}
+
+/** \brief Check a value layout : validity, position and mask in the payload, extraction by the decoders and insertion by the encoder */
+static void checkValueLayout(const CanMsgValueType type, const ValueLayout& layout, uint64_t& random, TestResult& result)
+{
+    static const std::string signal_name = "Signal";
+    static const std::string signal_unit = "";
+
+    const auto description = [&] () { return (string(getCanMsgValueTypeName(type)) + " value, " + layout.toString()); };
+
+    // Validity
+    vector<uint8_t> bits;
+    const bool fits = getReferenceBits(layout, bits);
+    shared_ptr<ICanMsgValue> value;
+    const bool valid = createValue(type, layout, value);
+    result.check((valid == fits), [&] () { return (description() + " : " + (fits ? "rejected" : "accepted")); });
+    if (valid && fits)
+    {
+        // Position and mask in the payload
+        const uint8_t end_bit_position = ((layout.byte_order == CANMSG_BIG_ENDIAN) ?
+                                          static_cast<uint8_t>(56u - (layout.byte_position * 8u) + layout.bit_position) :
+                                          static_cast<uint8_t>((layout.byte_position * 8u) + layout.bit_position + layout.size_in_bits - 1u));
+        result.check(((value->getEndBitPosition() == end_bit_position) &&
+                      (value->getStartBitPosition() == (end_bit_position + 1u - layout.size_in_bits))),
+                     [&] () { return (description() + " : wrong start/end bit positions"); });
+        result.check((value->getPayloadMask() == getReferenceMask(bits)), [&] () { return (description() + " : wrong payload mask"); });
+
+        // CAN message with the value as single signal
+        auto can_msg_desc = make_shared<CanMsgDesc>(0x123u, "Message", false);
+        auto signal = make_shared<CanMsgSignal>();
+        signal->setName(signal_name);
+        signal->setUnit(signal_unit);
+        bool ret = (can_msg_desc->addValue(value) && signal->setValue(*value) && can_msg_desc->addSignal(signal));
+        result.check(ret, [&] () { return (description() + " : CAN message can't be built"); });
+        if (ret)
+        {
+            TestCanMsgDatabase database;
+            database.addCanMsg(can_msg_desc);
+            database.buildNameIndex();
+            CanMsgBatchDecoder batch_decoder(database);
+            CanMsgEncoder encoder(*can_msg_desc);
+            DecodedFrame decoded_frame;
+
+            vector<CanMsg> can_msgs(PAYLOADS_PER_LAYOUT);
+            vector<uint64_t> expected_values(PAYLOADS_PER_LAYOUT);
+            for (size_t i = 0; i < PAYLOADS_PER_LAYOUT; i++)
+            {
+                CanMsg& can_msg = can_msgs[i];
+                memset(&can_msg, 0, sizeof(can_msg));
+                can_msg.id = can_msg_desc->getId();
+                can_msg.size = CAN_MSG_MAX_LEN;
+
+                // Extraction : the first payloads test the extreme values
+                uint64_t payload = nextRandom(random);
+                if (i == 0)
+                {
+                    payload = 0u;
+                }
+                else if (i == 1u)
+                {
+                    payload = 0xFFFFFFFFFFFFFFFFull;
+                }
+                else if (i == 2u)
+                {
+                    payload = getReferenceMask(bits);
+                }
+                else if (i == 3u)
+                {
+                    payload = ~getReferenceMask(bits);
+                }
+                memcpy(can_msg.data, &payload, sizeof(payload));
+                const uint64_t expected_value = getReferenceRawValue(type, layout.size_in_bits, extractReference(bits, can_msg.data));
+                expected_values[i] = expected_value;
+                can_msg_desc->decode(can_msg, decoded_frame);
+                result.check((getRawValueBits(type, decoded_frame.getRawValue(0)) == expected_value),
+                             [&] () { return (description() + " : wrong decoded value"); });
+
+                // Insertion into a payload filled with other bits and extraction of the inserted value
+                CanMsg encoded_msg = can_msg;
+                uint8_t expected_payload[CAN_MSG_MAX_LEN];
+                const uint64_t inserted_bits = (nextRandom(random) & ((layout.size_in_bits >= 64u) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << layout.size_in_bits) - 1u)));
+                memcpy(expected_payload, can_msg.data, sizeof(expected_payload));
+                insertReference(bits, inserted_bits, expected_payload);
+                CanMsgValueData raw_value;
+                raw_value.uint_value = inserted_bits;
+                if (type == CANMSGVALUE_FLOAT)
+                {
+                    const uint64_t float_bits = getReferenceRawValue(type, layout.size_in_bits, inserted_bits);
+                    memcpy(&raw_value, &float_bits, sizeof(float_bits));
+                }
+                else if (type == CANMSGVALUE_INT)
+                {
+                    raw_value.uint_value = getReferenceRawValue(type, layout.size_in_bits, inserted_bits);
+                }
+                ret = encoder.setRawValue(encoded_msg, 0u, raw_value);
+                result.check((ret && (memcmp(encoded_msg.data, expected_payload, sizeof(expected_payload)) == 0)),
+                             [&] () { return (description() + " : wrong encoded payload"); });
+                can_msg_desc->decode(encoded_msg, decoded_frame);
+                result.check((getRawValueBits(type, decoded_frame.getRawValue(0)) == getReferenceRawValue(type, layout.size_in_bits, inserted_bits)),
+                             [&] () { return (description() + " : encoded value is not decoded back"); });
+            }
+
+            // Column-wise extraction
+            batch_decoder.decode(can_msgs.data(), can_msgs.size());
+            const CanMsgBatchDecoder::Column* column = batch_decoder.getColumn(signal_name);
+            ret = ((column != nullptr) && (column->raw_values.size() == PAYLOADS_PER_LAYOUT));
+            for (size_t i = 0; ret && (i < PAYLOADS_PER_LAYOUT); i++)
+            {
+                ret = (getRawValueBits(type, column->raw_values[i]) == expected_values[i]);
+            }
+            result.check(ret, [&] () { return (description() + " : wrong column values"); });
+        }
+    }
+}
+
+/** \brief Check all the byte orders, byte positions, bit positions and sizes of the values */
+static bool testValueLayouts()
+{
+    TestResult result("Byte order round trip");
+
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+    const CanMsgByteOrder byte_orders[] = { CANMSG_LITTLE_ENDIAN, CANMSG_BIG_ENDIAN };
+    for (const CanMsgByteOrder byte_order : byte_orders)
+    {
+        for (uint8_t size_in_bits = 1u; size_in_bits <= 64u; size_in_bits++)
+        {
+            for (uint8_t byte_position = 0; byte_position < CAN_MSG_MAX_LEN; byte_position++)
+            {
+                for (uint8_t bit_position = 0; bit_position < 8u; bit_position++)
+                {
+                    const ValueLayout layout = { byte_order, byte_position, bit_position, size_in_bits };
+                    checkValueLayout(CANMSGVALUE_UINT, layout, random, result);
+                    checkValueLayout(CANMSGVALUE_INT, layout, random, result);
+                    if (size_in_bits == 32u)
+                    {
+                        checkValueLayout(CANMSGVALUE_FLOAT, layout, random, result);
+                    }
+                    else if (size_in_bits == 64u)
+                    {
+                        checkValueLayout(CANMSGVALUE_DOUBLE, layout, random, result);
+                    }
+                }
+            }
+        }
+    }
+
+    return result.report();
+}
+
+/** \brief XML database used by the lazy database tests */
+static const char LAZY_DATABASE[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+    "<message_db version=\"1.0\">\n"
+    "    <signals>\n"
+    "        <signal id=\"button_pushed\" value=\"val0\" converter=\"\" unit=\"\" />\n"
+    "        <signal id=\"speed\" value=\"val1\" converter=\"\" unit=\"m/s\" />\n"
+    "        <signal id=\"state\" value=\"val2\" converter=\"\" unit=\"\" />\n"
+    "        <signal id=\"load\" value=\"val3\" converter=\"load_percent\" unit=\"%\" />\n"
+    "        <signal id=\"sensor\" value=\"val4\" converter=\"\" unit=\"\" />\n"
+    "        <signal id=\"temperature\" value=\"val5\" converter=\"\" unit=\"degC\" />\n"
+    "        <signal id=\"pressure\" value=\"val6\" converter=\"\" unit=\"mbar\" />\n"
+    "        <signal id=\"rpm\" value=\"val7\" converter=\"\" unit=\"rpm\" />\n"
+    "        <signal id=\"torque\" value=\"val8\" converter=\"\" unit=\"Nm\" />\n"
+    "    </signals>\n"
+    "    <converters>\n"
+    "        <converter id=\"load_percent\" type=\"linear_converter\">\n"
+    "            <linear factor=\"0.4\" offset=\"0\" min=\"0\" max=\"100\" />\n"
+    "        </converter>\n"
+    "    </converters>\n"
+    "    <messages>\n"
+    "        <message id=\"0x456\" name=\"message 1\" extended=\"false\">\n"
+    "            <values>\n"
+    "                <value id=\"val0\" type=\"bool\" byte_position=\"2\" bit_position=\"5\" />\n"
+    "                <value id=\"val1\" type=\"uint\" byte_position=\"0\" bit_position=\"0\" size_in_bits=\"16\" />\n"
+    "                <value id=\"val2\" type=\"int\" byte_position=\"2\" bit_position=\"0\" size_in_bits=\"5\" />\n"
+    "            </values>\n"
+    "        </message>\n"
+    "        <message id=\"0x123\" name=\"message 2\" extended=\"true\">\n"
+    "            <values>\n"
+    "                <value id=\"val3\" type=\"float\" byte_position=\"4\" bit_position=\"0\" />\n"
+    "            </values>\n"
+    "        </message>\n"
+    "        <message id=\"0x200\" name=\"message 3\" extended=\"false\">\n"
+    "            <values>\n"
+    "                <value id=\"val4\" type=\"uint\" byte_position=\"0\" bit_position=\"0\" size_in_bits=\"8\" multiplexer=\"true\" />\n"
+    "                <value id=\"val5\" type=\"int\" byte_position=\"1\" bit_position=\"0\" size_in_bits=\"16\" multiplexer_value=\"0\" />\n"
+    "                <value id=\"val6\" type=\"uint\" byte_position=\"1\" bit_position=\"0\" size_in_bits=\"16\" multiplexer_value=\"1\" />\n"
+    "            </values>\n"
+    "        </message>\n"
+    "        <message id=\"0x300\" name=\"message 4\" extended=\"false\">\n"
+    "            <values>\n"
+    "                <value id=\"val7\" type=\"uint\" byte_order=\"big_endian\" byte_position=\"0\" bit_position=\"7\" size_in_bits=\"16\" />\n"
+    "                <value id=\"val8\" type=\"int\" byte_order=\"big_endian\" byte_position=\"2\" bit_position=\"3\" size_in_bits=\"12\" />\n"
+    "            </values>\n"
+    "        </message>\n"
+    "    </messages>\n"
+    "</message_db>\n";
+
+/** \brief Names of the signals of the lazy database */
+static const char* const LAZY_DATABASE_SIGNALS[] = { "button_pushed", "speed", "state", "load", "sensor", "temperature", "pressure", "rpm", "torque" };
+
+/** \brief Number of signals of the lazy database */
+static const size_t LAZY_DATABASE_SIGNAL_COUNT = sizeof(LAZY_DATABASE_SIGNALS) / sizeof(LAZY_DATABASE_SIGNALS[0]);
+
+
+/** \brief Decoder listener which forwards the decoded messages to other listeners and counts the decoded signals */
+class DecoderListeners : public ICanMsgDecoderListener
+{
+    public:
+
+        /** \brief Constructor */
+        DecoderListeners()
+        : m_listeners()
+        , m_signal_count(0u)
+        {}
+
+        /** \brief Add a listener */
+        void add(ICanMsgDecoderListener& listener) { m_listeners.push_back(&listener); }
+
+        /** \brief Called when message has been decoded, the decoded frame is only valid during the call */
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) override
+        {
+            m_signal_count += decoded_frame.getDecodedSignals().size();
+            for (size_t i = 0; i < m_listeners.size(); i++)
+            {
+                m_listeners[i]->canMsgDecoded(can_msg, decoded_frame);
+            }
+        }
+
+        /** \brief Listeners */
+        std::vector<ICanMsgDecoderListener*> m_listeners;
+
+        /** \brief Number of decoded signals */
+        size_t m_signal_count;
+};
+
+/** \brief Signal change listener which records the names of the changed signals */
+class ChangedSignals : public ICanMsgSignalChangeListener
+{
+    public:
+
+        /** \brief Called when the converted value of a signal has changed, the values are only valid during the call */
+        virtual void signalChanged(const CanMsg& can_msg, const CanMsgSignal& signal, const CanMsgValueData& converted_value, const CanMsgValueData& raw_value) override
+        {
+            (void)can_msg;
+            (void)converted_value;
+            (void)raw_value;
+            m_names.insert(signal.getName());
+        }
+
+        /** \brief Names of the changed signals */
+        std::set<std::string> m_names;
+};
+
+/** \brief Build CAN messages for all the CAN messages of the lazy database, including both multiplexer values */
+static void buildLazyDatabaseMsgs(std::vector<CanData>& frames)
+{
+    const uint32_t ids[] = { 0x456u, 0x123u, 0x200u, 0x300u };
+    const bool extended[] = { false, true, false, false };
+    uint64_t random = 0x0123456789ABCDEFull;
+    frames.clear();
+    for (size_t i = 0; i < 32u; i++)
+    {
+        CanData can_data;
+        memset(&can_data, 0, sizeof(can_data));
+        can_data.header.type = CAN_DATA_RX_MSG;
+        can_data.header.timestamp_sec = static_cast<int64_t>(i);
+        can_data.msg.id = ids[i % 4u];
+        can_data.msg.extended = extended[i % 4u];
+        can_data.msg.size = CAN_MSG_MAX_LEN;
+        const uint64_t payload = nextRandom(random);
+        memcpy(can_data.msg.data, &payload, sizeof(payload));
+        if (can_data.msg.id == 0x200u)
+        {
+            can_data.msg.data[0] = static_cast<uint8_t>((i / 4u) % 2u);
+        }
+        frames.push_back(can_data);
+    }
+}
+
+/** \brief Write the lazy database file and load it in lazy mode */
+static bool loadLazyDatabase(const std::string& xml_file, XmlFileCanMsgDatabase& database)
+{
+    bool ret = false;
+    {
+        ofstream file(xml_file, ios::binary);
+        file << LAZY_DATABASE;
+        ret = file.good();
+    }
+    if (ret)
+    {
+        ret = database.load(xml_file, true);
+        if (!ret)
+        {
+            cout << "  Unable to load the lazy database => " << database.getLastError() << endl;
+        }
+    }
+    return ret;
+}
+
+/** \brief Check the users of a database which builds its CAN messages on demand : decoder, signal change detector,
+           signal history, shared memory signal table, batch decoder and binary image */
+static bool testLazyDatabase()
+{
+    TestResult result("Lazy database users");
+
+    const string xml_file = "test_decoder_lazy.xml";
+    XmlFileCanMsgDatabase database;
+    bool ret = loadLazyDatabase(xml_file, database);
+    result.check(ret, [] () { return string("lazy database can't be loaded"); });
+    if (ret)
+    {
+        result.check(database.isLazy(), [] () { return string("database is not lazy"); });
+        result.check(database.getCanMsgs().empty(), [] () { return string("CAN messages listed before being built"); });
+
+        // Users attached before any CAN message is built
+        CanMsgSignalChangeDetector detector(database);
+        ChangedSignals changed_signals;
+        detector.setListener(changed_signals);
+        CanMsgSignalHistory history(database, 64u);
+        SharedMemorySignalTable table;
+        const string table_name = "test_decoder_lazy_table";
+        const bool table_created = table.create(table_name, database);
+        result.check(table_created, [] () { return string("shared memory signal table can't be created"); });
+        CanMsgBatchDecoder batch_decoder(database);
+
+        DecoderListeners listeners;
+        listeners.add(detector);
+        listeners.add(table);
+        CanMsgDecoder decoder;
+        decoder.setCanMsgDatabase(database);
+        decoder.setListener(listeners);
+        decoder.setSignalHistory(&history);
+
+        vector<CanData> frames;
+        buildLazyDatabaseMsgs(frames);
+        vector<CanMsg> can_msgs;
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            decoder.canDataReceived(frames[i]);
+            can_msgs.push_back(frames[i].msg);
+        }
+        result.check((decoder.getDecodeCount() == frames.size()), [] () { return string("CAN messages not decoded"); });
+        result.check(database.getCanMsgs().empty(), [] () { return string("CAN messages built on demand are listed"); });
+
+        // Building a CAN message on demand keeps the last decodings of the other CAN messages
+        CanMsgDecoder warmup_decoder;
+        warmup_decoder.setCanMsgDatabase(database);
+        warmup_decoder.canDataReceived(frames[0]);
+        warmup_decoder.canDataReceived(frames[1]);
+        warmup_decoder.canDataReceived(frames[0]);
+        result.check((warmup_decoder.getCacheHitCount() == 1u), [] () { return string("last decodings flushed by a CAN message built on demand"); });
+
+        // Signal change detector
+        for (size_t i = 0; i < LAZY_DATABASE_SIGNAL_COUNT; i++)
+        {
+            const string name = LAZY_DATABASE_SIGNALS[i];
+            result.check((changed_signals.m_names.count(name) != 0), [&] () { return ("signal change detector : no change for " + name); });
+        }
+
+        // Signal history
+        size_t sample_count = 0;
+        for (size_t signal_id = 0; signal_id < LAZY_DATABASE_SIGNAL_COUNT; signal_id++)
+        {
+            CanMsgSignalHistory::Sample samples[64u];
+            sample_count += history.getLast(signal_id, 64u, samples);
+        }
+        result.check((sample_count == listeners.m_signal_count), [&] () { return ("signal history : " + to_string(sample_count) + " samples instead of " + to_string(listeners.m_signal_count)); });
+
+        // Shared memory signal table
+        if (table_created)
+        {
+            SharedMemorySignalTableReader reader;
+            ret = reader.open(table_name);
+            result.check(ret, [] () { return string("shared memory signal table can't be opened"); });
+            if (ret)
+            {
+                result.check((reader.getSignalCount() == LAZY_DATABASE_SIGNAL_COUNT), [] () { return string("shared memory signal table : wrong signal count"); });
+                for (size_t i = 0; i < LAZY_DATABASE_SIGNAL_COUNT; i++)
+                {
+                    const string name = LAZY_DATABASE_SIGNALS[i];
+                    size_t signal_id = 0;
+                    SharedMemorySignalTableReader::Sample sample;
+                    result.check((reader.findSignal(name, signal_id) && reader.read(signal_id, sample)),
+                                 [&] () { return ("shared memory signal table : no value for " + name); });
+                }
+                reader.close();
+            }
+            table.close();
+        }
+
+        // Batch decoder
+        batch_decoder.decode(can_msgs.data(), can_msgs.size());
+        size_t value_count = 0;
+        const vector<CanMsgBatchDecoder::Column>& columns = batch_decoder.getColumns();
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            value_count += columns[i].raw_values.size();
+        }
+        result.check(((columns.size() == LAZY_DATABASE_SIGNAL_COUNT) && (value_count == listeners.m_signal_count)),
+                     [&] () { return ("batch decoder : " + to_string(value_count) + " values instead of " + to_string(listeners.m_signal_count)); });
+
+        // Signals looked up by name, the database doesn't index the names of the CAN messages it builds on demand
+        result.check(detector.setDeadband("speed", 0., 0.), [] () { return string("signal change detector : signal not found by name"); });
+        size_t speed_id = 0;
+        CanMsgSignalHistory::Sample speed_samples[64u];
+        result.check((history.findSignal("speed", speed_id) && (history.getLast(speed_id, 64u, speed_samples) == (frames.size() / 4u))),
+                     [] () { return string("signal history : signal not found by name"); });
+        const CanMsgBatchDecoder::Column* rpm_column = batch_decoder.getColumn("rpm");
+        result.check(((rpm_column != nullptr) && (rpm_column->signal->getName() == "rpm") && (rpm_column->raw_values.size() == (frames.size() / 4u))),
+                     [] () { return string("batch decoder : column not found by name"); });
+        SignalPredicateCanMsgFilter filter(database);
+        result.check(filter.add("torque", SignalPredicateCanMsgFilter::OP_GREATER, 0.), [] () { return string("signal predicate filter : signal not found by name"); });
+        result.check(!filter.add("unknown", SignalPredicateCanMsgFilter::OP_GREATER, 0.), [] () { return string("signal predicate filter : unknown signal found by name"); });
+
+        // Binary image
+        BinaryFileCanMsgDatabase bin_database;
+        result.check(!bin_database.save(database, "test_decoder_lazy.bin", 0u), [] () { return string("lazy database saved as an incomplete binary image"); });
+    }
+    remove(xml_file.c_str());
+
+    return result.report();
+}
+
+/** \brief Check the concurrent building of the CAN messages of a database shared by several decoders */
+static bool testLazyDatabaseSharing()
+{
+    TestResult result("Lazy database sharing");
+
+    const string xml_file = "test_decoder_shared.xml";
+    XmlFileCanMsgDatabase database;
+    bool ret = loadLazyDatabase(xml_file, database);
+    result.check(ret, [] () { return string("lazy database can't be loaded"); });
+    if (ret)
+    {
+        vector<CanData> frames;
+        buildLazyDatabaseMsgs(frames);
+
+        // Decoders sharing the database decode in parallel while the CAN messages are listed
+        const size_t iterations = 1000u;
+        CanMsgDecoder decoders[2u];
+        DecoderListeners listeners[2u];
+        vector<thread> threads;
+        for (size_t i = 0; i < 2u; i++)
+        {
+            decoders[i].setCanMsgDatabase(database);
+            decoders[i].setListener(listeners[i]);
+            threads.emplace_back([&frames, &decoders, i, iterations] ()
+            {
+                for (size_t iteration = 0; iteration < iterations; iteration++)
+                {
+                    for (size_t j = 0; j < frames.size(); j++)
+                    {
+                        decoders[i].canDataReceived(frames[j]);
+                    }
+                }
+            });
+        }
+        CanMsgDescIndex can_msg_index;
+        can_msg_index.build(database);
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+
+        result.check((can_msg_index.size() == 4u), [] () { return string("CAN messages not all listed"); });
+        for (size_t i = 0; i < 2u; i++)
+        {
+            result.check(((decoders[i].getDecodeCount() == (iterations * frames.size())) && (listeners[i].m_signal_count == listeners[0].m_signal_count)),
+                         [&] () { return ("decoder " + to_string(i) + " : CAN messages not decoded"); });
+        }
+        result.check(database.getCanMsgs().empty(), [] () { return string("CAN messages built on demand are listed"); });
+    }
+    remove(xml_file.c_str());
+
+    return result.report();
+}
+
+/** \brief Decoder listener which counts the decoded signals of each CAN message */
+class DecodedSignalCounter : public ICanMsgDecoderListener
+{
+    public:
+
+        /** \brief Called when message has been decoded, the decoded frame is only valid during the call */
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) override
+        {
+            m_counts[can_msg.id] += decoded_frame.getDecodedSignals().size();
+        }
+
+        /** \brief Number of decoded signals by CAN message id */
+        std::map<uint32_t, size_t> m_counts;
+};
+
+/** \brief Names of the signals of each CAN message of the shared names database, the signals only keep a reference to their name */
+static const string SHARED_SIGNAL_NAMES[] = { "value", "other" };
+
+/** \brief Create a database with CAN messages sharing the names of their signals */
+static bool createSharedNamesDatabase(TestCanMsgDatabase& database)
+{
+    bool ret = true;
+    for (uint32_t id = 0x100u; ret && (id <= 0x102u); id++)
+    {
+        auto can_msg_desc = make_shared<CanMsgDesc>(id, "Message " + to_string(id), false);
+        for (uint8_t i = 0; ret && (i < 2u); i++)
+        {
+            shared_ptr<ICanMsgValue> value;
+            auto signal = make_shared<CanMsgSignal>();
+            signal->setName(SHARED_SIGNAL_NAMES[i]);
+            ret = (createValue(CANMSGVALUE_UINT, { CANMSG_LITTLE_ENDIAN, i, 0u, 8u }, value) && can_msg_desc->addValue(value) &&
+                   signal->setValue(*value) && can_msg_desc->addSignal(signal));
+        }
+        database.addCanMsg(can_msg_desc);
+    }
+    return (ret && database.buildNameIndex());
+}
+
+/** \brief Decode a CAN message of each id of the shared names database and count the decoded signals by id */
+static std::map<uint32_t, size_t> decodeSharedNamesMsgs(CanMsgDecoder& decoder, DecodedSignalCounter& counter)
+{
+    counter.m_counts.clear();
+    for (uint32_t id = 0x100u; id <= 0x102u; id++)
+    {
+        CanData can_data;
+        memset(&can_data, 0, sizeof(can_data));
+        can_data.header.type = CAN_DATA_RX_MSG;
+        can_data.msg.id = id;
+        can_data.msg.size = CAN_MSG_MAX_LEN;
+        can_data.msg.data[0] = static_cast<uint8_t>(id);
+        decoder.canDataReceived(can_data);
+    }
+    return counter.m_counts;
+}
+
+/** \brief Check the subscriptions by handle : only the signal of the handle is subscribed, also after a database reload */
+static bool testHandleSubscriptions()
+{
+    TestResult result("Handle subscriptions");
+
+    TestCanMsgDatabase database;
+    bool ret = createSharedNamesDatabase(database);
+    result.check(ret, [] () { return string("database can't be created"); });
+    if (ret)
+    {
+        CanMsgDecoder decoder;
+        DecodedSignalCounter counter;
+        decoder.setCanMsgDatabase(database);
+        decoder.setListener(counter);
+
+        // The handles of the signals named "value" in the order of the messages
+        const CanMsgNameIndex& name_index = database.getNameIndex();
+        vector<CanMsgNameIndex::handle_t> handles;
+        for (CanMsgNameIndex::handle_t handle = name_index.findSignal("value"); handle != CanMsgNameIndex::INVALID_HANDLE; handle = name_index.getSignal(handle).next)
+        {
+            handles.push_back(handle);
+        }
+        result.check((handles.size() == 3u), [] () { return string("signals sharing their name not found"); });
+        if (handles.size() == 3u)
+        {
+            const map<uint32_t, size_t> first_only = { { 0x100u, 1u } };
+            const map<uint32_t, size_t> all_but_first = { { 0x101u, 1u }, { 0x102u, 1u } };
+            const map<uint32_t, size_t> last_only = { { 0x102u, 1u } };
+
+            result.check(decoder.subscribe(handles[0]), [] () { return string("subscribe by handle failed"); });
+            result.check((decodeSharedNamesMsgs(decoder, counter) == first_only), [] () { return string("subscribe by handle : other signals sharing the name subscribed"); });
+            result.check(!decoder.unsubscribe(handles[1]), [] () { return string("unsubscribe by handle of a signal which is not subscribed"); });
+
+            // A signal subscribed by name and unsubscribed by handle : the other signals sharing the name stay subscribed
+            result.check(decoder.subscribe("value"), [] () { return string("subscribe by name failed"); });
+            result.check(decoder.unsubscribe(handles[0]), [] () { return string("unsubscribe by handle failed"); });
+            result.check((decodeSharedNamesMsgs(decoder, counter) == all_but_first), [] () { return string("unsubscribe by handle : other signals sharing the name unsubscribed"); });
+
+            // The signals subscribed by handle stay subscribed after a reload
+            result.check(decoder.unsubscribe(handles[1]), [] () { return string("unsubscribe by handle failed"); });
+            auto reloaded_database = make_shared<TestCanMsgDatabase>();
+            result.check(createSharedNamesDatabase(*reloaded_database), [] () { return string("database can't be created"); });
+            decoder.reloadCanMsgDatabase(reloaded_database);
+            result.check((decodeSharedNamesMsgs(decoder, counter) == last_only), [] () { return string("reload : subscriptions by handle not kept"); });
+
+            // Subscribing by name covers the signals subscribed by handle
+            result.check(decoder.subscribe("value") && decoder.unsubscribe("value"), [] () { return string("subscribe and unsubscribe by name failed"); });
+            result.check((decodeSharedNamesMsgs(decoder, counter).size() == 3u), [] () { return string("unsubscribe by name : signals still subscribed"); });
+        }
+    }
+
+    return result.report();
+}
+
+/** \brief Pipeline stage which counts the CAN data forwarded by its parent */
+class ForwardedCanDataCounter : public CanPipelineStageBase
+{
+    public:
+
+        /** \brief Constructor */
+        ForwardedCanDataCounter()
+        : CanPipelineStageBase(false)
+        , m_count(0u)
+        {}
+
+        /** \brief Number of forwarded CAN data */
+        size_t m_count;
+
+    protected:
+
+        /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
+        virtual bool processCanData(const CanData& can_data) override
+        {
+            (void)can_data;
+            m_count++;
+            return false;
+        }
+};
+
+/** \brief Names of the signals of the scaled signals database */
+static const string SCALED_SIGNAL_NAMES[] = { "speed", "temperature", "level", "constant" };
+
+/** \brief Check the predicates on the converted values of scaled signals */
+static bool testScaledPredicates()
+{
+    TestResult result("Scaled signal predicates");
+
+    // Speed : raw * 0.1, temperature : raw * 0.5 - 40 (signed), level : raw * -2 + 100, constant : raw * 0
+    const double factors[] = { 0.1, 0.5, -2., 0. };
+    const double offsets[] = { 0., -40., 100., 0. };
+    const ValueLayout layouts[] = { { CANMSG_LITTLE_ENDIAN, 0u, 0u, 16u }, { CANMSG_LITTLE_ENDIAN, 2u, 0u, 8u },
+                                    { CANMSG_LITTLE_ENDIAN, 3u, 0u, 8u }, { CANMSG_LITTLE_ENDIAN, 4u, 0u, 8u } };
+    vector<shared_ptr<LinearCanMsgValueConverter>> converters;
+    TestCanMsgDatabase database;
+    auto can_msg_desc = make_shared<CanMsgDesc>(0x200u, "Scaled", false);
+    bool ret = true;
+    for (size_t i = 0; ret && (i < 4u); i++)
+    {
+        shared_ptr<ICanMsgValue> value;
+        auto signal = make_shared<CanMsgSignal>();
+        auto converter = make_shared<LinearCanMsgValueConverter>(SCALED_SIGNAL_NAMES[i], "linear");
+        converter->setCoefficients(factors[i], offsets[i]);
+        converters.push_back(converter);
+        signal->setName(SCALED_SIGNAL_NAMES[i]);
+        ret = (createValue(((i == 1u) ? CANMSGVALUE_INT : CANMSGVALUE_UINT), layouts[i], value) && can_msg_desc->addValue(value) &&
+               signal->setValue(*value) && signal->setConverter(*converter) && can_msg_desc->addSignal(signal));
+    }
+    database.addCanMsg(can_msg_desc);
+    ret = (ret && database.buildNameIndex());
+    result.check(ret, [] () { return string("database can't be created"); });
+    if (ret)
+    {
+        SignalPredicateCanMsgFilter filter(database);
+        ForwardedCanDataCounter counter;
+        filter.addChild(counter);
+
+        // Forward a CAN message with raw values to the filter, return true if it has been forwarded
+        auto isForwarded = [&] (const uint16_t speed, const int8_t temperature, const uint8_t level)
+        {
+            CanData can_data;
+            memset(&can_data, 0, sizeof(can_data));
+            can_data.header.type = CAN_DATA_RX_MSG;
+            can_data.msg.id = 0x200u;
+            can_data.msg.size = CAN_MSG_MAX_LEN;
+            can_data.msg.data[0] = static_cast<uint8_t>(speed & 0xFFu);
+            can_data.msg.data[1] = static_cast<uint8_t>(speed >> 8u);
+            can_data.msg.data[2] = static_cast<uint8_t>(temperature);
+            can_data.msg.data[3] = level;
+            const size_t count = counter.m_count;
+            filter.canDataReceived(can_data);
+            return (counter.m_count != count);
+        };
+
+        // Reference values in physical units
+        result.check(filter.add("speed", SignalPredicateCanMsgFilter::OP_GREATER, 120.), [] () { return string("speed > 120 rejected"); });
+        result.check((!isForwarded(1200u, 0, 0u) && isForwarded(1201u, 0, 0u)), [] () { return string("speed > 120 : wrong raw threshold"); });
+        filter.clear();
+        result.check(filter.add("speed", SignalPredicateCanMsgFilter::OP_EQUAL, 120.5), [] () { return string("speed == 120.5 rejected"); });
+        result.check((isForwarded(1205u, 0, 0u) && !isForwarded(1204u, 0, 0u) && !isForwarded(1206u, 0, 0u)), [] () { return string("speed == 120.5 : wrong raw threshold"); });
+        filter.clear();
+        result.check(filter.add("temperature", SignalPredicateCanMsgFilter::OP_GREATER_OR_EQUAL, -20.), [] () { return string("temperature >= -20 rejected"); });
+        result.check((!isForwarded(0u, 39, 0u) && isForwarded(0u, 40, 0u) && !isForwarded(0u, -100, 0u)), [] () { return string("temperature >= -20 : wrong raw threshold"); });
+
+        // A negative factor reverses the comparison in the raw domain
+        filter.clear();
+        result.check(filter.add("level", SignalPredicateCanMsgFilter::OP_LOWER, 50.), [] () { return string("level < 50 rejected"); });
+        result.check((!isForwarded(0u, 0, 25u) && isForwarded(0u, 0, 26u) && !isForwarded(0u, 0, 0u)), [] () { return string("level < 50 : comparison not reversed"); });
+
+        // A converter which can't be inverted
+        filter.clear();
+        result.check(!filter.add("constant", SignalPredicateCanMsgFilter::OP_EQUAL, 0.), [] () { return string("predicate accepted on a converter which can't be inverted"); });
+        result.check(isForwarded(0u, 0, 0u), [] () { return string("CAN message without predicates not forwarded"); });
+    }
+
+    return result.report();
+}
+/** \brief Check the change detection filter : masks, heartbeat and reset, also while CAN messages are being processed */
+static bool testChangeDetection()
+{
+    TestResult result("Change detection");
+
+    ChangeDetectCanMsgFilter filter;
+    ForwardedCanDataCounter counter;
+    filter.addChild(counter);
+
+    // Forward a CAN message to the filter, return true if it has been forwarded
+    auto isForwarded = [&] (const uint32_t id, const uint8_t data, const int64_t timestamp_ms)
+    {
+        CanData can_data;
+        memset(&can_data, 0, sizeof(can_data));
+        can_data.header.type = CAN_DATA_RX_MSG;
+        can_data.header.timestamp_sec = (timestamp_ms / 1000);
+        can_data.header.timestamp_nsec = ((timestamp_ms % 1000) * 1000000);
+        can_data.msg.id = id;
+        can_data.msg.size = 1u;
+        can_data.msg.data[0] = data;
+        const size_t count = counter.m_count;
+        filter.canDataReceived(can_data);
+        return (counter.m_count != count);
+    };
+
+    result.check((isForwarded(0x100u, 0x01u, 0) && !isForwarded(0x100u, 0x01u, 1) && isForwarded(0x100u, 0x02u, 2)),
+                 [] () { return string("payload changes not detected"); });
+
+    // A new mask forwards the next message, then only the masked bits are compared
+    filter.setMask(0x100u, false, 0x0Full);
+    result.check((isForwarded(0x100u, 0x02u, 3) && !isForwarded(0x100u, 0x12u, 4) && isForwarded(0x100u, 0x13u, 5)),
+                 [] () { return string("mask not applied"); });
+    filter.removeMask(0x100u, false);
+    result.check((isForwarded(0x100u, 0x13u, 6) && isForwarded(0x100u, 0x23u, 7)), [] () { return string("mask not removed"); });
+
+    // Heartbeat and reset
+    filter.setHeartbeat(100u);
+    result.check((!isForwarded(0x100u, 0x23u, 100) && isForwarded(0x100u, 0x23u, 107)), [] () { return string("heartbeat not applied"); });
+    filter.setHeartbeat(0u);
+    result.check(!isForwarded(0x100u, 0x23u, 1000), [] () { return string("heartbeat not removed"); });
+    filter.reset();
+    result.check((isForwarded(0x100u, 0x23u, 1001) && !isForwarded(0x100u, 0x23u, 1002)), [] () { return string("reset not applied"); });
+
+    // Rules modified while CAN messages are being processed
+    atomic<bool> stop(false);
+    thread rx_thread([&] ()
+    {
+        for (uint32_t i = 0; !stop.load(); i++)
+        {
+            isForwarded((0x200u + (i % 64u)), static_cast<uint8_t>(i / 64u), static_cast<int64_t>(i));
+        }
+    });
+    for (uint32_t i = 0; i < 10000u; i++)
+    {
+        filter.setMask((0x200u + (i % 64u)), false, (i & 0xFFu));
+        filter.removeMask((0x200u + ((i + 32u) % 64u)), false);
+        if ((i % 100u) == 0u)
+        {
+            filter.reset();
+            filter.setHeartbeat(i % 7u);
+        }
+    }
+    stop = true;
+    rx_thread.join();
+    result.check((counter.m_count != 0u), [] () { return string("no CAN message forwarded while the rules were modified"); });
+
+    return result.report();
+}
+
+
+/** \brief Names of the signals of the encoder round trip message */
+static const string ROUND_TRIP_SIGNAL_NAMES[] = { "mode", "speed", "temperature", "pressure" };
+
+/** \brief Check the range of the raw values accepted by the encoder : the values which fit in the size and signedness
+           of a signal are encoded and decoded back, the other ones are rejected without modifying the payload */
+static bool testEncoderRanges()
+{
+    TestResult result("Encoder value ranges");
+
+    const CanMsgValueType types[] = { CANMSGVALUE_UINT, CANMSGVALUE_INT };
+    for (size_t type_index = 0; type_index < 2u; type_index++)
+    {
+        const CanMsgValueType type = types[type_index];
+        for (uint8_t size_in_bits = 1u; size_in_bits <= 64u; size_in_bits++)
+        {
+            const ValueLayout layout = { CANMSG_LITTLE_ENDIAN, 0u, 0u, size_in_bits };
+            auto description = [&] () { return (string((type == CANMSGVALUE_INT) ? "int" : "uint") + ", size " + to_string(size_in_bits)); };
+
+            shared_ptr<ICanMsgValue> value;
+            auto can_msg_desc = make_shared<CanMsgDesc>(0x123u, "Message", false);
+            auto signal = make_shared<CanMsgSignal>();
+            signal->setName(ROUND_TRIP_SIGNAL_NAMES[0]);
+            bool ret = (createValue(type, layout, value) && can_msg_desc->addValue(value) && signal->setValue(*value) && can_msg_desc->addSignal(signal));
+            result.check(ret, [&] () { return (description() + " : CAN message can't be built"); });
+            if (ret)
+            {
+                // Bounds of the values which fit in the signal and nearest values which don't fit
+                vector<int64_t> valid_values;
+                vector<int64_t> invalid_values;
+                if (type == CANMSGVALUE_INT)
+                {
+                    const int64_t max_value = static_cast<int64_t>((1ull << (size_in_bits - 1u)) - 1u);
+                    const int64_t min_value = (-max_value - 1);
+                    valid_values = { min_value, -1, 0, max_value };
+                    if (size_in_bits < 64u)
+                    {
+                        invalid_values = { (min_value - 1), (max_value + 1) };
+                    }
+                }
+                else
+                {
+                    const uint64_t max_value = ((size_in_bits < 64u) ? ((1ull << size_in_bits) - 1u) : 0xFFFFFFFFFFFFFFFFull);
+                    valid_values = { 0, static_cast<int64_t>(max_value) };
+                    if (size_in_bits < 64u)
+                    {
+                        invalid_values = { static_cast<int64_t>(max_value + 1u), -1 };
+                    }
+                }
+
+                CanMsgEncoder encoder(*can_msg_desc);
+                DecodedFrame decoded_frame;
+                for (size_t i = 0; i < valid_values.size(); i++)
+                {
+                    CanMsg can_msg;
+                    CanMsgValueData raw_value;
+                    raw_value.int_value = valid_values[i];
+                    encoder.init(can_msg);
+                    ret = encoder.setRawValue(can_msg, 0u, raw_value);
+                    result.check(ret, [&] () { return (description() + " : value " + to_string(valid_values[i]) + " rejected"); });
+                    if (ret)
+                    {
+                        can_msg_desc->decode(can_msg, decoded_frame);
+                        result.check((decoded_frame.getRawValue(0u).int_value == valid_values[i]),
+                                     [&] () { return (description() + " : value " + to_string(valid_values[i]) + " decoded as " + to_string(decoded_frame.getRawValue(0u).int_value)); });
+                    }
+                }
+                for (size_t i = 0; i < invalid_values.size(); i++)
+                {
+                    CanMsg can_msg;
+                    CanMsgValueData raw_value;
+                    raw_value.int_value = invalid_values[i];
+                    encoder.init(can_msg);
+                    CanMsgExtractionPlan::storePayload(0x5A5A5A5A5A5A5A5Aull, can_msg);
+                    result.check((!encoder.setRawValue(can_msg, 0u, raw_value) && (CanMsgExtractionPlan::loadPayload(can_msg) == 0x5A5A5A5A5A5A5A5Aull)),
+                                 [&] () { return (description() + " : value " + to_string(invalid_values[i]) + " truncated"); });
+                }
+            }
+        }
+    }
+
+    return result.report();
+}
+
+/** \brief Check the encoding of converted values through the converters of the signals, including multiplexed signals,
+           and the decoding of the encoded CAN messages */
+static bool testEncoderRoundTrip()
+{
+    TestResult result("Encoder round trip");
+
+    // Mode : multiplexer, speed : raw * 0.1, temperature (mode 1) : raw * 0.5 - 40 (signed), pressure (mode 2) : raw * 2
+    const CanMsgValueType types[] = { CANMSGVALUE_UINT, CANMSGVALUE_UINT, CANMSGVALUE_INT, CANMSGVALUE_UINT };
+    const ValueLayout layouts[] = { { CANMSG_LITTLE_ENDIAN, 0u, 0u, 8u }, { CANMSG_BIG_ENDIAN, 1u, 7u, 16u },
+                                    { CANMSG_LITTLE_ENDIAN, 3u, 0u, 8u }, { CANMSG_LITTLE_ENDIAN, 3u, 0u, 12u } };
+    const double factors[] = { 1., 0.1, 0.5, 2. };
+    const double offsets[] = { 0., 0., -40., 0. };
+    vector<shared_ptr<LinearCanMsgValueConverter>> converters;
+    auto can_msg_desc = make_shared<CanMsgDesc>(0x300u, "Round trip", false);
+    bool ret = true;
+    for (size_t i = 0; ret && (i < 4u); i++)
+    {
+        shared_ptr<ICanMsgValue> value;
+        auto signal = make_shared<CanMsgSignal>();
+        auto converter = make_shared<LinearCanMsgValueConverter>(ROUND_TRIP_SIGNAL_NAMES[i], "linear");
+        converter->setCoefficients(factors[i], offsets[i]);
+        converters.push_back(converter);
+        signal->setName(ROUND_TRIP_SIGNAL_NAMES[i]);
+        ret = createValue(types[i], layouts[i], value);
+        if (ret)
+        {
+            switch (i)
+            {
+                case 0u: ret = can_msg_desc->addMultiplexerValue(value); break;
+                case 2u: ret = can_msg_desc->addMultiplexedValue(value, 1u); break;
+                case 3u: ret = can_msg_desc->addMultiplexedValue(value, 2u); break;
+                default: ret = can_msg_desc->addValue(value); break;
+            }
+        }
+        ret = (ret && signal->setValue(*value) && signal->setConverter(*converter) && can_msg_desc->addSignal(signal));
+    }
+    result.check(ret, [] () { return string("CAN message can't be built"); });
+    if (ret)
+    {
+        CanMsgEncoder encoder(*can_msg_desc);
+        DecodedFrame decoded_frame;
+
+        // Encode the signals of each multiplexer value then decode them back
+        struct Encoding
+        {
+            size_t signal_indexes[2u];
+            double values[2u];
+            uint64_t mode;
+        };
+        const Encoding encodings[] = { { { 1u, 2u }, { 123.4, -12.5 }, 1u }, { { 1u, 3u }, { 6553.5, 8190. }, 2u }, { { 2u, 1u }, { 23.5, 0. }, 1u } };
+        for (size_t i = 0; i < (sizeof(encodings) / sizeof(encodings[0])); i++)
+        {
+            const Encoding& encoding = encodings[i];
+            CanMsgValueData values[2u];
+            values[0].double_value = encoding.values[0];
+            values[1].double_value = encoding.values[1];
+            CanMsg can_msg;
+            ret = encoder.encode(encoding.signal_indexes, values, 2u, can_msg);
+            result.check(ret, [&] () { return ("encoding " + to_string(i) + " : values rejected"); });
+            if (ret)
+            {
+                can_msg_desc->decode(can_msg, decoded_frame);
+                result.check((decoded_frame.getRawValue(0u).uint_value == encoding.mode), [&] () { return ("encoding " + to_string(i) + " : wrong multiplexer value"); });
+                for (size_t j = 0; j < 2u; j++)
+                {
+                    const size_t signal_index = encoding.signal_indexes[j];
+                    const vector<size_t>& decoded_signals = decoded_frame.getDecodedSignals();
+                    const bool decoded = (find(decoded_signals.begin(), decoded_signals.end(), signal_index) != decoded_signals.end());
+                    const double decoded_value = (decoded ? decoded_frame.getConvertedValue(signal_index).double_value : 0.);
+                    result.check((decoded && (fabs(decoded_value - encoding.values[j]) < 1e-9)),
+                                 [&] () { return ("encoding " + to_string(i) + " : " + ROUND_TRIP_SIGNAL_NAMES[signal_index] + " decoded as " + to_string(decoded_value)); });
+                }
+            }
+        }
+
+        // Converted values whose raw value doesn't fit in the signal
+        CanMsg can_msg;
+        encoder.init(can_msg);
+        CanMsgValueData value;
+        value.double_value = 6553.6;
+        result.check(!encoder.setValue(can_msg, "speed", value), [] () { return string("speed 6553.6 encoded"); });
+        value.double_value = -104.;
+        result.check(encoder.setValue(can_msg, "temperature", value), [] () { return string("temperature -104 rejected"); });
+        value.double_value = -104.5;
+        result.check(!encoder.setValue(can_msg, "temperature", value), [] () { return string("temperature -104.5 encoded"); });
+        value.double_value = 8192.;
+        result.check(!encoder.setValue(can_msg, "pressure", value), [] () { return string("pressure 8192 encoded"); });
+    }
+
+    return result.report();
+}
+
+
+/** \brief Application's entry point */
+int main(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    bool success = testValueLayouts();
+    success = (testLazyDatabase() && success);
+    success = (testLazyDatabaseSharing() && success);
+    success = (testHandleSubscriptions() && success);
+    success = (testScaledPredicates() && success);
+    success = (testChangeDetection() && success);
+    success = (testEncoderRanges() && success);
+    success = (testEncoderRoundTrip() && success);
+
+    return (success ? 0 : 1);
+}
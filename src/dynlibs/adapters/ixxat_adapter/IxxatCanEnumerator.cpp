@@ -141,6 +141,7 @@ CanAdapterController* IxxatCanEnumerator::createController(const std::string& co
         controller->stop = &CanAdapterController_Stop;
         controller->send = &CanAdapterController_Send;
         controller->get_error_msg = &CanAdapterController_GetErrorMsg;
+        controller->set_filters = nullptr;
         controller->controller = new IxxatCanController(vciid, iter->second.second);
     }
 
@@ -37,6 +37,12 @@ typedef struct _loopback_controller_t
     uint8_t mode;
     /** \brief Callbacks */
     CanAdapterControllerCallbacks callbacks;
+    /** \brief Mutex protecting the acceptance filters which can be changed while the controller is started */
+    void* filters_mutex;
+    /** \brief Acceptance filters */
+    CanAdapterFilter* filters;
+    /** \brief Number of acceptance filters */
+    uint32_t filter_count;
     /** \brief Last error message */
     const char* last_error_message;
 } loopback_controller_t;
@@ -46,12 +52,28 @@ typedef struct _loopback_controller_t
 /** \brief Allocate a controller */
 void* CanAdapterController_Allocate(void)
 {
-    return calloc(1u, sizeof(loopback_controller_t));
+    loopback_controller_t* loopback_controller = calloc(1u, sizeof(loopback_controller_t));
+    if (loopback_controller != NULL)
+    {
+        loopback_controller->filters_mutex = OSAL_MutexCreate();
+        if (loopback_controller->filters_mutex == NULL)
+        {
+            free(loopback_controller);
+            loopback_controller = NULL;
+        }
+    }
+    return loopback_controller;
 }
 
 /** \brief Release a controller */
 void CanAdapterController_Release(void* controller)
 {
+    loopback_controller_t* loopback_controller = controller;
+    if (loopback_controller != NULL)
+    {
+        free(loopback_controller->filters);
+        OSAL_MutexDestroy(loopback_controller->filters_mutex);
+    }
     free(controller);
 }
 
@@ -229,11 +251,18 @@ bool DYN_LINK_API CanAdapterController_Send(void* controller, const CanMsg* can_
                 }
                 else
                 {
-                    CanData can_data = { 0 };
-                    can_data.header.type = CAN_DATA_RX_MSG;
-                    can_data.msg = (*can_msg);
-                    OSAL_GetTimestamp(&can_data.header.timestamp_sec, &can_data.header.timestamp_nsec);
-                    loopback_controller->callbacks.data_received(loopback_controller->callbacks.parameter, &can_data);
+                    bool accept;
+                    OSAL_MutexLock(loopback_controller->filters_mutex);
+                    accept = CanAdapterFilter_Accept(loopback_controller->filters, loopback_controller->filter_count, can_msg);
+                    OSAL_MutexUnlock(loopback_controller->filters_mutex);
+                    if (accept)
+                    {
+                        CanData can_data = { 0 };
+                        can_data.header.type = CAN_DATA_RX_MSG;
+                        can_data.msg = (*can_msg);
+                        OSAL_GetTimestamp(&can_data.header.timestamp_sec, &can_data.header.timestamp_nsec);
+                        loopback_controller->callbacks.data_received(loopback_controller->callbacks.parameter, &can_data);
+                    }
                     ret = true;
                 }
             }
@@ -251,6 +280,46 @@ bool DYN_LINK_API CanAdapterController_Send(void* controller, const CanMsg* can_
     return ret;
 }
 
+/** \brief Set the acceptance filters of the controller */
+bool DYN_LINK_API CanAdapterController_SetFilters(void* controller, const CanAdapterFilter* filters, const uint32_t count)
+{
+    bool ret = false;
+    loopback_controller_t* loopback_controller = controller;
+
+    if ((loopback_controller != NULL) && ((filters != NULL) || (count == 0)))
+    {
+        CanAdapterFilter* new_filters = NULL;
+        if (count != 0)
+        {
+            new_filters = malloc(count * sizeof(CanAdapterFilter));
+        }
+        if ((new_filters != NULL) || (count == 0))
+        {
+            CanAdapterFilter* old_filters;
+            if (count != 0)
+            {
+                memcpy(new_filters, filters, count * sizeof(CanAdapterFilter));
+            }
+
+            // The filters can be replaced while messages are sent
+            OSAL_MutexLock(loopback_controller->filters_mutex);
+            old_filters = loopback_controller->filters;
+            loopback_controller->filters = new_filters;
+            loopback_controller->filter_count = count;
+            OSAL_MutexUnlock(loopback_controller->filters_mutex);
+
+            free(old_filters);
+            ret = true;
+        }
+        else
+        {
+            loopback_controller->last_error_message = "Not enough memory";
+        }
+    }
+
+    return ret;
+}
+
 /** \brief Retrieve the last error message */
 const char* DYN_LINK_API CanAdapterController_GetErrorMsg(void* controller)
 {
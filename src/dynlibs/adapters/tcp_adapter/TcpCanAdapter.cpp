@@ -89,6 +89,7 @@ static CanAdapterController* DYN_LINK_API CAN_ADAPTER_CreateController(const cha
     controller->stop = &CanAdapterController_Stop;
     controller->send = &CanAdapterController_Send;
     controller->get_error_msg = &CanAdapterController_GetErrorMsg;
+    controller->set_filters = &CanAdapterController_SetFilters;
     controller->controller = new TcpCanController(server, port, timeout);
     return controller;
 }
@@ -78,3 +78,10 @@ const char* DYN_LINK_API CanAdapterController_GetErrorMsg(void* controller)
     return tcp_controller->getErrorMsg();
 }
 
+/** \brief Set the acceptance filters of the controller */
+bool DYN_LINK_API CanAdapterController_SetFilters(void* controller, const CanAdapterFilter* filters, const uint32_t count)
+{
+    TcpCanController* tcp_controller = reinterpret_cast<TcpCanController*>(controller);
+    return tcp_controller->setFilters(filters, count);
+}
+
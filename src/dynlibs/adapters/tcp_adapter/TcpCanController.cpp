@@ -37,6 +37,9 @@ TcpCanController::TcpCanController(const std::string& server, const uint16_t por
 , m_callbacks()
 , m_opened(false)
 , m_started(false)
+, m_tx_mutex()
+, m_filters_checked(false)
+, m_filters_supported(false)
 {
     m_caps.extended = true;
     m_caps.max_bitrate = static_cast<uint16_t>(CANBR_1000K);
@@ -65,6 +68,8 @@ bool TcpCanController::open()
             if (ret)
             {
                 m_opened = true;
+                m_filters_checked = false;
+                m_filters_supported = false;
             }
             else
             {
@@ -150,34 +155,13 @@ bool TcpCanController::start(const CanAdapterControllerCallbacks* callbacks)
             if (ret)
             {
                 // Wait response
-                uint16_t response = 0;
-                ret = m_serializer.read(response);
+                ret = waitResponse(cmd);
                 if (ret)
                 {
-                    // Check response
-                    ret = (response == cmd);
-                    if (ret)
-                    {
-                        // Start Rx thread
-                        m_callbacks = *callbacks;
-                        m_rx_thread = new thread(&TcpCanController::rxThread, this);
-                        m_started = ret;
-                    }
-                    else
-                    {
-                        m_last_error = "Invalid response from server";
-                    }
-                }
-                else
-                {
-                    if (m_tcp_client.isConnected())
-                    {
-                        m_last_error = "No response from server";
-                    }
-                    else
-                    {
-                        m_last_error = "Disconnected from server";
-                    }
+                    // Start Rx thread
+                    m_callbacks = *callbacks;
+                    m_rx_thread = new thread(&TcpCanController::rxThread, this);
+                    m_started = ret;
                 }
             }
             else
@@ -217,6 +201,7 @@ bool TcpCanController::stop()
         {
             // Send stop request
             const uint16_t cmd = TcpCanSerializer::CMD_STOP;
+            const lock_guard<mutex> lock(m_tx_mutex);
             m_serializer.write(cmd);
         }
 
@@ -243,7 +228,10 @@ bool TcpCanController::send(const CanMsg* can_msg)
     if (m_started && (can_msg != nullptr))
     {
         // Send message
-        ret = m_serializer.write(*can_msg);
+        {
+            const lock_guard<mutex> lock(m_tx_mutex);
+            ret = m_serializer.write(*can_msg);
+        }
         if (!ret)
         {
             if (m_tcp_client.isConnected())
@@ -260,6 +248,116 @@ bool TcpCanController::send(const CanMsg* can_msg)
     return ret;
 }
 
+/** \brief Set the acceptance filters of the controller */
+bool TcpCanController::setFilters(const CanAdapterFilter* filters, const uint32_t count)
+{
+    bool ret = false;
+
+    // Check if the connection is opened
+    if (m_opened)
+    {
+        if (((filters != nullptr) || (count == 0)) && (count <= 0xFFFFu))
+        {
+            // The support can't be checked anymore once the Rx thread reads the server's responses,
+            // the messages are then not filtered
+            ret = (m_filters_checked || m_started || checkFiltersSupport());
+            if (ret && m_filters_supported)
+            {
+                // Send filters to the server
+                const uint16_t cmd = TcpCanSerializer::CMD_FILTERS;
+                const uint16_t filter_count = static_cast<uint16_t>(count);
+                {
+                    const lock_guard<mutex> lock(m_tx_mutex);
+                    ret = m_serializer.write(cmd) && m_serializer.write(filter_count);
+                    for (uint32_t i = 0; ret && (i < count); i++)
+                    {
+                        const uint8_t flags = (filters[i].extended ? TcpCanSerializer::FLAG_EXT : 0u);
+                        ret = m_serializer.write(filters[i].id) && m_serializer.write(filters[i].mask) && m_serializer.write(flags);
+                    }
+                }
+                if (ret)
+                {
+                    // Once started, the response is received by the Rx thread
+                    if (!m_started)
+                    {
+                        ret = waitResponse(cmd);
+                    }
+                }
+                else
+                {
+                    m_last_error = "Unable to send data to the server";
+                }
+            }
+        }
+        else
+        {
+            m_last_error = "Invalid parameter";
+        }
+    }
+    else
+    {
+        m_last_error = "Controller not opened";
+    }
+
+    return ret;
+}
+
+/** \brief Check if the server supports the acceptance filters */
+bool TcpCanController::checkFiltersSupport()
+{
+    // Send an empty list of filters which accepts all the messages, a server which doesn't
+    // support the acceptance filters ignores it and doesn't respond
+    const uint16_t cmd = TcpCanSerializer::CMD_FILTERS;
+    const uint16_t filter_count = 0;
+    bool ret = m_serializer.write(cmd) && m_serializer.write(filter_count);
+    if (ret)
+    {
+        m_filters_supported = waitResponse(cmd);
+        ret = (m_filters_supported || m_tcp_client.isConnected());
+        m_filters_checked = ret;
+    }
+    else
+    {
+        m_last_error = "Unable to send data to the server";
+    }
+
+    return ret;
+}
+
+/** \brief Wait for the response to a command */
+bool TcpCanController::waitResponse(const uint16_t cmd)
+{
+    // Skip the late responses to the acceptance filters check
+    uint16_t response = 0;
+    bool ret = m_serializer.read(response);
+    while (ret && (response == TcpCanSerializer::CMD_FILTERS) && (cmd != TcpCanSerializer::CMD_FILTERS))
+    {
+        ret = m_serializer.read(response);
+    }
+    if (ret)
+    {
+        // Check response
+        ret = (response == cmd);
+        if (!ret)
+        {
+            m_last_error = "Invalid response from server";
+        }
+    }
+    else
+    {
+        if (m_tcp_client.isConnected())
+        {
+            m_last_error = "No response from server";
+        }
+        else
+        {
+            m_last_error = "Disconnected from server";
+        }
+    }
+
+    return ret;
+}
+
 /** \brief Rx thread */
 void TcpCanController::rxThread()
 {
@@ -299,6 +397,12 @@ void TcpCanController::rxThread()
                     break;
                 }
 
+                case TcpCanSerializer::CMD_FILTERS:
+                {
+                    // Response to acceptance filters sent while started
+                    break;
+                }
+
                 case TcpCanSerializer::CMD_ERR_FRAME:
                 {
                     // Error frame
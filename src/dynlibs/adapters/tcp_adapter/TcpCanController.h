@@ -27,6 +27,7 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <string>
 #include <thread>
+#include <mutex>
 
 /** \brief CAN controller implementation for CAN on TCP */
 class TcpCanController : public INoCopy
@@ -66,6 +67,11 @@ class TcpCanController : public INoCopy
         bool send(const CanMsg* can_msg);
 
 
+        /** \brief Set the acceptance filters of the controller, the messages are not filtered
+                   if the server doesn't support acceptance filters */
+        bool setFilters(const CanAdapterFilter* filters, const uint32_t count);
+
+
         /** \brief Retrieve the last error message */
         const char* getErrorMsg() const { return m_last_error.c_str(); }
 
@@ -106,6 +112,21 @@ class TcpCanController : public INoCopy
         /** \brief Indicate if the controer is started */
         bool m_started;
 
+        /** \brief Mutex to serialize the writes to the server */
+        std::mutex m_tx_mutex;
+
+        /** \brief Indicate if the server's support of the acceptance filters has been checked */
+        bool m_filters_checked;
+
+        /** \brief Indicate if the server supports the acceptance filters */
+        bool m_filters_supported;
+
+
+        /** \brief Check if the server supports the acceptance filters, must be called while the controller is not started */
+        bool checkFiltersSupport();
+
+        /** \brief Wait for the response to a command, must be called while the controller is not started */
+        bool waitResponse(const uint16_t cmd);
 
         /** \brief Rx thread */
         void rxThread();
@@ -47,5 +47,8 @@ bool DYN_LINK_API CanAdapterController_Send(void* controller, const CanMsg* can_
 /** \brief Retrieve the last error message */
 const char* DYN_LINK_API CanAdapterController_GetErrorMsg(void* controller);
 
+/** \brief Set the acceptance filters of the controller */
+bool DYN_LINK_API CanAdapterController_SetFilters(void* controller, const CanAdapterFilter* filters, const uint32_t count);
+
 
 #endif // UDPCANADAPTERCONTROLLER_H
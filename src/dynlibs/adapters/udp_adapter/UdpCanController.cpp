@@ -38,6 +38,7 @@ UdpCanController::UdpCanController(const std::string& ip, const uint16_t port)
 , m_callbacks()
 , m_opened(false)
 , m_started(false)
+, m_filters(new vector<CanAdapterFilter>())
 {
     m_caps.extended = true;
     m_caps.max_bitrate = static_cast<uint16_t>(CANBR_1000K);
@@ -214,6 +215,24 @@ bool UdpCanController::send(const CanMsg* can_msg)
     return ret;
 }
 
+/** \brief Set the acceptance filters of the controller */
+bool UdpCanController::setFilters(const CanAdapterFilter* filters, const uint32_t count)
+{
+    bool ret = false;
+
+    if ((filters != nullptr) || (count == 0))
+    {
+        m_filters.publish(new vector<CanAdapterFilter>(filters, filters + count));
+        ret = true;
+    }
+    else
+    {
+        m_last_error = "Invalid parameter";
+    }
+
+    return ret;
+}
+
 /** \brief Rx thread */
 void UdpCanController::rxThread()
 {
@@ -229,14 +248,22 @@ void UdpCanController::rxThread()
             {
                 case UdpCanSerializer::CAN_MSG:
                 {
-                    // CAN message received
-                    CanData can_data = { 0 };
-                    can_data.msg = udp_msg.can_msg;
-                    can_data.header.type = CAN_DATA_RX_MSG;
-                    OSAL_GetTimestamp(&can_data.header.timestamp_sec, &can_data.header.timestamp_nsec);
-
-                    // Notify message
-                    m_callbacks.data_received(m_callbacks.parameter, &can_data);
+                    // CAN message received, check acceptance filters
+                    bool accept;
+                    {
+                        RcuPtr<vector<CanAdapterFilter>>::ReadGuard filters(m_filters);
+                        accept = CanAdapterFilter_Accept(filters->data(), static_cast<uint32_t>(filters->size()), &udp_msg.can_msg);
+                    }
+                    if (accept)
+                    {
+                        CanData can_data = { 0 };
+                        can_data.msg = udp_msg.can_msg;
+                        can_data.header.type = CAN_DATA_RX_MSG;
+                        OSAL_GetTimestamp(&can_data.header.timestamp_sec, &can_data.header.timestamp_nsec);
+
+                        // Notify message
+                        m_callbacks.data_received(m_callbacks.parameter, &can_data);
+                    }
                     break;
                 }
 
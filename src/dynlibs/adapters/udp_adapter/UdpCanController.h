@@ -24,9 +24,11 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "NoCopy.h"
 #include "MulticastUdpSocket.h"
 #include "UdpCanSerializer.h"
+#include "RcuPtr.h"
 
 #include <string>
 #include <thread>
+#include <vector>
 
 /** \brief CAN controller implementation for CAN on multicast UDP */
 class UdpCanController : public INoCopy
@@ -66,6 +68,10 @@ class UdpCanController : public INoCopy
         bool send(const CanMsg* can_msg);
 
 
+        /** \brief Set the acceptance filters of the controller */
+        bool setFilters(const CanAdapterFilter* filters, const uint32_t count);
+
+
         /** \brief Retrieve the last error message */
         const char* getErrorMsg() const { return m_last_error.c_str(); }
 
@@ -106,6 +112,9 @@ class UdpCanController : public INoCopy
         /** \brief Indicate if the controer is started */
         bool m_started;
 
+        /** \brief Acceptance filters, they can be replaced while the Rx thread is running */
+        RcuPtr<std::vector<CanAdapterFilter>> m_filters;
+
 
         /** \brief Rx thread */
         void rxThread();
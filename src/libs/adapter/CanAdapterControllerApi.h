@@ -41,6 +41,32 @@ typedef struct _CanAdapterControllerCapabilities
 } CanAdapterControllerCapabilities;
 
 
+/** \brief CAN adapter acceptance filter : a message is accepted if ((msg.id & mask) == (id & mask))
+           and if its extended flag is the same as the filter's one */
+typedef struct _CanAdapterFilter
+{
+    /** \brief Identifier */
+    uint32_t id;
+    /** \brief Mask to apply on the message identifier */
+    uint32_t mask;
+    /** \brief Indicate if the filter applies to extended messages */
+    bool extended;
+} CanAdapterFilter;
+
+/** \brief Check if a CAN message is accepted by a list of acceptance filters (an empty list accepts all the messages) */
+static inline bool CanAdapterFilter_Accept(const CanAdapterFilter* filters, const uint32_t count, const CanMsg* can_msg)
+{
+    bool accept = (count == 0);
+    uint32_t i;
+    for (i = 0; (i < count) && !accept; i++)
+    {
+        accept = ((filters[i].extended == can_msg->extended) &&
+                  ((can_msg->id & filters[i].mask) == (filters[i].id & filters[i].mask)));
+    }
+    return accept;
+}
+
+
 /** \brief Callback when CAN data has been received on the controller */
 typedef void (DYN_LINK_API *fp_can_adapter_controller_can_data_received_t)(void* parameter, const CanData* can_data);
 
@@ -76,6 +102,10 @@ typedef bool(DYN_LINK_API *fp_can_adapter_controller_send_t)(void* controller, c
 /** \brief Retrieve the last error message */
 typedef const char* (DYN_LINK_API *fp_can_adapter_controller_get_error_msg_t)(void* controller);
 
+/** \brief Set the acceptance filters of the controller (count = 0 to accept all the messages),
+           can be called while the controller is started */
+typedef bool (DYN_LINK_API *fp_can_adapter_controller_set_filters_t)(void* controller, const CanAdapterFilter* filters, const uint32_t count);
+
 
 /** \brief CAN adapter controller object */
 typedef struct _CanAdapterController
@@ -89,6 +119,9 @@ typedef struct _CanAdapterController
     fp_can_adapter_controller_send_t send;
     fp_can_adapter_controller_get_error_msg_t get_error_msg;
     void* controller;
+    /** \brief Optional, NULL if the controller does not support acceptance filters. Appended after the
+               controller handle so that the layout of the previous members is unchanged for the plugins */
+    fp_can_adapter_controller_set_filters_t set_filters;
 } CanAdapterController;
 
 #endif // CANADAPTERCONTROLLERAPI_H
@@ -62,6 +62,20 @@ bool CanController::send(const CanMsg& can_msg)
     return ret;
 }
 
+/** \brief Set the acceptance filters of the controller (empty list to accept all the messages) */
+bool CanController::setFilters(const std::vector<CanAdapterFilter>& filters)
+{
+    bool ret = false;
+
+    if (supportsFilters())
+    {
+        const CanAdapterFilter* filters_data = (filters.empty() ? nullptr : &filters[0]);
+        ret = m_controller->set_filters(m_controller->controller, filters_data, static_cast<uint32_t>(filters.size()));
+    }
+
+    return ret;
+}
+
 /** \brief Callback when CAN data has been received on the controller */
 void DYN_LINK_API CanController::canDataReceivedCallback(void* parameter, const CanData* can_data)
 {
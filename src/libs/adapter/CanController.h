@@ -23,6 +23,8 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "CanAdapterPluginApi.h"
 #include "NoCopy.h"
 
+#include <vector>
+
 class ICanControllerListener;
 
 /** \brief CAN controller */
@@ -62,6 +64,14 @@ class CanController : public INoCopy
         bool send(const CanMsg& can_msg);
 
 
+        /** \brief Indicate if the controller supports acceptance filters */
+        bool supportsFilters() const { return (m_controller->set_filters != nullptr); }
+
+        /** \brief Set the acceptance filters of the controller (empty list to accept all the messages),
+                   can be called while the controller is started */
+        bool setFilters(const std::vector<CanAdapterFilter>& filters);
+
+
         /** \brief Retrieve the last error message */
         const char* getErrorMsg() const { return m_controller->get_error_msg(m_controller->controller); }
 
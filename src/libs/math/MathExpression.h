@@ -43,6 +43,10 @@ class IMathExpression
 
         /** \brief Evaluate the mathematical expression's value */
         virtual double evaluate(const MathExpressionEnv& var_values) = 0;
+
+        /** \brief Decompose the mathematical expression as factor * var_name + offset,
+                   return false if the expression is not linear regarding the variable */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const { return false; }
 };
 
 /** \brief Variable in a mathematical expression */
@@ -61,6 +65,14 @@ class VarExpression : public IMathExpression
         /** \brief Evaluate the mathematical expression's value */
         virtual double evaluate(const MathExpressionEnv& var_values) override { return var_values.at(m_var_name); }
 
+        /** \brief Decompose the mathematical expression as factor * var_name + offset */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const override
+        {
+            factor = 1.;
+            offset = 0.;
+            return (var_name == m_var_name);
+        }
+
 
     private:
 
@@ -84,6 +96,14 @@ class ConstExpression : public IMathExpression
         /** \brief Evaluate the mathematical expression's value */
         virtual double evaluate(const MathExpressionEnv& var_values) override { return m_value; }
 
+        /** \brief Decompose the mathematical expression as factor * var_name + offset */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const override
+        {
+            factor = 0.;
+            offset = m_value;
+            return true;
+        }
+
     private:
 
         /** \brief Numerical constant's value */
@@ -130,6 +150,13 @@ class BinaryOperator : public IMathExpression
         /** \brief Compute the binary operation */
         virtual double compute(double left_expr, double right_expr) = 0;
 
+        /** \brief Decompose both operands as factor * var_name + offset */
+        bool getOperandsLinearCoefficients(const std::string& var_name, double& left_factor, double& left_offset, double& right_factor, double& right_offset) const
+        {
+            return (m_left_expr->getLinearCoefficients(var_name, left_factor, left_offset) &&
+                    m_right_expr->getLinearCoefficients(var_name, right_factor, right_offset));
+        }
+
 
     private:
 
@@ -154,6 +181,16 @@ class AddOperator : public BinaryOperator
         /** \brief Destructor */
         virtual ~AddOperator() {};
 
+        /** \brief Decompose the mathematical expression as factor * var_name + offset */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const override
+        {
+            double left_factor, left_offset, right_factor, right_offset;
+            bool ret = getOperandsLinearCoefficients(var_name, left_factor, left_offset, right_factor, right_offset);
+            factor = left_factor + right_factor;
+            offset = left_offset + right_offset;
+            return ret;
+        }
+
 
     protected:
 
@@ -175,6 +212,16 @@ class SubsOperator : public BinaryOperator
         /** \brief Destructor */
         virtual ~SubsOperator() {};
 
+        /** \brief Decompose the mathematical expression as factor * var_name + offset */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const override
+        {
+            double left_factor, left_offset, right_factor, right_offset;
+            bool ret = getOperandsLinearCoefficients(var_name, left_factor, left_offset, right_factor, right_offset);
+            factor = left_factor - right_factor;
+            offset = left_offset - right_offset;
+            return ret;
+        }
+
 
     protected:
 
@@ -196,6 +243,32 @@ class MulOperator : public BinaryOperator
         /** \brief Destructor */
         virtual ~MulOperator() {};
 
+        /** \brief Decompose the mathematical expression as factor * var_name + offset */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const override
+        {
+            // Linear only if one of the operands is a constant
+            double left_factor, left_offset, right_factor, right_offset;
+            bool ret = getOperandsLinearCoefficients(var_name, left_factor, left_offset, right_factor, right_offset);
+            if (ret)
+            {
+                if (left_factor == 0.)
+                {
+                    factor = left_offset * right_factor;
+                    offset = left_offset * right_offset;
+                }
+                else if (right_factor == 0.)
+                {
+                    factor = left_factor * right_offset;
+                    offset = left_offset * right_offset;
+                }
+                else
+                {
+                    ret = false;
+                }
+            }
+            return ret;
+        }
+
 
     protected:
 
@@ -217,6 +290,24 @@ class DivOperator : public BinaryOperator
         /** \brief Destructor */
         virtual ~DivOperator() {};
 
+        /** \brief Decompose the mathematical expression as factor * var_name + offset */
+        virtual bool getLinearCoefficients(const std::string& var_name, double& factor, double& offset) const override
+        {
+            // Linear only if the divisor is a non null constant
+            double left_factor, left_offset, right_factor, right_offset;
+            bool ret = getOperandsLinearCoefficients(var_name, left_factor, left_offset, right_factor, right_offset);
+            if (ret && (right_factor == 0.) && (right_offset != 0.))
+            {
+                factor = left_factor / right_offset;
+                offset = left_offset / right_offset;
+            }
+            else
+            {
+                ret = false;
+            }
+            return ret;
+        }
+
 
     protected:
 
@@ -0,0 +1,104 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+
+/** \brief Constructor */
+MappedFile::MappedFile()
+: m_fd(-1)
+, m_data(nullptr)
+, m_size(0)
+{}
+
+/** \brief Destructor */
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/** \brief Map a file in memory */
+bool MappedFile::open(const std::string& path)
+{
+    bool ret = false;
+
+    // Check if the file is already opened
+    if (m_fd < 0)
+    {
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd >= 0)
+        {
+            struct stat file_stat;
+            if (fstat(m_fd, &file_stat) == 0)
+            {
+                // An empty file can't be mapped but is still a valid file
+                const size_t size = static_cast<size_t>(file_stat.st_size);
+                if (size == 0)
+                {
+                    ret = true;
+                }
+                else
+                {
+                    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+                    if (address != MAP_FAILED)
+                    {
+                        // The file is read once from the beginning to the end
+                        madvise(address, size, MADV_SEQUENTIAL);
+                        m_data = static_cast<const char*>(address);
+                        m_size = size;
+                        ret = true;
+                    }
+                }
+            }
+        }
+        if (!ret)
+        {
+            close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Unmap the file */
+bool MappedFile::close()
+{
+    bool ret = false;
+
+    if (m_fd >= 0)
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+            m_data = nullptr;
+            m_size = 0;
+        }
+        ::close(m_fd);
+        m_fd = -1;
+        ret = true;
+    }
+
+    return ret;
+}
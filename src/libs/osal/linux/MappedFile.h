@@ -0,0 +1,66 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "NoCopy.h"
+
+#include <string>
+
+
+/** \brief File mapped in memory in read-only mode */
+class MappedFile : public INoCopy
+{
+    public:
+
+        /** \brief Constructor */
+        MappedFile();
+        /** \brief Destructor */
+        virtual ~MappedFile();
+
+
+        /** \brief Map a file in memory */
+        bool open(const std::string& path);
+
+        /** \brief Unmap the file */
+        bool close();
+
+
+        /** \brief Get the address of the file's contents (nullptr if the file is not opened or empty) */
+        const char* getData() const { return m_data; }
+
+        /** \brief Get the size in bytes of the file's contents */
+        size_t getSize() const { return m_size; }
+
+
+    private:
+
+        /** \brief File descriptor */
+        int m_fd;
+
+        /** \brief Address of the file's contents */
+        const char* m_data;
+
+        /** \brief Size of the file's contents */
+        size_t m_size;
+};
+
+
+#endif // MAPPEDFILE_H
@@ -20,6 +20,8 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "osal.h"
 
 #include <time.h>
+#include <pthread.h>
+#include <stdlib.h>
 
 
 #ifdef __cplusplus
@@ -51,6 +53,41 @@ void OSAL_LocalTime(const uint64_t unix_timestamp, struct tm* tm)
     localtime_r(reinterpret_cast<const time_t*>(&unix_timestamp), tm);
 }
 
+
+/** \brief Create a mutex, return NULL if the mutex can't be created */
+void* OSAL_MutexCreate()
+{
+    pthread_mutex_t* mutex = static_cast<pthread_mutex_t*>(malloc(sizeof(pthread_mutex_t)));
+    if ((mutex != nullptr) && (pthread_mutex_init(mutex, nullptr) != 0))
+    {
+        free(mutex);
+        mutex = nullptr;
+    }
+    return mutex;
+}
+
+/** \brief Destroy a mutex */
+void OSAL_MutexDestroy(void* mutex)
+{
+    if (mutex != nullptr)
+    {
+        pthread_mutex_destroy(static_cast<pthread_mutex_t*>(mutex));
+        free(mutex);
+    }
+}
+
+/** \brief Lock a mutex */
+void OSAL_MutexLock(void* mutex)
+{
+    pthread_mutex_lock(static_cast<pthread_mutex_t*>(mutex));
+}
+
+/** \brief Unlock a mutex */
+void OSAL_MutexUnlock(void* mutex)
+{
+    pthread_mutex_unlock(static_cast<pthread_mutex_t*>(mutex));
+}
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
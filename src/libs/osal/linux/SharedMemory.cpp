@@ -0,0 +1,148 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SharedMemory.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+
+/** \brief Get the POSIX name of a shared memory segment */
+static string getShmName(const std::string& name)
+{
+    string shm_name = name;
+    if (shm_name.empty() || (shm_name[0] != '/'))
+    {
+        shm_name = "/" + shm_name;
+    }
+    return shm_name;
+}
+
+
+/** \brief Constructor */
+SharedMemory::SharedMemory()
+: m_fd(-1)
+, m_address(nullptr)
+, m_size(0)
+, m_created_name()
+{}
+
+/** \brief Destructor */
+SharedMemory::~SharedMemory()
+{
+    close();
+}
+
+/** \brief Create a shared memory segment mapped in read-write mode, an existing segment with the same name is replaced */
+bool SharedMemory::create(const std::string& name, const size_t size)
+{
+    bool ret = false;
+
+    // Check if the segment is already opened
+    if (m_fd < 0)
+    {
+        // Replace any previous segment so that its readers don't see a partially initialized layout
+        const string shm_name = getShmName(name);
+        shm_unlink(shm_name.c_str());
+        m_fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        if (m_fd >= 0)
+        {
+            m_created_name = shm_name;
+            if (ftruncate(m_fd, static_cast<off_t>(size)) == 0)
+            {
+                void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+                if (address != MAP_FAILED)
+                {
+                    m_address = address;
+                    m_size = size;
+                    ret = true;
+                }
+            }
+        }
+        if (!ret)
+        {
+            close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Open an existing shared memory segment mapped in read-only mode */
+bool SharedMemory::open(const std::string& name)
+{
+    bool ret = false;
+
+    // Check if the segment is already opened
+    if (m_fd < 0)
+    {
+        const string shm_name = getShmName(name);
+        m_fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+        if (m_fd >= 0)
+        {
+            struct stat shm_stat;
+            if ((fstat(m_fd, &shm_stat) == 0) && (shm_stat.st_size > 0))
+            {
+                const size_t size = static_cast<size_t>(shm_stat.st_size);
+                void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fd, 0);
+                if (address != MAP_FAILED)
+                {
+                    m_address = address;
+                    m_size = size;
+                    ret = true;
+                }
+            }
+        }
+        if (!ret)
+        {
+            close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Close the shared memory segment, a created segment is removed */
+bool SharedMemory::close()
+{
+    bool ret = false;
+
+    if (m_fd >= 0)
+    {
+        if (m_address != nullptr)
+        {
+            munmap(m_address, m_size);
+            m_address = nullptr;
+            m_size = 0;
+        }
+        ::close(m_fd);
+        m_fd = -1;
+        if (!m_created_name.empty())
+        {
+            shm_unlink(m_created_name.c_str());
+            m_created_name.clear();
+        }
+        ret = true;
+    }
+
+    return ret;
+}
@@ -46,6 +46,19 @@ void OSAL_GetTimestamp(int64_t* timestamp_sec, uint32_t* timestamp_nsec);
 /** \brief Converts a UNIX timestamp to a broken down time structure */
 void OSAL_LocalTime(const uint64_t unix_timestamp, struct tm* tm);
 
+
+/** \brief Create a mutex, return NULL if the mutex can't be created */
+void* OSAL_MutexCreate();
+
+/** \brief Destroy a mutex */
+void OSAL_MutexDestroy(void* mutex);
+
+/** \brief Lock a mutex */
+void OSAL_MutexLock(void* mutex);
+
+/** \brief Unlock a mutex */
+void OSAL_MutexUnlock(void* mutex);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -0,0 +1,107 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+using namespace std;
+
+
+/** \brief Constructor */
+MappedFile::MappedFile()
+: m_file(INVALID_HANDLE_VALUE)
+, m_mapping(nullptr)
+, m_data(nullptr)
+, m_size(0)
+{}
+
+/** \brief Destructor */
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/** \brief Map a file in memory */
+bool MappedFile::open(const std::string& path)
+{
+    bool ret = false;
+
+    // Check if the file is already opened
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER file_size;
+            if (GetFileSizeEx(m_file, &file_size))
+            {
+                // An empty file can't be mapped but is still a valid file
+                const size_t size = static_cast<size_t>(file_size.QuadPart);
+                if (size == 0)
+                {
+                    ret = true;
+                }
+                else
+                {
+                    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if (m_mapping != nullptr)
+                    {
+                        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                        if (m_data != nullptr)
+                        {
+                            m_size = size;
+                            ret = true;
+                        }
+                    }
+                }
+            }
+        }
+        if (!ret)
+        {
+            close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Unmap the file */
+bool MappedFile::close()
+{
+    bool ret = false;
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+            m_data = nullptr;
+            m_size = 0;
+        }
+        if (m_mapping != nullptr)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+        ret = true;
+    }
+
+    return ret;
+}
@@ -93,6 +93,38 @@ void OSAL_LocalTime(const uint64_t unix_timestamp, struct tm* tm)
     localtime_s(tm, reinterpret_cast<const time_t*>(&unix_timestamp));
 }
 
+
+/** \brief Create a mutex, return NULL if the mutex can't be created */
+void* OSAL_MutexCreate()
+{
+    CRITICAL_SECTION* mutex = new CRITICAL_SECTION;
+    InitializeCriticalSection(mutex);
+    return mutex;
+}
+
+/** \brief Destroy a mutex */
+void OSAL_MutexDestroy(void* mutex)
+{
+    if (mutex != nullptr)
+    {
+        CRITICAL_SECTION* critical_section = static_cast<CRITICAL_SECTION*>(mutex);
+        DeleteCriticalSection(critical_section);
+        delete critical_section;
+    }
+}
+
+/** \brief Lock a mutex */
+void OSAL_MutexLock(void* mutex)
+{
+    EnterCriticalSection(static_cast<CRITICAL_SECTION*>(mutex));
+}
+
+/** \brief Unlock a mutex */
+void OSAL_MutexUnlock(void* mutex)
+{
+    LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(mutex));
+}
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -0,0 +1,121 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SharedMemory.h"
+
+using namespace std;
+
+
+/** \brief Constructor */
+SharedMemory::SharedMemory()
+: m_mapping(nullptr)
+, m_address(nullptr)
+, m_size(0)
+, m_created_name()
+{}
+
+/** \brief Destructor */
+SharedMemory::~SharedMemory()
+{
+    close();
+}
+
+/** \brief Create a shared memory segment mapped in read-write mode, an existing segment with the same name is replaced */
+bool SharedMemory::create(const std::string& name, const size_t size)
+{
+    bool ret = false;
+
+    // Check if the segment is already opened
+    if (m_mapping == nullptr)
+    {
+        // The segment is removed by the system when its last handle is closed
+        const uint64_t size_64 = static_cast<uint64_t>(size);
+        m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 
+                                       static_cast<DWORD>(size_64 >> 32u), static_cast<DWORD>(size_64 & 0xFFFFFFFFu), name.c_str());
+        if ((m_mapping != nullptr) && (GetLastError() != ERROR_ALREADY_EXISTS))
+        {
+            m_created_name = name;
+            m_address = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+            if (m_address != nullptr)
+            {
+                m_size = size;
+                ret = true;
+            }
+        }
+        if (!ret)
+        {
+            close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Open an existing shared memory segment mapped in read-only mode */
+bool SharedMemory::open(const std::string& name)
+{
+    bool ret = false;
+
+    // Check if the segment is already opened
+    if (m_mapping == nullptr)
+    {
+        m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (m_mapping != nullptr)
+        {
+            m_address = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (m_address != nullptr)
+            {
+                MEMORY_BASIC_INFORMATION info;
+                if (VirtualQuery(m_address, &info, sizeof(info)) != 0)
+                {
+                    m_size = info.RegionSize;
+                    ret = true;
+                }
+            }
+        }
+        if (!ret)
+        {
+            close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Close the shared memory segment, a created segment is removed */
+bool SharedMemory::close()
+{
+    bool ret = false;
+
+    if (m_mapping != nullptr)
+    {
+        if (m_address != nullptr)
+        {
+            UnmapViewOfFile(m_address);
+            m_address = nullptr;
+            m_size = 0;
+        }
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+        m_created_name.clear();
+        ret = true;
+    }
+
+    return ret;
+}
@@ -0,0 +1,78 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHAREDMEMORY_H
+#define SHAREDMEMORY_H
+
+#include "NoCopy.h"
+
+#include <string>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <Windows.h>
+#undef NOMINMAX
+
+
+/** \brief Named shared memory segment which can be mapped by several processes */
+class SharedMemory : public INoCopy
+{
+    public:
+
+        /** \brief Constructor */
+        SharedMemory();
+        /** \brief Destructor */
+        virtual ~SharedMemory();
+
+
+        /** \brief Create a shared memory segment mapped in read-write mode, an existing segment with the same name is replaced */
+        bool create(const std::string& name, const size_t size);
+
+        /** \brief Open an existing shared memory segment mapped in read-only mode */
+        bool open(const std::string& name);
+
+        /** \brief Close the shared memory segment, a created segment is removed */
+        bool close();
+
+
+        /** \brief Get the address of the mapped segment (nullptr if the segment is not opened) */
+        void* getAddress() const { return m_address; }
+
+        /** \brief Get the size in bytes of the mapped segment */
+        size_t getSize() const { return m_size; }
+
+
+    private:
+
+        /** \brief Handle of the file mapping */
+        HANDLE m_mapping;
+
+        /** \brief Address of the mapped segment */
+        void* m_address;
+
+        /** \brief Size of the mapped segment */
+        size_t m_size;
+
+        /** \brief Name of the created segment (empty if the segment has been opened) */
+        std::string m_created_name;
+};
+
+
+#endif // SHAREDMEMORY_H
@@ -30,7 +30,11 @@ CanPipeline::CanPipeline(const std::string& name)
 , m_rx_thread(nullptr)
 , m_rx_mailbox()
 , m_suspender()
-{}
+, m_filters_mutex()
+, m_filters_pushed_down(false)
+{
+    m_suspender.setAcceptanceFiltersListener(this);
+}
 
 /** \brief Destructor */
 CanPipeline::~CanPipeline()
@@ -46,13 +50,20 @@ bool CanPipeline::start(CanController& controller)
     {
         m_rx_mailbox.clear();
         m_controller = &controller;
-        ret = m_controller->start(*this);
+        {
+            const lock_guard<mutex> lock(m_filters_mutex);
+            m_filters_pushed_down = pushDownFilters();
+            ret = m_filters_pushed_down;
+        }
+        ret = ret && m_controller->start(*this);
         if (ret)
         {
             m_rx_thread = new thread(&CanPipeline::rxThread, this);
         }
         else
         {
+            const lock_guard<mutex> lock(m_filters_mutex);
+            m_filters_pushed_down = false;
             m_last_error = m_controller->getErrorMsg();
         }
     }
@@ -119,6 +130,10 @@ bool CanPipeline::stop()
 
     if (m_rx_thread != nullptr)
     {
+        {
+            const lock_guard<mutex> lock(m_filters_mutex);
+            m_filters_pushed_down = false;
+        }
         ret = m_controller->stop();
         if (!ret)
         {
@@ -178,6 +193,41 @@ void CanPipeline::canDataReceived(const CanData& can_data)
     m_rx_mailbox.post(can_data);
 }
 
+/** \brief Called when the acceptance filters of the pipeline stages have changed */
+void CanPipeline::acceptanceFiltersChanged()
+{
+    const lock_guard<mutex> lock(m_filters_mutex);
+    if (m_filters_pushed_down)
+    {
+        // If the new filters can't be pushed down, accept all the messages
+        // so that the stages still receive the messages they need
+        if (!pushDownFilters())
+        {
+            m_controller->setFilters(vector<CanAdapterFilter>());
+        }
+    }
+}
+
+/** \brief Push down the acceptance filters of the pipeline stages to the CAN controller */
+bool CanPipeline::pushDownFilters()
+{
+    bool ret = true;
+
+    if (m_controller->supportsFilters())
+    {
+        // Accept all the messages if at least one stage needs all of them
+        // or if there are too many filters to be efficient
+        vector<CanAdapterFilter> filters;
+        if (!m_suspender.getAcceptanceFilters(filters) || (filters.size() > MAX_PUSHED_DOWN_FILTERS))
+        {
+            filters.clear();
+        }
+        ret = m_controller->setFilters(filters);
+    }
+
+    return ret;
+}
+
 /** \brief Rx thread */
 void CanPipeline::rxThread()
 {
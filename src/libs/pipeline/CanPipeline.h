@@ -22,18 +22,20 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "ICanControllerListener.h"
+#include "ICanAcceptanceFiltersListener.h"
 #include "NoCopy.h"
 #include "MailBox.h"
 #include "CanPipelineSuspender.h"
 
 #include <string>
 #include <thread>
+#include <mutex>
 
 class CanController;
 class CanPipelineSuspender;
 
 /** \brief CAN message processing pipeline */
-class CanPipeline : public ICanControllerListener, public INoCopy
+class CanPipeline : public ICanControllerListener, public ICanAcceptanceFiltersListener, public INoCopy
 {
     public:
 
@@ -44,7 +46,9 @@ class CanPipeline : public ICanControllerListener, public INoCopy
         virtual ~CanPipeline();
 
 
-        /** \brief Start the pipeline with the specified CAN controller */
+        /** \brief Start the pipeline with the specified CAN controller, the acceptance filters of the
+                   pipeline stages are pushed down to the controller if it supports it and pushed again
+                   each time they change while the pipeline is started */
         bool start(CanController& controller);
 
         /** \brief Suspend the pipeline processing */
@@ -75,9 +79,16 @@ class CanPipeline : public ICanControllerListener, public INoCopy
         /** \brief Called when CAN data has been received on the controller */
         virtual void canDataReceived(const CanData& can_data) override;
 
+        /** \brief Called when the acceptance filters of the pipeline stages have changed */
+        virtual void acceptanceFiltersChanged() override;
+
 
     private:
 
+        /** \brief Maximum number of acceptance filters pushed down to the CAN controller */
+        static const size_t MAX_PUSHED_DOWN_FILTERS = 64u;
+
+
         /** \brief Name */
         const std::string& m_name;
 
@@ -96,6 +107,15 @@ class CanPipeline : public ICanControllerListener, public INoCopy
         /** \brief Pipeline suspender */
         CanPipelineSuspender m_suspender;
 
+        /** \brief Mutex to serialize the push downs of the acceptance filters */
+        std::mutex m_filters_mutex;
+
+        /** \brief Indicate if the acceptance filters must be pushed down to the CAN controller when they change */
+        bool m_filters_pushed_down;
+
+
+        /** \brief Push down the acceptance filters of the pipeline stages to the CAN controller */
+        bool pushDownFilters();
 
         /** \brief Rx thread */
         void rxThread();
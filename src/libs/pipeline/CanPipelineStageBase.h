@@ -26,7 +26,7 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include <unordered_set>
 
 /** \brief Base class for CAN message pipeline stages implementations */
-class CanPipelineStageBase : public ICanPipelineStage, public INoCopy
+class CanPipelineStageBase : public ICanPipelineStage, public ICanAcceptanceFiltersListener, public INoCopy
 {
     public:
 
@@ -36,6 +36,7 @@ class CanPipelineStageBase : public ICanPipelineStage, public INoCopy
         , m_name("")
         , m_is_enabled(true)
         , m_childs()
+        , m_filters_listener(nullptr)
         {}
 
         /** \brief Destructor */
@@ -50,10 +51,10 @@ class CanPipelineStageBase : public ICanPipelineStage, public INoCopy
         virtual void setName(const std::string& name) override { m_name = name; }
 
         /** \brief Enable the stage */
-        virtual void enable() { m_is_enabled = true; }
+        virtual void enable() { m_is_enabled = true; notifyAcceptanceFiltersChanged(); }
 
         /** \brief Disable the stage */
-        virtual void disable() { m_is_enabled = false; }
+        virtual void disable() { m_is_enabled = false; notifyAcceptanceFiltersChanged(); }
 
         /** \brief Retrieve stage's state */
         virtual bool isEnabled() const override { return m_is_enabled; }
@@ -62,10 +63,35 @@ class CanPipelineStageBase : public ICanPipelineStage, public INoCopy
         virtual bool isOutputStage() const override { return m_is_output_stage; }
 
         /** \brief Add a child pipeline stage */
-        virtual void addChild(ICanPipelineStage& child) { m_childs.insert(&child); }
+        virtual void addChild(ICanPipelineStage& child)
+        {
+            m_childs.insert(&child);
+            child.setAcceptanceFiltersListener(this);
+            notifyAcceptanceFiltersChanged();
+        }
 
         /** \brief Remove a child pipeline stage */
-        virtual void removeChild(ICanPipelineStage& child) { m_childs.erase(&child); }
+        virtual void removeChild(ICanPipelineStage& child)
+        {
+            if (m_childs.erase(&child) != 0)
+            {
+                child.setAcceptanceFiltersListener(nullptr);
+                notifyAcceptanceFiltersChanged();
+            }
+        }
+
+
+        /** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list,
+                   return false if the stage needs all the CAN messages */
+        virtual bool getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const { (void)filters; return false; }
+
+        /** \brief Set the listener to notify when the acceptance filters of the stage or of its childs change
+                   (nullptr to remove the listener) */
+        virtual void setAcceptanceFiltersListener(ICanAcceptanceFiltersListener* listener) override { m_filters_listener = listener; }
+
+
+        /** \brief Called when the acceptance filters of a child have changed */
+        virtual void acceptanceFiltersChanged() override { notifyAcceptanceFiltersChanged(); }
 
 
 
@@ -90,6 +116,29 @@ class CanPipelineStageBase : public ICanPipelineStage, public INoCopy
         virtual bool processCanData(const CanData& can_data) = 0;
 
 
+        /** \brief Append the union of the acceptance filters of the childs to the list,
+                   return false if at least one child needs all the CAN messages */
+        bool getChildsAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const
+        {
+            bool ret = !m_childs.empty();
+            for (auto iter = m_childs.begin(); ret && (iter != m_childs.end()); ++iter)
+            {
+                ret = (*iter)->getAcceptanceFilters(filters);
+            }
+            return ret;
+        }
+
+
+        /** \brief Notify the listener that the acceptance filters of the stage have changed */
+        void notifyAcceptanceFiltersChanged()
+        {
+            if (m_filters_listener != nullptr)
+            {
+                m_filters_listener->acceptanceFiltersChanged();
+            }
+        }
+
+
         /** \brief Dispatch CAN data to the childs */
         void dispatchCanData(const CanData& can_data)
         {
@@ -113,6 +162,9 @@ class CanPipelineStageBase : public ICanPipelineStage, public INoCopy
 
         /** \brief List of childs */
         std::unordered_set<ICanPipelineStage*> m_childs;
+
+        /** \brief Listener of the changes of the acceptance filters */
+        ICanAcceptanceFiltersListener* m_filters_listener;
 };
 
 
@@ -52,6 +52,11 @@ class CanPipelineSuspender : public CanPipelineStageBase
         bool isSuspended() const { return m_is_suspended; }
 
 
+        /** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list,
+                   return false if the stage needs all the CAN messages */
+        virtual bool getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const override { return getChildsAcceptanceFilters(filters); }
+
+
     protected:
 
         /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
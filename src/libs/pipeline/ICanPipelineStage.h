@@ -21,8 +21,11 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define ICANPIPELINESTAGE_H
 
 #include "ICanControllerListener.h"
+#include "ICanAcceptanceFiltersListener.h"
+#include "CanAdapterControllerApi.h"
 
 #include <string>
+#include <vector>
 
 /** \brief Interface for CAN message pipeline stages implementations */
 class ICanPipelineStage : public ICanControllerListener
@@ -59,6 +62,14 @@ class ICanPipelineStage : public ICanControllerListener
         virtual void removeChild(ICanPipelineStage& child) = 0;
 
 
+        /** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list,
+                   return false if the stage needs all the CAN messages */
+        virtual bool getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const = 0;
+
+        /** \brief Set the listener to notify when the acceptance filters of the stage or of its childs change
+                   (nullptr to remove the listener) */
+        virtual void setAcceptanceFiltersListener(ICanAcceptanceFiltersListener* listener) = 0;
+
 };
 
 
@@ -0,0 +1,637 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BinaryFileCanMsgDatabase.h"
+#include "MappedFile.h"
+
+#include "CanMsgDesc.h"
+#include "CanMsgSignal.h"
+#include "BooleanCanMsgValue.h"
+#include "IntegerCanMsgValue.h"
+#include "FloatCanMsgValue.h"
+
+#include "EnumCanMsgValueConverter.h"
+#include "FunctionCanMsgValueConverter.h"
+#include "LinearCanMsgValueConverter.h"
+#include "MathExpressionParser.h"
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+using namespace std;
+
+
+/** \brief Initial value of the FNV-1a hash */
+static const uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+
+/** \brief Prime of the FNV-1a hash */
+static const uint64_t FNV_PRIME = 0x100000001B3ull;
+
+
+/** \brief Compute the FNV-1a hash of a buffer */
+static uint64_t computeHash(const char* data, const size_t size)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = ((hash ^ static_cast<uint8_t>(data[i])) * FNV_PRIME);
+    }
+    return hash;
+}
+
+/** \brief Align an offset on the alignment of the image tables */
+static uint64_t alignOffset(const uint64_t offset)
+{
+    return ((offset + DATABASE_IMAGE_ALIGNMENT - 1u) & ~static_cast<uint64_t>(DATABASE_IMAGE_ALIGNMENT - 1u));
+}
+
+/** \brief Intern a string in the strings of an image */
+static DatabaseImageString internString(const std::string& str, std::string& strings, std::unordered_map<std::string, uint32_t>& interned_strings)
+{
+    auto iter = interned_strings.find(str);
+    if (iter == interned_strings.end())
+    {
+        iter = interned_strings.emplace(str, static_cast<uint32_t>(strings.size())).first;
+        strings.append(str);
+    }
+    DatabaseImageString image_string;
+    image_string.offset = iter->second;
+    image_string.length = static_cast<uint32_t>(str.size());
+    return image_string;
+}
+
+/** \brief Append an entry to a table of an image unless an identical entry range is already present, return the index of the entries */
+template <typename T>
+static uint32_t internEntries(const T* entries, const size_t count, std::vector<T>& table, std::unordered_map<std::string, uint32_t>& interned_entries)
+{
+    // The entries are compared byte-wise, their padding bytes must have been zeroed
+    const string key(reinterpret_cast<const char*>(entries), count * sizeof(T));
+    auto iter = interned_entries.find(key);
+    if (iter == interned_entries.end())
+    {
+        iter = interned_entries.emplace(key, static_cast<uint32_t>(table.size())).first;
+        table.insert(table.end(), entries, entries + count);
+    }
+    return iter->second;
+}
+
+/** \brief Copy a table at its offset in an image */
+template <typename T>
+static void copyTable(const std::vector<T>& table, const uint64_t offset, std::vector<char>& image)
+{
+    if (!table.empty())
+    {
+        memcpy(&image[static_cast<size_t>(offset)], table.data(), table.size() * sizeof(T));
+    }
+}
+
+
+/** \brief Constructor */
+BinaryFileCanMsgDatabase::BinaryFileCanMsgDatabase()
+: m_storage()
+, m_last_error("")
+, m_can_msgs()
+, m_name_index()
+, m_header()
+, m_image(nullptr)
+, m_converters()
+{}
+
+/** \brief Destructor */
+BinaryFileCanMsgDatabase::~BinaryFileCanMsgDatabase()
+{}
+
+
+/** \brief Save a loaded message database as a binary image file */
+bool BinaryFileCanMsgDatabase::save(const ICanMsgDatabase& can_msg_database, const std::string& bin_file, const uint64_t source_hash)
+{
+    // The image is built from the list of CAN messages which stays empty when they are built on demand
+    bool ret = !can_msg_database.isLazy();
+    if (!ret)
+    {
+        m_last_error = "A database which builds its CAN messages on demand can't be saved";
+    }
+
+    // Flatten the messages into tables
+    vector<DatabaseImageMessage> messages;
+    vector<DatabaseImageValue> values;
+    vector<DatabaseImageSignal> msg_signals;
+    vector<DatabaseImageConverter> converters;
+    vector<DatabaseImageEnumEntry> enum_entries;
+    string strings;
+    unordered_map<string, uint32_t> interned_strings;
+    unordered_map<string, uint32_t> interned_converters;
+    unordered_map<string, uint32_t> interned_enum_entries;
+    vector<DatabaseImageEnumEntry> converter_enum_entries;
+    const auto& can_msgs = can_msg_database.getCanMsgs();
+    for (auto iter = can_msgs.begin(); ret && (iter != can_msgs.end()); ++iter)
+    {
+        const CanMsgDesc& can_msg = *(iter->second);
+        DatabaseImageMessage image_msg;
+        memset(&image_msg, 0, sizeof(image_msg));
+        image_msg.key = iter->first;
+        image_msg.id = can_msg.getId();
+        image_msg.name = internString(can_msg.getName(), strings, interned_strings);
+        image_msg.extended = (can_msg.isExtented() ? 1u : 0u);
+
+        // Values
+        const auto& msg_values = can_msg.getValues();
+        image_msg.first_value = static_cast<uint32_t>(values.size());
+        image_msg.value_count = static_cast<uint32_t>(msg_values.size());
+        for (size_t i = 0; i < msg_values.size(); i++)
+        {
+            const ICanMsgValue& can_value = *(msg_values[i]);
+            DatabaseImageValue image_value;
+            memset(&image_value, 0, sizeof(image_value));
+            image_value.type = static_cast<uint8_t>(can_value.getType());
+            image_value.byte_order = static_cast<uint8_t>(can_value.getByteOrder());
+            image_value.byte_position = can_value.getBytePosition();
+            image_value.bit_position = can_value.getBitPosition();
+            image_value.size_in_bits = can_value.getSizeInBits();
+            if (&can_value == can_msg.getMultiplexer())
+            {
+                image_value.kind = DATABASE_IMAGE_MULTIPLEXER;
+            }
+            else if (can_msg.getValueMultiplexerValue(i, image_value.multiplexer_value))
+            {
+                image_value.kind = DATABASE_IMAGE_MULTIPLEXED;
+            }
+            else
+            {
+                image_value.kind = DATABASE_IMAGE_VALUE;
+            }
+            values.push_back(image_value);
+        }
+
+        // Signals
+        const auto& can_signals = can_msg.getSignals();
+        image_msg.first_signal = static_cast<uint32_t>(msg_signals.size());
+        image_msg.signal_count = static_cast<uint32_t>(can_signals.size());
+        for (size_t i = 0; ret && (i < can_signals.size()); i++)
+        {
+            const CanMsgSignal& can_signal = *(can_signals[i]);
+            DatabaseImageSignal image_signal;
+            image_signal.name = internString(can_signal.getName(), strings, interned_strings);
+            image_signal.unit = internString(can_signal.getUnit(), strings, interned_strings);
+            image_signal.value_index = static_cast<uint32_t>(can_msg.getSignalValueIndex(i));
+            image_signal.converter_index = DATABASE_IMAGE_NO_CONVERTER;
+
+            const ICanMsgValueConverter* converter = can_signal.getConverter();
+            if (converter != nullptr)
+            {
+                DatabaseImageConverter image_converter;
+                memset(&image_converter, 0, sizeof(image_converter));
+                image_converter.name = internString(converter->getName(), strings, interned_strings);
+                image_converter.type = internString(converter->getType(), strings, interned_strings);
+
+                const EnumCanMsgValueConverter* enum_converter = dynamic_cast<const EnumCanMsgValueConverter*>(converter);
+                const LinearCanMsgValueConverter* linear_converter = dynamic_cast<const LinearCanMsgValueConverter*>(converter);
+                const FunctionCanMsgValueConverter* function_converter = dynamic_cast<const FunctionCanMsgValueConverter*>(converter);
+                if (enum_converter != nullptr)
+                {
+                    converter_enum_entries.resize(enum_converter->getEntryCount());
+                    for (size_t j = 0; j < converter_enum_entries.size(); j++)
+                    {
+                        string_view label;
+                        converter_enum_entries[j].value = enum_converter->getEntry(j, label);
+                        converter_enum_entries[j].label = internString(string(label), strings, interned_strings);
+                    }
+                    image_converter.kind = DATABASE_IMAGE_ENUM_CONVERTER;
+                    image_converter.first_enum_entry = internEntries(converter_enum_entries.data(), converter_enum_entries.size(), enum_entries, interned_enum_entries);
+                    image_converter.enum_entry_count = static_cast<uint32_t>(converter_enum_entries.size());
+                }
+                else if (linear_converter != nullptr)
+                {
+                    image_converter.kind = DATABASE_IMAGE_LINEAR_CONVERTER;
+                    image_converter.factor = linear_converter->getFactor();
+                    image_converter.offset = linear_converter->getOffset();
+                    image_converter.min = linear_converter->getMin();
+                    image_converter.max = linear_converter->getMax();
+                }
+                else if (function_converter != nullptr)
+                {
+                    image_converter.kind = DATABASE_IMAGE_FUNCTION_CONVERTER;
+                    image_converter.function = internString(function_converter->getTransferFunction(), strings, interned_strings);
+                }
+                else
+                {
+                    ret = false;
+                    m_last_error = "Unsupported CAN values converter for the signal " + can_signal.getName();
+                }
+
+                // Signals using the same converter share its description
+                image_signal.converter_index = internEntries(&image_converter, 1u, converters, interned_converters);
+            }
+            msg_signals.push_back(image_signal);
+        }
+        messages.push_back(image_msg);
+    }
+
+    if (ret)
+    {
+        // Layout
+        DatabaseImageHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = DATABASE_IMAGE_MAGIC;
+        header.version = DATABASE_IMAGE_VERSION;
+        header.source_hash = source_hash;
+        header.message_count = static_cast<uint32_t>(messages.size());
+        header.value_count = static_cast<uint32_t>(values.size());
+        header.signal_count = static_cast<uint32_t>(msg_signals.size());
+        header.converter_count = static_cast<uint32_t>(converters.size());
+        header.enum_entry_count = static_cast<uint32_t>(enum_entries.size());
+        header.strings_size = static_cast<uint32_t>(strings.size());
+        header.messages_offset = alignOffset(sizeof(DatabaseImageHeader));
+        header.values_offset = alignOffset(header.messages_offset + messages.size() * sizeof(DatabaseImageMessage));
+        header.signals_offset = alignOffset(header.values_offset + values.size() * sizeof(DatabaseImageValue));
+        header.converters_offset = alignOffset(header.signals_offset + msg_signals.size() * sizeof(DatabaseImageSignal));
+        header.enum_entries_offset = alignOffset(header.converters_offset + converters.size() * sizeof(DatabaseImageConverter));
+        header.strings_offset = alignOffset(header.enum_entries_offset + enum_entries.size() * sizeof(DatabaseImageEnumEntry));
+        header.size = header.strings_offset + strings.size();
+
+        // Image
+        vector<char> image(static_cast<size_t>(header.size), 0);
+        copyTable(messages, header.messages_offset, image);
+        copyTable(values, header.values_offset, image);
+        copyTable(msg_signals, header.signals_offset, image);
+        copyTable(converters, header.converters_offset, image);
+        copyTable(enum_entries, header.enum_entries_offset, image);
+        memcpy(&image[static_cast<size_t>(header.strings_offset)], strings.data(), strings.size());
+        header.image_hash = computeHash(&image[sizeof(DatabaseImageHeader)], image.size() - sizeof(DatabaseImageHeader));
+        memcpy(&image[0], &header, sizeof(header));
+
+        // Write file
+        ofstream file(bin_file, ios::binary | ios::trunc);
+        file.write(image.data(), static_cast<streamsize>(image.size()));
+        ret = file.good();
+        if (!ret)
+        {
+            m_last_error = "Unable to write the database image file";
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Load the message database from a binary image file, return false if the image is invalid
+           or if it has been built from another content of the source file */
+bool BinaryFileCanMsgDatabase::load(const std::string& bin_file, const uint64_t source_hash)
+{
+    bool ret = false;
+
+    MappedFile file;
+    if (file.open(bin_file))
+    {
+        m_image = file.getData();
+        ret = checkImage(file.getSize(), source_hash);
+        if (ret)
+        {
+            m_converters.resize(m_header.converter_count);
+            const DatabaseImageMessage* image_msgs = reinterpret_cast<const DatabaseImageMessage*>(m_image + m_header.messages_offset);
+            for (uint32_t i = 0; ret && (i < m_header.message_count); i++)
+            {
+                ret = buildMessage(image_msgs[i]);
+            }
+            if (!ret)
+            {
+                m_can_msgs.clear();
+            }
+        }
+        m_storage.forgetConverters();
+        m_converters.clear();
+        m_image = nullptr;
+    }
+    else
+    {
+        m_last_error = "Unable to open the database image file";
+    }
+
+    // Index the names of the CAN messages and signals
+    if (ret)
+    {
+        ret = m_name_index.build(*this);
+        if (!ret)
+        {
+            m_last_error = "Unable to build the index of the names";
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Compute the content hash of a database source file */
+bool BinaryFileCanMsgDatabase::computeFileHash(const std::string& file, uint64_t& hash)
+{
+    MappedFile mapped_file;
+    const bool ret = mapped_file.open(file);
+    if (ret)
+    {
+        hash = computeHash(mapped_file.getData(), mapped_file.getSize());
+    }
+    return ret;
+}
+
+/** \brief Check the header and the tables bounds of an image */
+bool BinaryFileCanMsgDatabase::checkImage(const size_t size, const uint64_t source_hash)
+{
+    bool ret = false;
+
+    if (size >= sizeof(DatabaseImageHeader))
+    {
+        memcpy(&m_header, m_image, sizeof(m_header));
+        if ((m_header.magic != DATABASE_IMAGE_MAGIC) || (m_header.version != DATABASE_IMAGE_VERSION))
+        {
+            m_last_error = "Invalid database image or incompatible database image version";
+        }
+        else if (m_header.source_hash != source_hash)
+        {
+            m_last_error = "The database image has been built from another content of the database file";
+        }
+        else if ((m_header.size != size) ||
+                 !checkTable(m_header.messages_offset, m_header.message_count, sizeof(DatabaseImageMessage)) ||
+                 !checkTable(m_header.values_offset, m_header.value_count, sizeof(DatabaseImageValue)) ||
+                 !checkTable(m_header.signals_offset, m_header.signal_count, sizeof(DatabaseImageSignal)) ||
+                 !checkTable(m_header.converters_offset, m_header.converter_count, sizeof(DatabaseImageConverter)) ||
+                 !checkTable(m_header.enum_entries_offset, m_header.enum_entry_count, sizeof(DatabaseImageEnumEntry)) ||
+                 !checkTable(m_header.strings_offset, m_header.strings_size, sizeof(char)) ||
+                 (computeHash(m_image + sizeof(DatabaseImageHeader), size - sizeof(DatabaseImageHeader)) != m_header.image_hash))
+        {
+            m_last_error = "Corrupted database image";
+        }
+        else
+        {
+            ret = true;
+        }
+    }
+    else
+    {
+        m_last_error = "Invalid database image";
+    }
+
+    return ret;
+}
+
+/** \brief Check if a table is inside the image */
+bool BinaryFileCanMsgDatabase::checkTable(const uint64_t offset, const uint32_t count, const size_t entry_size) const
+{
+    return (((offset % DATABASE_IMAGE_ALIGNMENT) == 0) && (offset >= sizeof(DatabaseImageHeader)) && (offset <= m_header.size) &&
+            ((static_cast<uint64_t>(count) * entry_size) <= (m_header.size - offset)));
+}
+
+/** \brief Get a string of the image, return false if the string is outside the image */
+bool BinaryFileCanMsgDatabase::getString(const DatabaseImageString& image_string, std::string& str) const
+{
+    const bool ret = ((image_string.offset <= m_header.strings_size) && (image_string.length <= (m_header.strings_size - image_string.offset)));
+    if (ret)
+    {
+        str.assign(m_image + m_header.strings_offset + image_string.offset, image_string.length);
+    }
+    return ret;
+}
+
+/** \brief Create the CAN message description of a message of the image */
+bool BinaryFileCanMsgDatabase::buildMessage(const DatabaseImageMessage& image_msg)
+{
+    string name;
+    bool ret = (getString(image_msg.name, name) &&
+                (image_msg.first_value <= m_header.value_count) && (image_msg.value_count <= (m_header.value_count - image_msg.first_value)) &&
+                (image_msg.first_signal <= m_header.signal_count) && (image_msg.signal_count <= (m_header.signal_count - image_msg.first_signal)));
+    if (ret)
+    {
+        auto can_msg = m_storage.create<CanMsgDesc>(image_msg.id, name, (image_msg.extended != 0));
+
+        // Values, they are stored in the order they have been added to the message
+        const DatabaseImageValue* image_values = reinterpret_cast<const DatabaseImageValue*>(m_image + m_header.values_offset) + image_msg.first_value;
+        vector<shared_ptr<ICanMsgValue>> values(image_msg.value_count);
+        for (uint32_t i = 0; ret && (i < image_msg.value_count); i++)
+        {
+            const DatabaseImageValue& image_value = image_values[i];
+            ret = buildValue(image_value, values[i]);
+            if (ret)
+            {
+                switch (image_value.kind)
+                {
+                    case DATABASE_IMAGE_MULTIPLEXER:
+                    {
+                        ret = can_msg->addMultiplexerValue(values[i]);
+                        break;
+                    }
+
+                    case DATABASE_IMAGE_MULTIPLEXED:
+                    {
+                        ret = can_msg->addMultiplexedValue(values[i], image_value.multiplexer_value);
+                        break;
+                    }
+
+                    case DATABASE_IMAGE_VALUE:
+                    {
+                        ret = can_msg->addValue(values[i]);
+                        break;
+                    }
+
+                    default:
+                    {
+                        ret = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Signals
+        const DatabaseImageSignal* image_signals = reinterpret_cast<const DatabaseImageSignal*>(m_image + m_header.signals_offset) + image_msg.first_signal;
+        const DatabaseImageConverter* image_converters = reinterpret_cast<const DatabaseImageConverter*>(m_image + m_header.converters_offset);
+        for (uint32_t i = 0; ret && (i < image_msg.signal_count); i++)
+        {
+            const DatabaseImageSignal& image_signal = image_signals[i];
+            string signal_name;
+            string unit;
+            ret = (getString(image_signal.name, signal_name) && getString(image_signal.unit, unit) && (image_signal.value_index < image_msg.value_count));
+            if (ret)
+            {
+                auto signal = m_storage.create<CanMsgSignal>();
+                signal->setName(m_storage.intern(signal_name));
+                signal->setUnit(m_storage.intern(unit));
+                ret = signal->setValue(*values[image_signal.value_index]);
+                if (ret && (image_signal.converter_index != DATABASE_IMAGE_NO_CONVERTER))
+                {
+                    // Each converter is built once, the signals with the same value type share its copy
+                    const uint32_t converter_index = image_signal.converter_index;
+                    ret = (converter_index < m_header.converter_count);
+                    if (ret && !m_converters[converter_index])
+                    {
+                        ret = buildConverter(image_converters[converter_index], m_converters[converter_index]);
+                    }
+                    if (ret)
+                    {
+                        ICanMsgValueConverter* converter = m_storage.shareConverter(*m_converters[converter_index], *values[image_signal.value_index]);
+                        ret = (converter != nullptr);
+                        if (ret)
+                        {
+                            signal->setSharedConverter(*converter);
+                        }
+                    }
+                }
+                if (ret)
+                {
+                    can_msg->addSignal(signal);
+                }
+            }
+        }
+
+        // Add message to the list
+        if (ret)
+        {
+            m_can_msgs[image_msg.key] = can_msg;
+        }
+    }
+    if (!ret)
+    {
+        m_last_error = "Invalid CAN message in the database image : " + name;
+    }
+
+    return ret;
+}
+
+/** \brief Create the CAN message value of a value of the image */
+bool BinaryFileCanMsgDatabase::buildValue(const DatabaseImageValue& image_value, std::shared_ptr<ICanMsgValue>& value)
+{
+    bool ret = true;
+
+    shared_ptr<ICanMsgValue> can_value;
+    switch (image_value.type)
+    {
+        case CANMSGVALUE_BOOL:
+        {
+            can_value = m_storage.create<BooleanCanMsgValue>();
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        case CANMSGVALUE_INT:
+        {
+            auto int_value = m_storage.create<IntegerCanMsgValue>();
+            int_value->setSignedness(image_value.type == CANMSGVALUE_INT);
+            ret = int_value->setSizeInBits(image_value.size_in_bits);
+            can_value = int_value;
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        case CANMSGVALUE_DOUBLE:
+        {
+            auto float_value = m_storage.create<FloatCanMsgValue>();
+            float_value->setPrecision(image_value.type == CANMSGVALUE_FLOAT);
+            can_value = float_value;
+            break;
+        }
+
+        default:
+        {
+            ret = false;
+            break;
+        }
+    }
+    if (ret)
+    {
+        // The positions are checked against the byte order
+        value = can_value;
+        ret = (image_value.byte_order <= CANMSG_BIG_ENDIAN);
+        if (ret)
+        {
+            can_value->setByteOrder(static_cast<CanMsgByteOrder>(image_value.byte_order));
+            ret = (can_value->setBitPosition(image_value.bit_position) && can_value->setBytePosition(image_value.byte_position));
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Create the converter of a converter of the image */
+bool BinaryFileCanMsgDatabase::buildConverter(const DatabaseImageConverter& image_converter, std::shared_ptr<ICanMsgValueConverter>& converter)
+{
+    string name;
+    string type;
+    bool ret = (getString(image_converter.name, name) && getString(image_converter.type, type));
+    if (ret)
+    {
+        switch (image_converter.kind)
+        {
+            case DATABASE_IMAGE_ENUM_CONVERTER:
+            {
+                ret = ((image_converter.first_enum_entry <= m_header.enum_entry_count) &&
+                       (image_converter.enum_entry_count <= (m_header.enum_entry_count - image_converter.first_enum_entry)));
+                if (ret)
+                {
+                    const DatabaseImageEnumEntry* image_entries = reinterpret_cast<const DatabaseImageEnumEntry*>(m_image + m_header.enum_entries_offset) + image_converter.first_enum_entry;
+                    EnumCanMsgValueConverter* enum_converter = new EnumCanMsgValueConverter(name, type);
+                    converter = shared_ptr<ICanMsgValueConverter>(enum_converter);
+                    for (uint32_t i = 0; ret && (i < image_converter.enum_entry_count); i++)
+                    {
+                        string label;
+                        ret = getString(image_entries[i].label, label);
+                        if (ret)
+                        {
+                            enum_converter->addValue(image_entries[i].value, label);
+                        }
+                    }
+                }
+                break;
+            }
+
+            case DATABASE_IMAGE_LINEAR_CONVERTER:
+            {
+                LinearCanMsgValueConverter* linear_converter = new LinearCanMsgValueConverter(name, type);
+                linear_converter->setCoefficients(image_converter.factor, image_converter.offset);
+                linear_converter->setBounds(image_converter.min, image_converter.max);
+                converter = shared_ptr<ICanMsgValueConverter>(linear_converter);
+                break;
+            }
+
+            case DATABASE_IMAGE_FUNCTION_CONVERTER:
+            {
+                // The expression trees can't be stored in the image, the transfer function is parsed again
+                string function;
+                ret = getString(image_converter.function, function);
+                if (ret)
+                {
+                    MathExpressionParser math_parser;
+                    unique_ptr<IMathExpression> math_expr;
+                    ret = math_parser.parse(function, math_expr);
+                    if (ret)
+                    {
+                        FunctionCanMsgValueConverter* function_converter = new FunctionCanMsgValueConverter(name, type);
+                        function_converter->setTransferFunction(function, math_expr);
+                        converter = shared_ptr<ICanMsgValueConverter>(function_converter);
+                    }
+                }
+                break;
+            }
+
+            default:
+            {
+                ret = false;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
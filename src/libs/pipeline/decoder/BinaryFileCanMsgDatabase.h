@@ -0,0 +1,117 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BINARYFILECANMSGDATABASE_H
+#define BINARYFILECANMSGDATABASE_H
+
+#include "ICanMsgDatabase.h"
+#include "ICanMsgValueConverter.h"
+#include "CanMsgDatabaseImageLayout.h"
+#include "CanMsgDatabaseStorage.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+
+/** \brief CAN message database stored in a binary image file, the image is a cache of a loaded database
+           which is keyed by the content hash of the database source file so that a stale image is rejected
+           at load time. The image is memory-mapped and validated before the messages are built from its tables,
+           no parsing of the source file is needed */
+class BinaryFileCanMsgDatabase : public ICanMsgDatabase
+{
+    public:
+
+        /** \brief Constructor */
+        BinaryFileCanMsgDatabase();
+
+        /** \brief Destructor */
+        virtual ~BinaryFileCanMsgDatabase();
+
+
+        /** \brief Save a loaded message database as a binary image file, a database which builds its CAN messages
+                   on demand can't be saved */
+        bool save(const ICanMsgDatabase& can_msg_database, const std::string& bin_file, const uint64_t source_hash);
+
+        /** \brief Load the message database from a binary image file, return false if the image is invalid
+                   or if it has been built from another content of the source file */
+        bool load(const std::string& bin_file, const uint64_t source_hash);
+
+
+        /** \brief Get the list of CAN messages */
+        virtual const std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& getCanMsgs() const override { return m_can_msgs; }
+
+        /** \brief Get the index of the names of the CAN messages and signals */
+        virtual const CanMsgNameIndex& getNameIndex() const override { return m_name_index; }
+
+
+        /** \brief Get the last error string */
+        const std::string& getLastError() { return m_last_error; }
+
+
+        /** \brief Compute the content hash of a database source file */
+        static bool computeFileHash(const std::string& file, uint64_t& hash);
+
+
+    private:
+
+        /** \brief Storage of the CAN messages, values, signals and shared converters, declared first so that it outlives their references */
+        CanMsgDatabaseStorage m_storage;
+
+        /** \brief Get the last error string */
+        std::string m_last_error;
+
+        /** \brief List of CAN messages */
+        std::map<uint32_t, std::shared_ptr<CanMsgDesc>> m_can_msgs;
+
+        /** \brief Index of the names of the CAN messages and signals */
+        CanMsgNameIndex m_name_index;
+
+
+        /** \brief Header of the image being loaded */
+        DatabaseImageHeader m_header;
+
+        /** \brief Image being loaded */
+        const char* m_image;
+
+        /** \brief Converters of the image being loaded, built on first use */
+        std::vector<std::shared_ptr<ICanMsgValueConverter>> m_converters;
+
+
+        /** \brief Check the header and the tables bounds of an image */
+        bool checkImage(const size_t size, const uint64_t source_hash);
+
+        /** \brief Check if a table is inside the image */
+        bool checkTable(const uint64_t offset, const uint32_t count, const size_t entry_size) const;
+
+        /** \brief Get a string of the image, return false if the string is outside the image */
+        bool getString(const DatabaseImageString& image_string, std::string& str) const;
+
+        /** \brief Create the CAN message description of a message of the image */
+        bool buildMessage(const DatabaseImageMessage& image_msg);
+
+        /** \brief Create the CAN message value of a value of the image */
+        bool buildValue(const DatabaseImageValue& image_value, std::shared_ptr<ICanMsgValue>& value);
+
+        /** \brief Create the converter of a converter of the image */
+        bool buildConverter(const DatabaseImageConverter& image_converter, std::shared_ptr<ICanMsgValueConverter>& converter);
+};
+
+
+#endif // BINARYFILECANMSGDATABASE_H
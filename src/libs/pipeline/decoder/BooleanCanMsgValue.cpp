@@ -20,14 +20,9 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "BooleanCanMsgValue.h"
 
 
-/** \brief Type */
-const std::string BooleanCanMsgValue::m_type = "bool";
-
-
 /** \brief Constructor */
 BooleanCanMsgValue::BooleanCanMsgValue()
 : CanMsgValueBase()
-, m_value(false)
 {
     // Fixed bit size => 1 bit
     setSizeInBits(1u);
@@ -36,9 +31,3 @@ BooleanCanMsgValue::BooleanCanMsgValue()
 /** \brief Destructor */
 BooleanCanMsgValue::~BooleanCanMsgValue()
 {}
-
-/** \brief Update the value from a CAN message */
-void BooleanCanMsgValue::updateValue(const CanMsg& can_msg)
-{
-    m_value = ((can_msg.data[getBytePosition()] & (1u << getBitPosition())) != 0);
-}
@@ -37,23 +37,7 @@ class BooleanCanMsgValue : public CanMsgValueBase
 
 
         /** \brief Get the value's type */
-        virtual const std::string& getType() const override { return m_type; }
-
-
-        /** \brief Get the value */
-        virtual const void* getValue() const override { return &m_value; }
-
-        /** \brief Update the value's from a CAN message */
-        virtual void updateValue(const CanMsg& can_msg) override;
-
-
-    private:
-
-        /** \brief Type */
-        static const std::string m_type;
-
-        /** \brief Value */
-        bool m_value;
+        virtual CanMsgValueType getType() const override { return CANMSGVALUE_BOOL; }
 };
 
 
@@ -0,0 +1,222 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgBatchDecoder.h"
+#include "ICanMsgDatabase.h"
+#include "CanMsgSignal.h"
+
+using namespace std;
+
+
+/** \brief Column index of the signals which can't be decoded */
+const uint32_t CanMsgBatchDecoder::NO_COLUMN;
+
+
+/** \brief Constructor, the database must be loaded and must outlive the decoder */
+CanMsgBatchDecoder::CanMsgBatchDecoder(const ICanMsgDatabase& can_msg_database)
+: m_can_msg_index()
+, m_msg_contexts()
+, m_signals()
+, m_columns()
+, m_lazy_name_index()
+, m_name_index(can_msg_database.isLazy() ? m_lazy_name_index : can_msg_database.getNameIndex())
+, m_signal_columns()
+{
+    m_can_msg_index.build(can_msg_database);
+    if (can_msg_database.isLazy())
+    {
+        m_lazy_name_index.build(m_can_msg_index.getCanMsgs());
+    }
+
+    // Create the decoding context of each message and the column of each signal
+    const auto& can_msgs = m_can_msg_index.getCanMsgs();
+    for (size_t msg_index = 0; msg_index < can_msgs.size(); msg_index++)
+    {
+        const CanMsgDesc& can_msg = *can_msgs[msg_index];
+        MsgContext msg_context;
+        msg_context.first_signal = m_signals.size();
+        msg_context.multiplexed = ((can_msg.getMultiplexer() != nullptr) && CanMsgExtractionPlan::compileField(*can_msg.getMultiplexer(), msg_context.multiplexer_field));
+
+        const auto& signals = can_msg.getSignals();
+        for (size_t i = 0; i < signals.size(); i++)
+        {
+            const CanMsgSignal& signal = *(signals[i]);
+            SignalDesc signal_desc;
+            signal_desc.signal = &signal;
+            signal_desc.multiplexed = can_msg.getValueMultiplexerValue(can_msg.getSignalValueIndex(i), signal_desc.multiplexer_value);
+            if ((signal.getCanMsgValue() != nullptr) && CanMsgExtractionPlan::compileField(*signal.getCanMsgValue(), signal_desc.field))
+            {
+                m_signal_columns.push_back(static_cast<uint32_t>(m_columns.size()));
+
+                Column column;
+                column.signal = &signal;
+                column.type = signal_desc.field.type;
+                column.has_converted_values = ((signal.getConverter() != nullptr) && (signal.getConvertedValueType() == CANMSGVALUE_DOUBLE));
+                m_signals.push_back(signal_desc);
+                m_columns.push_back(column);
+            }
+            else
+            {
+                m_signal_columns.push_back(NO_COLUMN);
+            }
+        }
+        msg_context.signal_count = m_signals.size() - msg_context.first_signal;
+
+        m_msg_contexts.push_back(msg_context);
+    }
+}
+
+/** \brief Destructor */
+CanMsgBatchDecoder::~CanMsgBatchDecoder()
+{}
+
+/** \brief Decode an array of CAN messages and append the values to the columns */
+size_t CanMsgBatchDecoder::decode(const CanMsg* can_msgs, const size_t count)
+{
+    size_t decoded_count = 0;
+
+    // Group the payloads by message
+    for (size_t i = 0; i < count; i++)
+    {
+        const CanMsg& can_msg = can_msgs[i];
+        const uint32_t position = m_can_msg_index.findPosition(can_msg.id, can_msg.extended);
+        if (position != CanMsgDescIndex::NOT_FOUND)
+        {
+            MsgContext* msg_context = &m_msg_contexts[position];
+            msg_context->payloads.push_back(CanMsgExtractionPlan::loadPayload(can_msg));
+            msg_context->timestamps.push_back(can_msg.header.timestamp_sec * 1000000000 + can_msg.header.timestamp_nsec);
+            decoded_count++;
+        }
+    }
+
+    // Decode the messages column-wise
+    for (size_t i = 0; i < m_msg_contexts.size(); i++)
+    {
+        MsgContext& context = m_msg_contexts[i];
+        if (!context.payloads.empty())
+        {
+            decodeMsg(context);
+            context.payloads.clear();
+            context.timestamps.clear();
+        }
+    }
+
+    return decoded_count;
+}
+
+/** \brief Remove all the decoded values */
+void CanMsgBatchDecoder::clear()
+{
+    for (size_t i = 0; i < m_columns.size(); i++)
+    {
+        Column& column = m_columns[i];
+        column.timestamps.clear();
+        column.raw_values.clear();
+        column.converted_values.clear();
+    }
+}
+
+/** \brief Get the column of a signal, return nullptr if the signal doesn't exist */
+const CanMsgBatchDecoder::Column* CanMsgBatchDecoder::getColumn(const std::string& signal_name) const
+{
+    return getColumn(m_name_index.findSignal(signal_name));
+}
+
+/** \brief Get the column of a signal identified by its handle in the name index of the database,
+           return nullptr if the handle is invalid */
+const CanMsgBatchDecoder::Column* CanMsgBatchDecoder::getColumn(const CanMsgNameIndex::handle_t signal_handle) const
+{
+    // The signals are listed in the database's iteration order like the signal handles
+    const Column* column = nullptr;
+    if ((signal_handle < m_signal_columns.size()) && (m_signal_columns[signal_handle] != NO_COLUMN))
+    {
+        column = &m_columns[m_signal_columns[signal_handle]];
+    }
+    return column;
+}
+
+/** \brief Decode the grouped payloads of a CAN message */
+void CanMsgBatchDecoder::decodeMsg(MsgContext& msg_context)
+{
+    const size_t count = msg_context.payloads.size();
+
+    // Extract the multiplexer values once for all the multiplexed signals
+    if (msg_context.multiplexed)
+    {
+        const CanMsgExtractionPlan::Field& field = msg_context.multiplexer_field;
+        msg_context.multiplexer_values.resize(count);
+        for (size_t row = 0; row < count; row++)
+        {
+            msg_context.multiplexer_values[row] = CanMsgExtractionPlan::extractBits(msg_context.payloads[row], field);
+        }
+    }
+
+    for (size_t i = msg_context.first_signal; i < (msg_context.first_signal + msg_context.signal_count); i++)
+    {
+        const SignalDesc& signal_desc = m_signals[i];
+        if (signal_desc.multiplexed)
+        {
+            // Keep only the payloads where the signal is selected
+            msg_context.selected_payloads.clear();
+            msg_context.selected_timestamps.clear();
+            for (size_t row = 0; row < count; row++)
+            {
+                if (msg_context.multiplexer_values[row] == signal_desc.multiplexer_value)
+                {
+                    msg_context.selected_payloads.push_back(msg_context.payloads[row]);
+                    msg_context.selected_timestamps.push_back(msg_context.timestamps[row]);
+                }
+            }
+            decodeColumn(signal_desc, msg_context.selected_payloads.data(), msg_context.selected_timestamps.data(), msg_context.selected_payloads.size(), m_columns[i]);
+        }
+        else
+        {
+            decodeColumn(signal_desc, msg_context.payloads.data(), msg_context.timestamps.data(), count, m_columns[i]);
+        }
+    }
+}
+
+/** \brief Append the values of a signal extracted from an array of payloads to its column */
+void CanMsgBatchDecoder::decodeColumn(const SignalDesc& signal_desc, const uint64_t* payloads, const int64_t* timestamps, const size_t count, Column& column)
+{
+    if (count != 0)
+    {
+        const size_t first_row = column.raw_values.size();
+
+        // Timestamps
+        column.timestamps.insert(column.timestamps.end(), timestamps, timestamps + count);
+
+        // Raw values
+        column.raw_values.resize(first_row + count);
+        CanMsgExtractionPlan::extractColumn(payloads, count, signal_desc.field, &column.raw_values[first_row]);
+
+        // Converted values
+        if (column.has_converted_values)
+        {
+            const ICanMsgValueConverter& converter = *signal_desc.signal->getConverter();
+            column.converted_values.resize(first_row + count);
+            for (size_t row = first_row; row < (first_row + count); row++)
+            {
+                CanMsgValueData converted_value;
+                converter.convert(column.raw_values[row], converted_value);
+                column.converted_values[row] = converted_value.double_value;
+            }
+        }
+    }
+}
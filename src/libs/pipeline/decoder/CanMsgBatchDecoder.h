@@ -0,0 +1,157 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGBATCHDECODER_H
+#define CANMSGBATCHDECODER_H
+
+#include "CanMsgDescIndex.h"
+#include "CanMsgNameIndex.h"
+#include "CanMsgExtractionPlan.h"
+
+#include <string>
+#include <vector>
+
+class ICanMsgDatabase;
+class CanMsgSignal;
+
+
+/** \brief Decode large arrays of CAN messages into per-signal contiguous columns : the messages are grouped by id
+           and each signal is extracted column-wise from the grouped payloads */
+class CanMsgBatchDecoder
+{
+    public:
+
+        /** \brief Decoded values of a signal */
+        struct Column
+        {
+            /** \brief Signal */
+            const CanMsgSignal* signal;
+            /** \brief Extraction type of the raw values */
+            CanMsgExtractionPlan::ExtractionType type;
+            /** \brief Indicate if the converted values are available */
+            bool has_converted_values;
+            /** \brief Timestamps in nanoseconds */
+            std::vector<int64_t> timestamps;
+            /** \brief Raw values */
+            std::vector<CanMsgValueData> raw_values;
+            /** \brief Converted values, only for the signals with a converter to double precision floating point values */
+            std::vector<double> converted_values;
+        };
+
+
+        /** \brief Constructor, the database must be loaded and must outlive the decoder. All the CAN messages
+                   of a database which builds them on demand are built */
+        CanMsgBatchDecoder(const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Destructor */
+        virtual ~CanMsgBatchDecoder();
+
+
+        /** \brief Decode an array of CAN messages and append the values to the columns,
+                   return the number of CAN messages found in the database */
+        size_t decode(const CanMsg* can_msgs, const size_t count);
+
+        /** \brief Remove all the decoded values */
+        void clear();
+
+
+        /** \brief Get the columns of all the signals of the database */
+        const std::vector<Column>& getColumns() const { return m_columns; }
+
+        /** \brief Get the column of a signal, return nullptr if the signal doesn't exist */
+        const Column* getColumn(const std::string& signal_name) const;
+
+        /** \brief Get the column of a signal identified by its handle in the name index of the database,
+                   return nullptr if the handle is invalid */
+        const Column* getColumn(const CanMsgNameIndex::handle_t signal_handle) const;
+
+
+    private:
+
+        /** \brief Column index of the signals which can't be decoded */
+        static const uint32_t NO_COLUMN = 0xFFFFFFFFu;
+
+        /** \brief Signal to decode */
+        struct SignalDesc
+        {
+            /** \brief Signal */
+            const CanMsgSignal* signal;
+            /** \brief Location of the signal's value in the payload word */
+            CanMsgExtractionPlan::Field field;
+            /** \brief Indicate if the signal's value is multiplexed */
+            bool multiplexed;
+            /** \brief Multiplexer value which selects the signal's value */
+            uint64_t multiplexer_value;
+        };
+
+        /** \brief Decoding context of a CAN message */
+        struct MsgContext
+        {
+            /** \brief Index of the first signal of the message in the signals and columns arrays */
+            size_t first_signal;
+            /** \brief Number of signals of the message */
+            size_t signal_count;
+            /** \brief Indicate if the message is multiplexed */
+            bool multiplexed;
+            /** \brief Location of the multiplexer in the payload word */
+            CanMsgExtractionPlan::Field multiplexer_field;
+            /** \brief Payloads of the current batch */
+            std::vector<uint64_t> payloads;
+            /** \brief Timestamps of the current batch */
+            std::vector<int64_t> timestamps;
+            /** \brief Multiplexer values of the current batch */
+            std::vector<uint64_t> multiplexer_values;
+            /** \brief Payloads of the current batch selected by a multiplexer value */
+            std::vector<uint64_t> selected_payloads;
+            /** \brief Timestamps of the current batch selected by a multiplexer value */
+            std::vector<int64_t> selected_timestamps;
+        };
+
+
+        /** \brief Lookup index of the CAN messages database */
+        CanMsgDescIndex m_can_msg_index;
+
+        /** \brief Decoding contexts at the position of their CAN message in the lookup index */
+        std::vector<MsgContext> m_msg_contexts;
+
+        /** \brief Signals to decode */
+        std::vector<SignalDesc> m_signals;
+
+        /** \brief Columns */
+        std::vector<Column> m_columns;
+
+        /** \brief Name index of the CAN messages built on demand, a database which builds them on demand has an empty name index */
+        CanMsgNameIndex m_lazy_name_index;
+
+        /** \brief Name index of the CAN messages database */
+        const CanMsgNameIndex& m_name_index;
+
+        /** \brief Index of the column of each signal, in the order of the signal handles */
+        std::vector<uint32_t> m_signal_columns;
+
+
+        /** \brief Decode the grouped payloads of a CAN message */
+        void decodeMsg(MsgContext& msg_context);
+
+        /** \brief Append the values of a signal extracted from an array of payloads to its column */
+        void decodeColumn(const SignalDesc& signal_desc, const uint64_t* payloads, const int64_t* timestamps, const size_t count, Column& column);
+};
+
+
+#endif // CANMSGBATCHDECODER_H
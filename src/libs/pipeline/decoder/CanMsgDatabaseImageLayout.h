@@ -0,0 +1,210 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGDATABASEIMAGELAYOUT_H
+#define CANMSGDATABASEIMAGELAYOUT_H
+
+#include <cstdint>
+
+/* Layout of the binary image of a CAN message database, all the offsets are relative to the beginning of the image
+   and all the tables are aligned on 8 bytes :
+
+   | header | messages | values | signals | converters | enumerate entries | strings |
+
+   The values and the signals of a message are contiguous and stored in the order they have been added to the message,
+   the strings are interned so that a name shared by several objects is stored once.
+   The image is stored in the byte order of the host, an image of another byte order is rejected by the magic number check.
+*/
+
+/** \brief Magic number of the CAN message database image ("CMDB") */
+static const uint32_t DATABASE_IMAGE_MAGIC = 0x42444D43u;
+
+/** \brief Version of the CAN message database image layout */
+static const uint32_t DATABASE_IMAGE_VERSION = 1u;
+
+/** \brief Alignment of the tables of the CAN message database image */
+static const uint32_t DATABASE_IMAGE_ALIGNMENT = 8u;
+
+/** \brief Converter index of a signal which has no converter */
+static const uint32_t DATABASE_IMAGE_NO_CONVERTER = 0xFFFFFFFFu;
+
+
+/** \brief Kind of a CAN message value in a database image */
+enum DatabaseImageValueKind
+{
+    /** \brief Value which is always present */
+    DATABASE_IMAGE_VALUE = 0,
+    /** \brief Multiplexer value */
+    DATABASE_IMAGE_MULTIPLEXER = 1,
+    /** \brief Value present only for a multiplexer value */
+    DATABASE_IMAGE_MULTIPLEXED = 2
+};
+
+/** \brief Kind of a converter in a database image */
+enum DatabaseImageConverterKind
+{
+    /** \brief EnumCanMsgValueConverter */
+    DATABASE_IMAGE_ENUM_CONVERTER = 0,
+    /** \brief LinearCanMsgValueConverter */
+    DATABASE_IMAGE_LINEAR_CONVERTER = 1,
+    /** \brief FunctionCanMsgValueConverter */
+    DATABASE_IMAGE_FUNCTION_CONVERTER = 2
+};
+
+
+/** \brief Header of the CAN message database image */
+struct DatabaseImageHeader
+{
+    /** \brief Magic number */
+    uint32_t magic;
+    /** \brief Layout version */
+    uint32_t version;
+    /** \brief Content hash of the database source file */
+    uint64_t source_hash;
+    /** \brief Hash of the image contents following the header */
+    uint64_t image_hash;
+    /** \brief Size of the image in bytes */
+    uint64_t size;
+    /** \brief Number of messages */
+    uint32_t message_count;
+    /** \brief Number of values */
+    uint32_t value_count;
+    /** \brief Number of signals */
+    uint32_t signal_count;
+    /** \brief Number of converters */
+    uint32_t converter_count;
+    /** \brief Number of enumerate entries */
+    uint32_t enum_entry_count;
+    /** \brief Size of the strings in bytes */
+    uint32_t strings_size;
+    /** \brief Offset of the messages */
+    uint64_t messages_offset;
+    /** \brief Offset of the values */
+    uint64_t values_offset;
+    /** \brief Offset of the signals */
+    uint64_t signals_offset;
+    /** \brief Offset of the converters */
+    uint64_t converters_offset;
+    /** \brief Offset of the enumerate entries */
+    uint64_t enum_entries_offset;
+    /** \brief Offset of the strings */
+    uint64_t strings_offset;
+};
+
+/** \brief String of the CAN message database image */
+struct DatabaseImageString
+{
+    /** \brief Offset of the string's characters relative to the strings offset */
+    uint32_t offset;
+    /** \brief Length of the string in characters */
+    uint32_t length;
+};
+
+/** \brief CAN message of the database image */
+struct DatabaseImageMessage
+{
+    /** \brief Key of the message in the database */
+    uint32_t key;
+    /** \brief Id */
+    uint32_t id;
+    /** \brief Name */
+    DatabaseImageString name;
+    /** \brief Index of the first value */
+    uint32_t first_value;
+    /** \brief Number of values */
+    uint32_t value_count;
+    /** \brief Index of the first signal */
+    uint32_t first_signal;
+    /** \brief Number of signals */
+    uint32_t signal_count;
+    /** \brief Extended flag */
+    uint8_t extended;
+    /** \brief Padding */
+    uint8_t reserved[7];
+};
+
+/** \brief CAN message value of the database image */
+struct DatabaseImageValue
+{
+    /** \brief Multiplexer value for which the value is present (DATABASE_IMAGE_MULTIPLEXED values only) */
+    uint64_t multiplexer_value;
+    /** \brief Type (CanMsgValueType) */
+    uint8_t type;
+    /** \brief Kind (DatabaseImageValueKind) */
+    uint8_t kind;
+    /** \brief Byte order (CanMsgByteOrder) */
+    uint8_t byte_order;
+    /** \brief Byte position */
+    uint8_t byte_position;
+    /** \brief Bit position */
+    uint8_t bit_position;
+    /** \brief Size in bits */
+    uint8_t size_in_bits;
+    /** \brief Padding */
+    uint8_t reserved[2];
+};
+
+/** \brief CAN signal of the database image */
+struct DatabaseImageSignal
+{
+    /** \brief Name */
+    DatabaseImageString name;
+    /** \brief Unit */
+    DatabaseImageString unit;
+    /** \brief Index of the signal's value in the values of its message */
+    uint32_t value_index;
+    /** \brief Index of the converter (DATABASE_IMAGE_NO_CONVERTER if the signal has no converter) */
+    uint32_t converter_index;
+};
+
+/** \brief Converter of the database image */
+struct DatabaseImageConverter
+{
+    /** \brief Linear coefficients and bounds (DATABASE_IMAGE_LINEAR_CONVERTER only) */
+    double factor;
+    double offset;
+    double min;
+    double max;
+    /** \brief Name */
+    DatabaseImageString name;
+    /** \brief Type */
+    DatabaseImageString type;
+    /** \brief Transfer function (DATABASE_IMAGE_FUNCTION_CONVERTER only) */
+    DatabaseImageString function;
+    /** \brief Index of the first enumerate entry (DATABASE_IMAGE_ENUM_CONVERTER only) */
+    uint32_t first_enum_entry;
+    /** \brief Number of enumerate entries (DATABASE_IMAGE_ENUM_CONVERTER only) */
+    uint32_t enum_entry_count;
+    /** \brief Kind (DatabaseImageConverterKind) */
+    uint8_t kind;
+    /** \brief Padding */
+    uint8_t reserved[7];
+};
+
+/** \brief Enumerate entry of the database image */
+struct DatabaseImageEnumEntry
+{
+    /** \brief Value */
+    int64_t value;
+    /** \brief Label */
+    DatabaseImageString label;
+};
+
+
+#endif // CANMSGDATABASEIMAGELAYOUT_H
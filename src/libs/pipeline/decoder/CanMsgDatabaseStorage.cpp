@@ -0,0 +1,107 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgDatabaseStorage.h"
+#include "ICanMsgValueConverter.h"
+
+using namespace std;
+
+
+/** \brief Constructor */
+CanMsgDatabaseStorage::CanMsgDatabaseStorage()
+: m_blocks()
+, m_block_used(BLOCK_SIZE)
+, m_destructors()
+, m_strings()
+, m_string_index()
+, m_converters()
+, m_converter_index()
+{}
+
+/** \brief Destructor */
+CanMsgDatabaseStorage::~CanMsgDatabaseStorage()
+{
+    // Objects are destroyed in reverse creation order since they can reference objects created before them
+    for (auto iter = m_destructors.rbegin(); iter != m_destructors.rend(); ++iter)
+    {
+        iter->second(iter->first);
+    }
+}
+
+/** \brief Get the stored copy of a string, the copy is shared by all the identical strings */
+const std::string& CanMsgDatabaseStorage::intern(const std::string_view& str)
+{
+    const string* interned = nullptr;
+
+    auto iter = m_string_index.find(str);
+    if (iter != m_string_index.end())
+    {
+        interned = iter->second;
+    }
+    else
+    {
+        // Deque elements never move so the index can reference them
+        m_strings.emplace_back(str);
+        interned = &m_strings.back();
+        m_string_index[*interned] = interned;
+    }
+
+    return (*interned);
+}
+
+/** \brief Get the copy of a converter configured for a value type, the copy is shared by all the signals
+           using this converter with this value type, return nullptr if the converter doesn't support the value type */
+ICanMsgValueConverter* CanMsgDatabaseStorage::shareConverter(const ICanMsgValueConverter& converter, const ICanMsgValue& can_value)
+{
+    ICanMsgValueConverter* shared_converter = nullptr;
+
+    // The configuration of a converter only depends on the type of its input value
+    const auto key = make_pair(&converter, can_value.getType());
+    auto iter = m_converter_index.find(key);
+    if (iter != m_converter_index.end())
+    {
+        shared_converter = iter->second;
+    }
+    else
+    {
+        unique_ptr<ICanMsgValueConverter> copy(converter.clone());
+        if (copy->setCanMsgValue(can_value))
+        {
+            shared_converter = copy.get();
+            m_converter_index[key] = shared_converter;
+            m_converters.push_back(move(copy));
+        }
+    }
+
+    return shared_converter;
+}
+
+/** \brief Allocate memory in the current block or in a new block */
+void* CanMsgDatabaseStorage::allocate(const size_t size, const size_t alignment)
+{
+    size_t offset = ((m_block_used + alignment - 1u) & ~(alignment - 1u));
+    if ((offset + size) > BLOCK_SIZE)
+    {
+        m_blocks.emplace_back(new char[BLOCK_SIZE]);
+        offset = 0;
+    }
+    m_block_used = offset + size;
+
+    return (m_blocks.back().get() + offset);
+}
@@ -0,0 +1,114 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGDATABASESTORAGE_H
+#define CANMSGDATABASESTORAGE_H
+
+#include "ICanMsgValue.h"
+#include "NoCopy.h"
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+
+class ICanMsgValueConverter;
+
+
+/** \brief Storage of the objects of a CAN message database : the CAN messages, values and signals are allocated
+           contiguously in large blocks, the names and units are interned so that each distinct string is stored once,
+           and the immutable converters are shared by all the signals with the same converter and value type.
+           The stored objects are destroyed with the storage, the shared pointers returned by create() don't own them */
+class CanMsgDatabaseStorage : public INoCopy
+{
+    public:
+
+        /** \brief Constructor */
+        CanMsgDatabaseStorage();
+
+        /** \brief Destructor */
+        virtual ~CanMsgDatabaseStorage();
+
+
+        /** \brief Create an object in the storage */
+        template <typename T, typename... ArgsType>
+        std::shared_ptr<T> create(ArgsType&&... args)
+        {
+            T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<ArgsType>(args)...);
+            m_destructors.emplace_back(object, [](void* obj) { static_cast<T*>(obj)->~T(); });
+
+            // Aliasing constructor with an empty owner : no control block is allocated
+            return std::shared_ptr<T>(std::shared_ptr<T>(), object);
+        }
+
+        /** \brief Get the stored copy of a string, the copy is shared by all the identical strings */
+        const std::string& intern(const std::string_view& str);
+
+        /** \brief Get the copy of a converter configured for a value type, the copy is shared by all the signals
+                   using this converter with this value type, return nullptr if the converter doesn't support the value type.
+                   The converters are identified by address until forgetConverters() is called */
+        ICanMsgValueConverter* shareConverter(const ICanMsgValueConverter& converter, const ICanMsgValue& can_value);
+
+        /** \brief Forget the converters given to shareConverter() before they are destroyed so that another converter
+                   at the same address isn't mistaken for them, the shared copies are kept */
+        void forgetConverters() { m_converter_index.clear(); }
+
+        /** \brief Get the number of bytes allocated for the objects */
+        size_t getAllocatedSize() const { return (m_blocks.size() * BLOCK_SIZE); }
+
+
+    private:
+
+        /** \brief Size of an allocation block in bytes */
+        static const size_t BLOCK_SIZE = 64u * 1024u;
+
+
+        /** \brief Allocation blocks */
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+
+        /** \brief Number of bytes used in the last allocation block */
+        size_t m_block_used;
+
+        /** \brief Destructor of each created object, in creation order */
+        std::vector<std::pair<void*, void (*)(void*)>> m_destructors;
+
+        /** \brief Interned strings */
+        std::deque<std::string> m_strings;
+
+        /** \brief Interned strings indexed by value */
+        std::unordered_map<std::string_view, const std::string*> m_string_index;
+
+        /** \brief Shared converters */
+        std::vector<std::unique_ptr<ICanMsgValueConverter>> m_converters;
+
+        /** \brief Shared converters indexed by original converter and value type */
+        std::map<std::pair<const ICanMsgValueConverter*, CanMsgValueType>, ICanMsgValueConverter*> m_converter_index;
+
+
+        /** \brief Allocate memory in the current block or in a new block */
+        void* allocate(const size_t size, const size_t alignment);
+};
+
+
+#endif // CANMSGDATABASESTORAGE_H
@@ -19,14 +19,27 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CanMsgDecoder.h"
 #include "ICanMsgDatabase.h"
+#include "CanMsgSignal.h"
+#include "CanMsgSignalHistory.h"
+#include "CanMsgExtractionPlan.h"
+
+#include <algorithm>
 
 using namespace std;
 
 /** \brief Constructor */
 CanMsgDecoder::CanMsgDecoder()
 : CanPipelineStageBase(false)
-, m_can_msg_database(nullptr)
+, m_context(new Context())
+, m_caches()
+, m_caches_generation(0)
+, m_lazy_index()
+, m_lazy_caches()
+, m_lazy_generation(0)
+, m_decode_count(0)
+, m_cache_hit_count(0)
 , m_listener(nullptr)
+, m_history(nullptr)
 {}
 
 /** \brief Destructor */
@@ -34,31 +47,483 @@ CanMsgDecoder::~CanMsgDecoder()
 {}
 
 
+/** \brief Set the CAN messages database, the database must not be modified afterwards */
+void CanMsgDecoder::setCanMsgDatabase(const ICanMsgDatabase& can_msg_database)
+{
+    // The database is not owned by the decoder
+    const shared_ptr<const ICanMsgDatabase> database(&can_msg_database, [](const ICanMsgDatabase*) {});
+    publishCanMsgDatabase(database, false);
+}
+
+/** \brief Replace the CAN messages database while CAN messages are being decoded */
+void CanMsgDecoder::reloadCanMsgDatabase(const std::shared_ptr<const ICanMsgDatabase>& can_msg_database)
+{
+    publishCanMsgDatabase(can_msg_database, true);
+}
+
+/** \brief Subscribe to a signal of the database */
+bool CanMsgDecoder::subscribe(const std::string& signal_name)
+{
+    return setSubscription(signal_name, true);
+}
+
+/** \brief Subscribe to a signal identified by its handle in the name index of the database, return false if the handle is invalid */
+bool CanMsgDecoder::subscribe(const CanMsgNameIndex::handle_t signal_handle)
+{
+    return setSubscription(signal_handle, true);
+}
+
+/** \brief Unsubscribe from a signal, return false if the signal was not subscribed */
+bool CanMsgDecoder::unsubscribe(const std::string& signal_name)
+{
+    return setSubscription(signal_name, false);
+}
+
+/** \brief Unsubscribe from a signal identified by its handle in the name index of the database,
+           return false if the signal was not subscribed */
+bool CanMsgDecoder::unsubscribe(const CanMsgNameIndex::handle_t signal_handle)
+{
+    return setSubscription(signal_handle, false);
+}
+
+/** \brief Remove all the subscriptions so that all the signals are decoded */
+void CanMsgDecoder::unsubscribeAll()
+{
+    m_context.update([](Context& context)
+    {
+        context.subscribed_index.clear();
+        context.subscriptions.clear();
+        context.subscribed_signals.clear();
+        context.subscribed_msg_signals.clear();
+        context.generation++;
+    });
+}
+
+/** \brief Reset the decoding statistics */
+void CanMsgDecoder::resetStatistics()
+{
+    m_decode_count.store(0u, std::memory_order_relaxed);
+    m_cache_hit_count.store(0u, std::memory_order_relaxed);
+}
+
 /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
 bool CanMsgDecoder::processCanData(const CanData& can_data)
 {
     // Decode only received CAN messages
     if (can_data.header.type == CAN_DATA_RX_MSG)
     {
-        if (m_can_msg_database != nullptr)
+        decodeCanMsg(can_data.msg);
+    }
+
+    return false;
+}
+
+/** \brief Decode a received CAN message */
+void CanMsgDecoder::decodeCanMsg(const CanMsg& can_msg)
+{
+    // The context can't be released until the message has been recorded and notified
+    RcuPtr<Context>::ReadGuard context(m_context);
+    if (context->generation != m_caches_generation)
+    {
+        // A new database or new subscriptions have been published since the previous message
+        resetCaches(*context);
+    }
+
+    // Look for the message in the database or in the subscriptions, the other messages are not extracted
+    const bool all_signals = context->subscriptions.empty();
+    const CanMsgDescIndex& can_msg_index = (all_signals ? context->can_msg_index : context->subscribed_index);
+    const uint32_t position = can_msg_index.findPosition(can_msg.id, can_msg.extended);
+    const CanMsgDesc* can_msg_desc = nullptr;
+    DecodeCache* lazy_cache = nullptr;
+    if (position != CanMsgDescIndex::NOT_FOUND)
+    {
+        can_msg_desc = can_msg_index.getCanMsgs()[position];
+    }
+    else if (context->lazy && all_signals)
+    {
+        // The message may not have been built yet by the database, the other databases are not looked up
+        // since an id missing from their index is missing from the database
+        lazy_cache = findLazyCanMsg(*context, can_msg, can_msg_desc);
+    }
+    if (can_msg_desc != nullptr)
+    {
+        // Cyclic messages often repeat the same payload : the previous decoding is reused as is
+        DecodeCache& cache = ((lazy_cache != nullptr) ? *lazy_cache : m_caches[position]);
+        const uint64_t payload = CanMsgExtractionPlan::loadPayload(can_msg);
+        m_decode_count.fetch_add(1u, std::memory_order_relaxed);
+        if (cache.valid && (cache.payload == payload) && (cache.size == can_msg.size))
+        {
+            m_cache_hit_count.fetch_add(1u, std::memory_order_relaxed);
+        }
+        else
+        {
+            // Decode all the message signals or only the subscribed signals
+            if (all_signals)
+            {
+                can_msg_desc->decode(can_msg, cache.decoded_frame);
+            }
+            else
+            {
+                can_msg_desc->decode(can_msg, cache.decoded_frame, context->subscriptions[position].selection);
+            }
+            cache.payload = payload;
+            cache.size = can_msg.size;
+            cache.valid = true;
+        }
+
+        // Record history
+        if (m_history != nullptr)
+        {
+            m_history->record(can_msg, cache.decoded_frame);
+        }
+
+        // Notify listener
+        if (m_listener != nullptr)
+        {
+            m_listener->canMsgDecoded(can_msg, cache.decoded_frame);
+        }
+    }
+}
+
+/** \brief Look for a CAN message built on demand by the database, build it if it is not known yet,
+           return the last decoding of the message or nullptr if the database doesn't contain it */
+CanMsgDecoder::DecodeCache* CanMsgDecoder::findLazyCanMsg(const Context& context, const CanMsg& can_msg, const CanMsgDesc*& can_msg_desc)
+{
+    DecodeCache* cache = nullptr;
+
+    // The CAN messages built on demand are kept until another database is published
+    if (context.database_generation != m_lazy_generation)
+    {
+        m_lazy_generation = context.database_generation;
+        m_lazy_index.clear();
+        m_lazy_caches.clear();
+    }
+
+    // A new CAN message is appended to the index so that the last decodings of the other messages stay valid
+    uint32_t position = m_lazy_index.findPosition(can_msg.id, can_msg.extended);
+    if (position == CanMsgDescIndex::NOT_FOUND)
+    {
+        const CanMsgDesc* loaded_can_msg = context.can_msg_database->loadCanMsg(can_msg.id, can_msg.extended);
+        if (loaded_can_msg != nullptr)
+        {
+            position = static_cast<uint32_t>(m_lazy_index.size());
+            m_lazy_index.add(loaded_can_msg);
+            m_lazy_caches.emplace_back();
+            m_lazy_caches.back().valid = false;
+        }
+    }
+    if (position != CanMsgDescIndex::NOT_FOUND)
+    {
+        can_msg_desc = m_lazy_index.getCanMsgs()[position];
+        cache = &m_lazy_caches[position];
+    }
+
+    return cache;
+}
+
+/** \brief Add a CAN message loaded on demand by a database to the context of this database */
+void CanMsgDecoder::addCanMsg(const std::shared_ptr<const ICanMsgDatabase>& database, const CanMsgDesc& can_msg)
+{
+    m_context.update([&](Context& context)
+    {
+        // The database may have been replaced in the meantime
+        if ((context.can_msg_database == database) && (context.can_msg_index.find(can_msg.getId(), can_msg.isExtented()) == nullptr))
+        {
+            context.can_msg_index.add(&can_msg);
+            context.generation++;
+        }
+    });
+}
+
+/** \brief Set the subscription state of a signal, return false if the signal doesn't exist in the database */
+bool CanMsgDecoder::setSubscription(const std::string& signal_name, const bool subscribed)
+{
+    bool ret = false;
+
+    // The message of the signal may not have been loaded yet by the database
+    if (subscribed)
+    {
+        shared_ptr<const ICanMsgDatabase> database;
+        {
+            RcuPtr<Context>::ReadGuard context(m_context);
+            database = context->can_msg_database;
+        }
+        const CanMsgDesc* can_msg = ((database && database->isLazy()) ? database->loadSignalCanMsg(signal_name) : nullptr);
+        if (can_msg != nullptr)
+        {
+            addCanMsg(database, *can_msg);
+        }
+    }
+
+    m_context.update([&](Context& context)
+    {
+        ret = applySubscription(context, signal_name, subscribed);
+        if (ret)
+        {
+            context.generation++;
+        }
+    });
+    return ret;
+}
+
+/** \brief Set the subscription state of a signal identified by its handle, return false if the handle is invalid */
+bool CanMsgDecoder::setSubscription(const CanMsgNameIndex::handle_t signal_handle, const bool subscribed)
+{
+    bool ret = false;
+
+    m_context.update([&](Context& context)
+    {
+        const CanMsgNameIndex* name_index = (context.can_msg_database ? &context.can_msg_database->getNameIndex() : nullptr);
+        if ((name_index != nullptr) && (signal_handle < name_index->getSignalCount()))
         {
-            // Look for the message in the database
-            auto can_msgs = m_can_msg_database->getCanMsgs();
-            auto iter = can_msgs.find(can_data.msg.id);
-            if (iter != can_msgs.end())
+            // Only the signal of the handle is subscribed, the signals of the other messages sharing its name are left as is
+            const CanMsgNameIndex::SignalEntry& entry = name_index->getSignal(signal_handle);
+            ret = applySubscription(context, *entry.can_msg, entry.signal_index, subscribed);
+            if (ret)
             {
-                // Update message signals
-                auto can_msg_desc = iter->second;
-                can_msg_desc->updateSignals(can_data.msg);
+                // Keep the signal by message to subscribe it again on a database reload
+                const string& signal_name = entry.signal->getName();
+                auto msg_signal_iter = find_if(context.subscribed_msg_signals.begin(), context.subscribed_msg_signals.end(), [&](const SubscribedSignal& subscribed_signal)
+                {
+                    return ((subscribed_signal.id == entry.can_msg->getId()) && (subscribed_signal.extended == entry.can_msg->isExtented()) && (subscribed_signal.name == signal_name));
+                });
+                auto name_iter = find(context.subscribed_signals.begin(), context.subscribed_signals.end(), signal_name);
+                if (subscribed && (name_iter == context.subscribed_signals.end()) && (msg_signal_iter == context.subscribed_msg_signals.end()))
+                {
+                    context.subscribed_msg_signals.push_back({ entry.can_msg->getId(), entry.can_msg->isExtented(), signal_name });
+                }
+                if (!subscribed)
+                {
+                    if (msg_signal_iter != context.subscribed_msg_signals.end())
+                    {
+                        context.subscribed_msg_signals.erase(msg_signal_iter);
+                    }
+                    if (name_iter != context.subscribed_signals.end())
+                    {
+                        // The other signals sharing the name are now kept by message
+                        context.subscribed_signals.erase(name_iter);
+                        for (CanMsgNameIndex::handle_t handle = name_index->findSignal(signal_name); handle != CanMsgNameIndex::INVALID_HANDLE; handle = name_index->getSignal(handle).next)
+                        {
+                            const CanMsgDesc& can_msg = *name_index->getSignal(handle).can_msg;
+                            if (handle != signal_handle)
+                            {
+                                context.subscribed_msg_signals.push_back({ can_msg.getId(), can_msg.isExtented(), signal_name });
+                            }
+                        }
+                    }
+                }
+                context.generation++;
+            }
+        }
+    });
 
-                // Notify listener
-                if (m_listener != nullptr)
+    return ret;
+}
+
+/** \brief Set the subscription state of a signal in a context, return false if the signal doesn't exist in the database */
+bool CanMsgDecoder::applySubscription(Context& context, const std::string& signal_name, const bool subscribed)
+{
+    bool ret = false;
+
+    // Copy the current subscriptions
+    vector<const CanMsgDesc*> can_msgs = context.subscribed_index.getCanMsgs();
+    vector<Subscription> subscriptions = context.subscriptions;
+
+    const CanMsgNameIndex* name_index = (context.can_msg_database ? &context.can_msg_database->getNameIndex() : nullptr);
+    if ((name_index != nullptr) && !name_index->empty())
+    {
+        // The signals sharing the name are chained in the name index of the database
+        for (CanMsgNameIndex::handle_t handle = name_index->findSignal(signal_name); handle != CanMsgNameIndex::INVALID_HANDLE; handle = name_index->getSignal(handle).next)
+        {
+            const CanMsgNameIndex::SignalEntry& entry = name_index->getSignal(handle);
+            ret = (updateSubscription(can_msgs, subscriptions, *entry.can_msg, entry.signal_index, subscribed) || ret);
+        }
+    }
+    else
+    {
+        // The messages built on demand by a database are not in its name index,
+        // look for the signal in the messages of the context (the messages of the subscribed signals)
+        const vector<const CanMsgDesc*>& db_can_msgs = context.can_msg_index.getCanMsgs();
+        for (size_t msg_index = 0; msg_index < db_can_msgs.size(); msg_index++)
+        {
+            const CanMsgDesc* can_msg = db_can_msgs[msg_index];
+            const auto& signals = can_msg->getSignals();
+            for (size_t signal_index = 0; signal_index < signals.size(); signal_index++)
+            {
+                if (signals[signal_index]->getName() == signal_name)
                 {
-                    m_listener->canMsgDecoded(can_data.msg, *can_msg_desc);
+                    ret = (updateSubscription(can_msgs, subscriptions, *can_msg, signal_index, subscribed) || ret);
                 }
             }
         }
     }
 
-    return false;
+    // Apply the new subscriptions
+    if (ret)
+    {
+        context.subscribed_index.build(can_msgs);
+        context.subscriptions = subscriptions;
+
+        // Keep the names of the subscribed signals to subscribe them again on a database reload,
+        // the name covers the signals sharing it which have been subscribed by their handle
+        auto iter = find(context.subscribed_signals.begin(), context.subscribed_signals.end(), signal_name);
+        if (subscribed && (iter == context.subscribed_signals.end()))
+        {
+            context.subscribed_signals.push_back(signal_name);
+        }
+        if (!subscribed && (iter != context.subscribed_signals.end()))
+        {
+            context.subscribed_signals.erase(iter);
+        }
+        context.subscribed_msg_signals.erase(remove_if(context.subscribed_msg_signals.begin(), context.subscribed_msg_signals.end(), [&](const SubscribedSignal& subscribed_signal)
+        {
+            return (subscribed_signal.name == signal_name);
+        }), context.subscribed_msg_signals.end());
+    }
+
+    return ret;
+}
+
+/** \brief Set the subscription state of a single signal of a CAN message in a context,
+           return false if the signal was not subscribed and is unsubscribed */
+bool CanMsgDecoder::applySubscription(Context& context, const CanMsgDesc& can_msg, const size_t signal_index, const bool subscribed)
+{
+    vector<const CanMsgDesc*> can_msgs = context.subscribed_index.getCanMsgs();
+    vector<Subscription> subscriptions = context.subscriptions;
+    const bool ret = updateSubscription(can_msgs, subscriptions, can_msg, signal_index, subscribed);
+    if (ret)
+    {
+        context.subscribed_index.build(can_msgs);
+        context.subscriptions = subscriptions;
+    }
+
+    return ret;
+}
+
+/** \brief Subscribe again in a context to a signal subscribed by its handle, return false if its CAN message
+           doesn't contain the signal anymore */
+bool CanMsgDecoder::applySubscription(Context& context, const SubscribedSignal& subscribed_signal)
+{
+    bool ret = false;
+
+    const CanMsgDesc* can_msg = context.can_msg_index.find(subscribed_signal.id, subscribed_signal.extended);
+    if (can_msg != nullptr)
+    {
+        const auto& signals = can_msg->getSignals();
+        for (size_t signal_index = 0; !ret && (signal_index < signals.size()); signal_index++)
+        {
+            if (signals[signal_index]->getName() == subscribed_signal.name)
+            {
+                ret = applySubscription(context, *can_msg, signal_index, true);
+            }
+        }
+    }
+    if (ret)
+    {
+        context.subscribed_msg_signals.push_back(subscribed_signal);
+    }
+
+    return ret;
+}
+
+/** \brief Set the subscription state of a signal of a CAN message in a list of subscriptions,
+           return false if the signal was not subscribed and is unsubscribed */
+bool CanMsgDecoder::updateSubscription(std::vector<const CanMsgDesc*>& can_msgs, std::vector<Subscription>& subscriptions,
+                                       const CanMsgDesc& can_msg, const size_t signal_index, const bool subscribed)
+{
+    // Look for the subscription of the message
+    size_t position = 0;
+    while ((position < can_msgs.size()) && (can_msgs[position] != &can_msg))
+    {
+        position++;
+    }
+    if (position == can_msgs.size())
+    {
+        Subscription subscription;
+        subscription.signal_mask.resize(can_msg.getSignals().size(), false);
+        can_msgs.push_back(&can_msg);
+        subscriptions.push_back(subscription);
+    }
+
+    // Update the selection of the message's signals
+    Subscription& subscription = subscriptions[position];
+    const bool ret = (subscribed || subscription.signal_mask[signal_index]);
+    subscription.signal_mask[signal_index] = subscribed;
+    if (!can_msg.selectSignals(subscription.signal_mask, subscription.selection))
+    {
+        // No more subscribed signals in the message
+        can_msgs.erase(can_msgs.begin() + position);
+        subscriptions.erase(subscriptions.begin() + position);
+    }
+
+    return ret;
+}
+
+/** \brief Publish a new context built from a CAN messages database */
+void CanMsgDecoder::publishCanMsgDatabase(const std::shared_ptr<const ICanMsgDatabase>& can_msg_database, const bool keep_subscriptions)
+{
+    m_context.update([&](Context& context)
+    {
+        vector<string> subscribed_signals;
+        vector<SubscribedSignal> subscribed_msg_signals;
+        if (keep_subscriptions)
+        {
+            subscribed_signals.swap(context.subscribed_signals);
+            subscribed_msg_signals.swap(context.subscribed_msg_signals);
+        }
+
+        // Index the new database, the CAN messages of a database which builds them on demand are indexed when they are received
+        context.can_msg_database = can_msg_database;
+        context.lazy = can_msg_database->isLazy();
+        if (context.lazy)
+        {
+            // Only the messages of the subscribed signals are built right away
+            vector<const CanMsgDesc*> can_msgs;
+            for (size_t i = 0; i < subscribed_signals.size(); i++)
+            {
+                can_msgs.push_back(can_msg_database->loadSignalCanMsg(subscribed_signals[i]));
+            }
+            for (size_t i = 0; i < subscribed_msg_signals.size(); i++)
+            {
+                can_msgs.push_back(can_msg_database->loadCanMsg(subscribed_msg_signals[i].id, subscribed_msg_signals[i].extended));
+            }
+            sort(can_msgs.begin(), can_msgs.end());
+            can_msgs.erase(unique(can_msgs.begin(), can_msgs.end()), can_msgs.end());
+            can_msgs.erase(remove(can_msgs.begin(), can_msgs.end(), nullptr), can_msgs.end());
+            context.can_msg_index.build(can_msgs);
+        }
+        else
+        {
+            context.can_msg_index.build(*can_msg_database);
+        }
+        context.subscribed_index.clear();
+        context.subscriptions.clear();
+        context.subscribed_signals.clear();
+        context.subscribed_msg_signals.clear();
+        context.generation++;
+        context.database_generation = context.generation;
+
+        // Subscribe again to the signals which still exist
+        for (size_t i = 0; i < subscribed_signals.size(); i++)
+        {
+            applySubscription(context, subscribed_signals[i], true);
+        }
+        for (size_t i = 0; i < subscribed_msg_signals.size(); i++)
+        {
+            applySubscription(context, subscribed_msg_signals[i]);
+        }
+    });
+}
+
+/** \brief Invalidate the last decodings and size them for the lookup index in use */
+void CanMsgDecoder::resetCaches(const Context& context)
+{
+    const CanMsgDescIndex& can_msg_index = (context.subscriptions.empty() ? context.can_msg_index : context.subscribed_index);
+    m_caches_generation = context.generation;
+    m_caches.clear();
+    m_caches.resize(can_msg_index.size());
+    for (size_t i = 0; i < m_caches.size(); i++)
+    {
+        m_caches[i].valid = false;
+    }
 }
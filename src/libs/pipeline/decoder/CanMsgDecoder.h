@@ -21,9 +21,18 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define CANMSGDECODER_H
 
 #include "CanPipelineStageBase.h"
+#include "CanMsgDescIndex.h"
+#include "CanMsgNameIndex.h"
+#include "DecodedFrame.h"
+#include "RcuPtr.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
 
 class ICanMsgDatabase;
-class CanMsgDesc;
+class CanMsgSignalHistory;
 
 /** \brief Interface for all listener implementations for the utility class which decodes received CAN messages */
 class ICanMsgDecoderListener
@@ -34,8 +43,8 @@ class ICanMsgDecoderListener
         virtual ~ICanMsgDecoderListener() {}
 
         
-        /** \brief Called when message has been decoded */
-        virtual void canMsgDecoded(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg) = 0;
+        /** \brief Called when message has been decoded, the decoded frame is only valid during the call */
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) = 0;
 };
 
 
@@ -52,12 +61,60 @@ class CanMsgDecoder : public CanPipelineStageBase
         virtual ~CanMsgDecoder();
 
 
-        /** \brief Set the CAN messages database */
-        void setCanMsgDatabase(ICanMsgDatabase& can_msg_database) { m_can_msg_database = &can_msg_database; }
+        /** \brief Set the CAN messages database, the database must not be modified afterwards
+                   but it can be shared with other decoders */
+        void setCanMsgDatabase(const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Replace the CAN messages database while CAN messages are being decoded : the database is indexed
+                   in the calling thread then published atomically and the CAN messages received afterwards are decoded
+                   with it. The subscribed signals which exist in the new database stay subscribed. The previous database
+                   is released once no CAN message is being decoded with it. A signal history created on the previous
+                   database only records the CAN messages of the previous database. It must not be called from a listener
+                   since it waits for the decoding in progress */
+        void reloadCanMsgDatabase(const std::shared_ptr<const ICanMsgDatabase>& can_msg_database);
 
         /** \brief Set the listener to decoded messages */
         void setListener(ICanMsgDecoderListener& listener) { m_listener = &listener; }
 
+        /** \brief Set the history where the decoded signals are recorded (nullptr to disable recording),
+                   the history must be created on the same database */
+        void setSignalHistory(CanMsgSignalHistory* history) { m_history = history; }
+
+
+        /** \brief Subscribe to a signal of the database (identified by its id in the database) : once at least one signal
+                   is subscribed, only the CAN messages containing subscribed signals are decoded and only the subscribed
+                   signals are converted and notified. The subscriptions can be changed while CAN messages are being decoded
+                   but not from a listener. Return false if the signal doesn't exist in the database */
+        bool subscribe(const std::string& signal_name);
+
+        /** \brief Subscribe to a signal identified by its handle in the name index of the database, only this signal
+                   is subscribed and not the signals of other CAN messages sharing its name. On a database reload the signal
+                   stays subscribed if its CAN message still contains a signal with the same name. Return false if the handle
+                   is invalid */
+        bool subscribe(const CanMsgNameIndex::handle_t signal_handle);
+
+        /** \brief Unsubscribe from a signal, return false if the signal was not subscribed */
+        bool unsubscribe(const std::string& signal_name);
+
+        /** \brief Unsubscribe from a signal identified by its handle in the name index of the database, the signals
+                   of other CAN messages sharing its name stay subscribed. Return false if the signal was not subscribed */
+        bool unsubscribe(const CanMsgNameIndex::handle_t signal_handle);
+
+        /** \brief Remove all the subscriptions so that all the signals are decoded */
+        void unsubscribeAll();
+
+
+        /** \brief Get the number of received CAN messages found in the database (or in the subscriptions),
+                   it can be called from any thread */
+        uint64_t getDecodeCount() const { return m_decode_count.load(std::memory_order_relaxed); }
+
+        /** \brief Get the number of received CAN messages which had the same payload and size as the previous
+                   message with the same id and which have not been decoded again, it can be called from any thread */
+        uint64_t getCacheHitCount() const { return m_cache_hit_count.load(std::memory_order_relaxed); }
+
+        /** \brief Reset the decoding statistics */
+        void resetStatistics();
+
 
     protected:
 
@@ -67,11 +124,136 @@ class CanMsgDecoder : public CanPipelineStageBase
 
     private:
 
-        /** \brief CAN messages database */
-        ICanMsgDatabase* m_can_msg_database;
+        /** \brief Subscription to the signals of a CAN message */
+        struct Subscription
+        {
+            /** \brief Mask of the subscribed signals */
+            std::vector<bool> signal_mask;
+            /** \brief Selection of the subscribed signals */
+            CanMsgDesc::SignalSelection selection;
+        };
+
+        /** \brief Signal subscribed by its handle, identified by its CAN message and its name to subscribe it again
+                   on a database reload */
+        struct SubscribedSignal
+        {
+            /** \brief Id of the CAN message */
+            uint32_t id;
+            /** \brief Indicate if the id of the CAN message is extended */
+            bool extended;
+            /** \brief Name of the signal */
+            std::string name;
+        };
+
+        /** \brief Decoding context built from a CAN messages database, immutable once published */
+        struct Context
+        {
+            /** \brief Generation of the context, each published context has a new generation */
+            uint64_t generation;
+            /** \brief Generation of the context in which the database has been published */
+            uint64_t database_generation;
+            /** \brief CAN messages database (not owned if it has been set with setCanMsgDatabase) */
+            std::shared_ptr<const ICanMsgDatabase> can_msg_database;
+            /** \brief Indicate if the database builds its CAN messages on demand, the unknown ids are then looked up in the database
+                       by the decoding thread */
+            bool lazy;
+            /** \brief Lookup index of the CAN messages database */
+            CanMsgDescIndex can_msg_index;
+            /** \brief Lookup index of the CAN messages with subscribed signals */
+            CanMsgDescIndex subscribed_index;
+            /** \brief Subscriptions at the position of their CAN message in the subscriptions lookup index */
+            std::vector<Subscription> subscriptions;
+            /** \brief Names of the signals subscribed by name */
+            std::vector<std::string> subscribed_signals;
+            /** \brief Signals subscribed by their handle whose name is not subscribed */
+            std::vector<SubscribedSignal> subscribed_msg_signals;
+        };
+
+        /** \brief Last decoding of a CAN message */
+        struct DecodeCache
+        {
+            /** \brief Indicate if the cache contains a decoded frame */
+            bool valid;
+            /** \brief Payload size */
+            uint8_t size;
+            /** \brief Payload word */
+            uint64_t payload;
+            /** \brief Decoded frame */
+            DecodedFrame decoded_frame;
+        };
+
+
+        /** \brief Decoding context */
+        RcuPtr<Context> m_context;
+
+        /** \brief Last decodings at the position of their CAN message in the lookup index in use
+                   (subscriptions lookup index if there are subscriptions), they are only accessed by the decoding thread */
+        std::vector<DecodeCache> m_caches;
+
+        /** \brief Generation of the context the last decodings belong to */
+        uint64_t m_caches_generation;
+
+        /** \brief Lookup index of the CAN messages built on demand by the database while decoding all the signals,
+                   it is only accessed by the decoding thread so that a new CAN message doesn't republish the context */
+        CanMsgDescIndex m_lazy_index;
+
+        /** \brief Last decodings at the position of their CAN message in the lookup index of the CAN messages built on demand */
+        std::vector<DecodeCache> m_lazy_caches;
+
+        /** \brief Generation of the context in which the database of the CAN messages built on demand has been published */
+        uint64_t m_lazy_generation;
+
+        /** \brief Number of received CAN messages found in the database, only a counter : relaxed ordering */
+        std::atomic<uint64_t> m_decode_count;
+
+        /** \brief Number of received CAN messages which have not been decoded again, only a counter : relaxed ordering */
+        std::atomic<uint64_t> m_cache_hit_count;
 
         /** \brief Listener */
         ICanMsgDecoderListener* m_listener;
+
+        /** \brief History of the decoded signals */
+        CanMsgSignalHistory* m_history;
+
+
+        /** \brief Decode a received CAN message */
+        void decodeCanMsg(const CanMsg& can_msg);
+
+        /** \brief Look for a CAN message built on demand by the database, build it if it is not known yet,
+                   return the last decoding of the message or nullptr if the database doesn't contain it */
+        DecodeCache* findLazyCanMsg(const Context& context, const CanMsg& can_msg, const CanMsgDesc*& can_msg_desc);
+
+        /** \brief Add a CAN message loaded on demand by a database to the context of this database */
+        void addCanMsg(const std::shared_ptr<const ICanMsgDatabase>& database, const CanMsgDesc& can_msg);
+
+        /** \brief Set the subscription state of a signal, return false if the signal doesn't exist in the database */
+        bool setSubscription(const std::string& signal_name, const bool subscribed);
+
+        /** \brief Set the subscription state of a signal identified by its handle, return false if the handle is invalid */
+        bool setSubscription(const CanMsgNameIndex::handle_t signal_handle, const bool subscribed);
+
+        /** \brief Set the subscription state of a signal in a context, return false if the signal doesn't exist in the database */
+        static bool applySubscription(Context& context, const std::string& signal_name, const bool subscribed);
+
+        /** \brief Set the subscription state of a single signal of a CAN message in a context,
+                   return false if the signal was not subscribed and is unsubscribed */
+        static bool applySubscription(Context& context, const CanMsgDesc& can_msg, const size_t signal_index, const bool subscribed);
+
+        /** \brief Subscribe again in a context to a signal subscribed by its handle, return false if its CAN message
+                   doesn't contain the signal anymore */
+        static bool applySubscription(Context& context, const SubscribedSignal& subscribed_signal);
+
+        /** \brief Set the subscription state of a signal of a CAN message in a list of subscriptions,
+                   return false if the signal was not subscribed and is unsubscribed */
+        static bool updateSubscription(std::vector<const CanMsgDesc*>& can_msgs, std::vector<Subscription>& subscriptions,
+                                       const CanMsgDesc& can_msg, const size_t signal_index, const bool subscribed);
+
+        /** \brief Publish a new context built from a CAN messages database */
+        void publishCanMsgDatabase(const std::shared_ptr<const ICanMsgDatabase>& can_msg_database, const bool keep_subscriptions);
+
+        /** \brief Invalidate the last decodings and size them for the lookup index in use */
+        void resetCaches(const Context& context);
+
 };
 
 
@@ -20,17 +20,38 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "CanMsgDesc.h"
 #include "CanMsgSignal.h"
 #include "ICanMsgValue.h"
+#include "DecodedFrame.h"
 
 #include <algorithm>
+
 using namespace std;
 
 
+/** \brief Multiplexer index of a message which is not multiplexed */
+const size_t CanMsgDesc::NO_MULTIPLEXER;
+
+/** \brief Layout index of the values which are always present */
+const uint32_t CanMsgDesc::NO_LAYOUT;
+
+/** \brief Maximum number of entries of the layout table */
+static const uint64_t MAX_LAYOUT_TABLE_SIZE = 1024u;
+
+
 /** \brief Constructor */
 CanMsgDesc::CanMsgDesc(const uint32_t id, const std::string& name, const bool extended)
 : m_id(id)
 , m_name(name)
 , m_extended(extended)
 , m_values()
+, m_signals()
+, m_extraction_plan()
+, m_all_signals()
+, m_multiplexer_index(NO_MULTIPLEXER)
+, m_value_layouts()
+, m_layouts()
+, m_layout_table()
+, m_signal_value_indexes()
+, m_signal_converters()
 {}
 
 /** \brief Destructor */
@@ -39,23 +60,222 @@ CanMsgDesc::~CanMsgDesc()
 
 /** \brief Add a message's value */
 bool CanMsgDesc::addValue(std::shared_ptr<ICanMsgValue>& msg_value)
+{
+    return addValue(msg_value, NO_LAYOUT);
+}
+
+/** \brief Add the message's multiplexer value, the value must be an unsigned integer value */
+bool CanMsgDesc::addMultiplexerValue(std::shared_ptr<ICanMsgValue>& msg_value)
+{
+    bool ret = false;
+
+    if (msg_value && !isMultiplexed() && (msg_value->getType() == CANMSGVALUE_UINT))
+    {
+        ret = addValue(msg_value, NO_LAYOUT);
+        if (ret)
+        {
+            m_multiplexer_index = m_values.size() - 1u;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Add a message's value which is present only when the multiplexer value is equal to the given value */
+bool CanMsgDesc::addMultiplexedValue(std::shared_ptr<ICanMsgValue>& msg_value, const uint64_t multiplexer_value)
+{
+    bool ret = false;
+
+    if (isMultiplexed())
+    {
+        // Look for the layout of the multiplexer value
+        auto iter = lower_bound(m_layouts.begin(), m_layouts.end(), multiplexer_value, [](const MultiplexedLayout& layout, const uint64_t value) { return (layout.multiplexer_value < value); });
+        if ((iter == m_layouts.end()) || (iter->multiplexer_value != multiplexer_value))
+        {
+            // Create the layout, the layouts are sorted by multiplexer value
+            const uint32_t new_layout_index = static_cast<uint32_t>(iter - m_layouts.begin());
+            for (size_t i = 0; i < m_value_layouts.size(); i++)
+            {
+                if ((m_value_layouts[i] != NO_LAYOUT) && (m_value_layouts[i] >= new_layout_index))
+                {
+                    m_value_layouts[i]++;
+                }
+            }
+            MultiplexedLayout layout;
+            layout.multiplexer_value = multiplexer_value;
+            iter = m_layouts.insert(iter, layout);
+            m_all_signals.layout_signal_indexes.insert(m_all_signals.layout_signal_indexes.begin() + new_layout_index, m_all_signals.common_signal_indexes);
+            buildLayoutTable();
+        }
+
+        ret = addValue(msg_value, static_cast<uint32_t>(iter - m_layouts.begin()));
+    }
+
+    return ret;
+}
+
+/** \brief Get the multiplexer value for which a message's value is present, return false if the value is always present */
+bool CanMsgDesc::getValueMultiplexerValue(const size_t value_index, uint64_t& multiplexer_value) const
+{
+    bool ret = false;
+
+    if ((value_index < m_value_layouts.size()) && (m_value_layouts[value_index] != NO_LAYOUT))
+    {
+        multiplexer_value = m_layouts[m_value_layouts[value_index]].multiplexer_value;
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** \brief Add a message's signal */
+bool CanMsgDesc::addSignal(std::shared_ptr<CanMsgSignal>& msg_signal)
 {
     bool ret = false;
-    
+
+    if (msg_signal)
+    {
+        // Look for the signal's value in the message's values
+        size_t value_index = 0;
+        while ((value_index < m_values.size()) && (m_values[value_index].get() != msg_signal->getCanMsgValue()))
+        {
+            value_index++;
+        }
+        ret = (value_index < m_values.size());
+        if (ret)
+        {
+            const size_t signal_index = m_signals.size();
+            m_signals.push_back(msg_signal);
+            m_signal_value_indexes.push_back(value_index);
+            m_signal_converters.push_back(msg_signal->getConverter());
+
+            // Add the signal to the layouts where its value is present
+            const uint32_t layout_index = m_value_layouts[value_index];
+            if (layout_index == NO_LAYOUT)
+            {
+                m_all_signals.common_signal_indexes.push_back(signal_index);
+                for (size_t i = 0; i < m_all_signals.layout_signal_indexes.size(); i++)
+                {
+                    m_all_signals.layout_signal_indexes[i].push_back(signal_index);
+                }
+            }
+            else
+            {
+                m_all_signals.layout_signal_indexes[layout_index].push_back(signal_index);
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Build the selection of the signals to decode from a mask of the message's signals */
+bool CanMsgDesc::selectSignals(const std::vector<bool>& signal_mask, SignalSelection& selection) const
+{
+    bool ret = false;
+
+    selection.common_signal_indexes.clear();
+    selection.layout_signal_indexes.assign(m_all_signals.layout_signal_indexes.size(), vector<size_t>());
+    for (size_t i = 0; i < m_all_signals.common_signal_indexes.size(); i++)
+    {
+        const size_t signal_index = m_all_signals.common_signal_indexes[i];
+        if ((signal_index < signal_mask.size()) && signal_mask[signal_index])
+        {
+            selection.common_signal_indexes.push_back(signal_index);
+            ret = true;
+        }
+    }
+    for (size_t layout_index = 0; layout_index < m_all_signals.layout_signal_indexes.size(); layout_index++)
+    {
+        const vector<size_t>& signal_indexes = m_all_signals.layout_signal_indexes[layout_index];
+        for (size_t i = 0; i < signal_indexes.size(); i++)
+        {
+            const size_t signal_index = signal_indexes[i];
+            if ((signal_index < signal_mask.size()) && signal_mask[signal_index])
+            {
+                selection.layout_signal_indexes[layout_index].push_back(signal_index);
+                ret = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Decode the values and the selected signals of a CAN message into a frame */
+void CanMsgDesc::decode(const CanMsg& can_msg, DecodedFrame& decoded_frame, const SignalSelection& selection) const
+{
+    decoded_frame.reset(*this);
+
+    // Extract all the values with a single load of the payload
+    const uint64_t payload = CanMsgExtractionPlan::loadPayload(can_msg);
+    CanMsgValueData* values = decoded_frame.getValues();
+    m_extraction_plan.extract(payload, values);
+
+    // Extract the multiplexed values of the selected layout
+    const vector<size_t>* signal_indexes = &selection.common_signal_indexes;
+    if (isMultiplexed())
+    {
+        const uint32_t layout_index = findLayout(values[m_multiplexer_index].uint_value);
+        if (layout_index != NO_LAYOUT)
+        {
+            m_layouts[layout_index].extraction_plan.extract(payload, values);
+            signal_indexes = &selection.layout_signal_indexes[layout_index];
+        }
+    }
+    decoded_frame.setDecodedSignals(*signal_indexes);
+
+    // Convert the signals' values
+    CanMsgValueData* converted_values = decoded_frame.getConvertedValues();
+    for (size_t i = 0; i < signal_indexes->size(); i++)
+    {
+        const size_t signal_index = (*signal_indexes)[i];
+        const CanMsgValueData& value = values[m_signal_value_indexes[signal_index]];
+        const ICanMsgValueConverter* converter = m_signal_converters[signal_index];
+        if (converter != nullptr)
+        {
+            converter->convert(value, converted_values[signal_index]);
+        }
+        else
+        {
+            converted_values[signal_index] = value;
+        }
+    }
+}
+
+/** \brief Add a value to the message */
+bool CanMsgDesc::addValue(std::shared_ptr<ICanMsgValue>& msg_value, const uint32_t layout_index)
+{
+    bool ret = false;
+
     if (msg_value)
     {
-        // Check if the value overlap an existing value inside the message
+        // Check if the value overlaps an existing value which can be present at the same time inside the message
         bool overlap = false;
         for (size_t i = 0; !overlap && (i < m_values.size()); i++)
         {
             const ICanMsgValue& value = *(m_values[i]);
-            overlap = (((msg_value->getStartBitPosition() >= value.getStartBitPosition()) && (msg_value->getStartBitPosition() <= value.getEndBitPosition())) ||
-                       ((msg_value->getEndBitPosition() >= value.getStartBitPosition()) && (msg_value->getEndBitPosition() <= value.getEndBitPosition())));
+            if ((layout_index == NO_LAYOUT) || (m_value_layouts[i] == NO_LAYOUT) || (m_value_layouts[i] == layout_index))
+            {
+                overlap = ((msg_value->getPayloadMask() & value.getPayloadMask()) != 0);
+            }
+        }
+        if (!overlap)
+        {
+            const size_t value_index = m_values.size();
+            if (layout_index == NO_LAYOUT)
+            {
+                ret = m_extraction_plan.add(*msg_value, value_index);
+            }
+            else
+            {
+                ret = m_layouts[layout_index].extraction_plan.add(*msg_value, value_index);
+            }
         }
-        ret = !overlap;
         if (ret)
         {
             m_values.push_back(msg_value);
+            m_value_layouts.push_back(layout_index);
             msg_value->setCanMsg(*this);
         }
     }
@@ -63,23 +283,43 @@ bool CanMsgDesc::addValue(std::shared_ptr<ICanMsgValue>& msg_value)
     return ret;
 }
 
-/** \brief Add a message's signal */
-bool CanMsgDesc::addSignal(std::shared_ptr<CanMsgSignal>& msg_signal)
+/** \brief Get the index of the layout of a multiplexer value (NO_LAYOUT if there is no layout for this value) */
+uint32_t CanMsgDesc::findLayout(const uint64_t multiplexer_value) const
 {
-    bool ret = false;
+    uint32_t layout_index = NO_LAYOUT;
 
-    if (msg_signal)
+    if (!m_layout_table.empty())
     {
-        m_signals.push_back(msg_signal);
-        ret = true;
+        // Direct access
+        if (multiplexer_value < m_layout_table.size())
+        {
+            layout_index = m_layout_table[multiplexer_value];
+        }
+    }
+    else
+    {
+        // Binary search
+        auto iter = lower_bound(m_layouts.begin(), m_layouts.end(), multiplexer_value, [](const MultiplexedLayout& layout, const uint64_t value) { return (layout.multiplexer_value < value); });
+        if ((iter != m_layouts.end()) && (iter->multiplexer_value == multiplexer_value))
+        {
+            layout_index = static_cast<uint32_t>(iter - m_layouts.begin());
+        }
     }
 
-    return ret;
+    return layout_index;
 }
 
-/** \brief Update the signals from a CAN message */
-void CanMsgDesc::updateSignals(const CanMsg& can_msg)
+/** \brief Build the layout table if the multiplexer values are dense enough */
+void CanMsgDesc::buildLayoutTable()
 {
-    auto update = [can_msg](shared_ptr<CanMsgSignal>& signal) { signal->updateValues(can_msg); };
-    std::for_each(m_signals.begin(), m_signals.end(), update);
+    m_layout_table.clear();
+
+    if (!m_layouts.empty() && (m_layouts.back().multiplexer_value < MAX_LAYOUT_TABLE_SIZE))
+    {
+        m_layout_table.resize(m_layouts.back().multiplexer_value + 1u, NO_LAYOUT);
+        for (size_t i = 0; i < m_layouts.size(); i++)
+        {
+            m_layout_table[m_layouts[i].multiplexer_value] = static_cast<uint32_t>(i);
+        }
+    }
 }
@@ -21,19 +21,36 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define CANMSGDESC_H
 
 #include "CanData.h"
+#include "CanMsgExtractionPlan.h"
 
 #include <string>
 #include <vector>
 #include <memory>
 
 class ICanMsgValue;
+class ICanMsgValueConverter;
 class CanMsgSignal;
+class DecodedFrame;
 
-/** \brief Description of a CAN message in the message database */
+/** \brief Description of a CAN message in the message database, the description is immutable once
+           the database is loaded so that any number of threads can decode messages with it.
+           A multiplexed message contains a multiplexer value which selects the layout of the
+           multiplexed values : each layout has its own extraction plan and signals list */
 class CanMsgDesc
 {
     public:
 
+        /** \brief Signals to decode in a CAN message */
+        struct SignalSelection
+        {
+            /** \brief Indexes of the signals of the values which are always present */
+            std::vector<size_t> common_signal_indexes;
+            /** \brief Indexes of the signals to decode for each multiplexed layout (signals of the multiplexed values
+                       and of the values which are always present) */
+            std::vector<std::vector<size_t>> layout_signal_indexes;
+        };
+
+
         /** \brief Constructor */
         CanMsgDesc(const uint32_t id, const std::string& name, const bool extended);
 
@@ -51,26 +68,70 @@ class CanMsgDesc
         bool isExtented() const { return m_extended; }
 
 
-        /** \brief Add a message's value */
+        /** \brief Add a message's value, the value must be fully configured before being added */
         bool addValue(std::shared_ptr<ICanMsgValue>& msg_value);
 
+        /** \brief Add the message's multiplexer value, the value must be an unsigned integer value */
+        bool addMultiplexerValue(std::shared_ptr<ICanMsgValue>& msg_value);
+
+        /** \brief Add a message's value which is present only when the multiplexer value is equal to the given value,
+                   the multiplexer value must have been added before */
+        bool addMultiplexedValue(std::shared_ptr<ICanMsgValue>& msg_value, const uint64_t multiplexer_value);
+
         /** \brief Get the message's values */
         const std::vector<std::shared_ptr<ICanMsgValue>>& getValues() const { return m_values; }
 
+        /** \brief Indicate if the message is multiplexed */
+        bool isMultiplexed() const { return (m_multiplexer_index != NO_MULTIPLEXER); }
+
+        /** \brief Get the message's multiplexer value (nullptr if the message is not multiplexed) */
+        const ICanMsgValue* getMultiplexer() const { return (isMultiplexed() ? m_values[m_multiplexer_index].get() : nullptr); }
+
+        /** \brief Get the multiplexer value for which a message's value is present, return false if the value is always present */
+        bool getValueMultiplexerValue(const size_t value_index, uint64_t& multiplexer_value) const;
+
 
-        /** \brief Add a message's signal */
+        /** \brief Add a message's signal, the signal's value and converter must be set before it is added */
         bool addSignal(std::shared_ptr<CanMsgSignal>& msg_signal);
 
         /** \brief Get the message's signals */
         const std::vector<std::shared_ptr<CanMsgSignal>>& getSignals() const { return m_signals; }
 
+        /** \brief Get the index in the message's values of the value of a signal */
+        size_t getSignalValueIndex(const size_t signal_index) const { return m_signal_value_indexes[signal_index]; }
 
-        /** \brief Update the signals from a CAN message */
-        void updateSignals(const CanMsg& can_msg);
+
+        /** \brief Build the selection of the signals to decode from a mask of the message's signals,
+                   return false if no signal is selected */
+        bool selectSignals(const std::vector<bool>& signal_mask, SignalSelection& selection) const;
+
+
+        /** \brief Decode the values and all the signals of a CAN message into a frame */
+        void decode(const CanMsg& can_msg, DecodedFrame& decoded_frame) const { decode(can_msg, decoded_frame, m_all_signals); }
+
+        /** \brief Decode the values and the selected signals of a CAN message into a frame,
+                   the selection must have been built by this message description */
+        void decode(const CanMsg& can_msg, DecodedFrame& decoded_frame, const SignalSelection& selection) const;
 
 
     private:
 
+        /** \brief Multiplexer index of a message which is not multiplexed */
+        static const size_t NO_MULTIPLEXER = static_cast<size_t>(-1);
+
+        /** \brief Layout index of the values which are always present */
+        static const uint32_t NO_LAYOUT = 0xFFFFFFFFu;
+
+        /** \brief Layout of the multiplexed values for a multiplexer value */
+        struct MultiplexedLayout
+        {
+            /** \brief Multiplexer value */
+            uint64_t multiplexer_value;
+            /** \brief Extraction plan of the multiplexed values */
+            CanMsgExtractionPlan extraction_plan;
+        };
+
+
         /** \brief Id */
         const uint32_t m_id;
 
@@ -86,6 +147,40 @@ class CanMsgDesc
 
         /** \brief List of the message's signals */
         std::vector<std::shared_ptr<CanMsgSignal>> m_signals;
+
+        /** \brief Extraction plan of the message's values which are always present */
+        CanMsgExtractionPlan m_extraction_plan;
+
+        /** \brief Selection of all the signals */
+        SignalSelection m_all_signals;
+
+        /** \brief Index of the multiplexer in the message's values */
+        size_t m_multiplexer_index;
+
+        /** \brief Index of the layout of each value (NO_LAYOUT if the value is always present) */
+        std::vector<uint32_t> m_value_layouts;
+
+        /** \brief Layouts of the multiplexed values */
+        std::vector<MultiplexedLayout> m_layouts;
+
+        /** \brief Layout index by multiplexer value (empty if the multiplexer values are too sparse) */
+        std::vector<uint32_t> m_layout_table;
+
+        /** \brief Index of the value of each signal in the message's values */
+        std::vector<size_t> m_signal_value_indexes;
+
+        /** \brief Converter of each signal (nullptr if the signal has no converter) */
+        std::vector<const ICanMsgValueConverter*> m_signal_converters;
+
+
+        /** \brief Add a value to the message */
+        bool addValue(std::shared_ptr<ICanMsgValue>& msg_value, const uint32_t layout_index);
+
+        /** \brief Get the index of the layout of a multiplexer value (NO_LAYOUT if there is no layout for this value) */
+        uint32_t findLayout(const uint64_t multiplexer_value) const;
+
+        /** \brief Build the layout table if the multiplexer values are dense enough */
+        void buildLayoutTable();
 };
 
 
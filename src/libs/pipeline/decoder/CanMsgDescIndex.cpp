@@ -0,0 +1,151 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgDescIndex.h"
+#include "ICanMsgDatabase.h"
+
+using namespace std;
+
+
+/** \brief Position returned when a CAN message description is not found */
+const uint32_t CanMsgDescIndex::NOT_FOUND;
+
+
+/** \brief Constructor */
+CanMsgDescIndex::CanMsgDescIndex()
+: m_can_msgs()
+, m_std_msgs(STD_ID_COUNT, NOT_FOUND)
+, m_ext_msgs()
+, m_ext_bits(0u)
+, m_ext_count(0u)
+{}
+
+/** \brief Destructor */
+CanMsgDescIndex::~CanMsgDescIndex()
+{}
+
+/** \brief Build the index from all the CAN messages of a database, the positions follow the database's iteration order */
+void CanMsgDescIndex::build(const ICanMsgDatabase& can_msg_database)
+{
+    vector<const CanMsgDesc*> can_msgs;
+    can_msg_database.loadAllCanMsgs(can_msgs);
+    build(can_msgs);
+}
+
+/** \brief Build the index from a list of CAN messages */
+void CanMsgDescIndex::build(const std::vector<const CanMsgDesc*>& can_msgs)
+{
+    clear();
+    m_can_msgs = can_msgs;
+
+    // Fill the standard ids table and count the extended ids
+    for (size_t i = 0; i < m_can_msgs.size(); i++)
+    {
+        const CanMsgDesc* can_msg = m_can_msgs[i];
+        if (can_msg->isExtented())
+        {
+            m_ext_count++;
+        }
+        else
+        {
+            if (can_msg->getId() < STD_ID_COUNT)
+            {
+                m_std_msgs[can_msg->getId()] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    if (m_ext_count != 0)
+    {
+        buildExtended();
+    }
+}
+
+/** \brief Add a CAN message at the end of the index, the positions of the indexed CAN messages are unchanged */
+void CanMsgDescIndex::add(const CanMsgDesc* can_msg)
+{
+    const uint32_t position = static_cast<uint32_t>(m_can_msgs.size());
+    m_can_msgs.push_back(can_msg);
+    if (can_msg->isExtented())
+    {
+        // The hash table is rebuilt only when its size doubles
+        m_ext_count++;
+        if ((m_ext_count * 2u) > m_ext_msgs.size())
+        {
+            buildExtended();
+        }
+        else
+        {
+            insertExtended(can_msg->getId(), position);
+        }
+    }
+    else
+    {
+        if (can_msg->getId() < STD_ID_COUNT)
+        {
+            m_std_msgs[can_msg->getId()] = position;
+        }
+    }
+}
+
+/** \brief Empty the index */
+void CanMsgDescIndex::clear()
+{
+    m_can_msgs.clear();
+    m_std_msgs.assign(STD_ID_COUNT, NOT_FOUND);
+    m_ext_msgs.clear();
+    m_ext_bits = 0u;
+    m_ext_count = 0u;
+}
+
+/** \brief Size the hash table for the extended ids and fill it with the indexed CAN message descriptions */
+void CanMsgDescIndex::buildExtended()
+{
+    // Size the extended ids hash table to keep its load factor under 50%
+    m_ext_bits = 3u;
+    while ((1u << m_ext_bits) < (m_ext_count * 2u))
+    {
+        m_ext_bits++;
+    }
+    const ExtEntry empty_entry = { 0u, NOT_FOUND };
+    m_ext_msgs.assign(1u << m_ext_bits, empty_entry);
+
+    // Fill the extended ids hash table
+    for (size_t i = 0; i < m_can_msgs.size(); i++)
+    {
+        const CanMsgDesc* can_msg = m_can_msgs[i];
+        if (can_msg->isExtented())
+        {
+            insertExtended(can_msg->getId(), static_cast<uint32_t>(i));
+        }
+    }
+}
+
+/** \brief Insert the position of a CAN message description with an extended id in the hash table using linear probing */
+void CanMsgDescIndex::insertExtended(const uint32_t id, const uint32_t position)
+{
+    const uint32_t mask = static_cast<uint32_t>(m_ext_msgs.size() - 1u);
+    uint32_t index = hash(id);
+    while ((m_ext_msgs[index].position != NOT_FOUND) && (m_ext_msgs[index].id != id))
+    {
+        index = ((index + 1u) & mask);
+    }
+    m_ext_msgs[index].id = id;
+    m_ext_msgs[index].position = position;
+}
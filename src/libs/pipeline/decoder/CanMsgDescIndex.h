@@ -0,0 +1,157 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGDESCINDEX_H
+#define CANMSGDESCINDEX_H
+
+#include "CanData.h"
+
+#include <vector>
+#include <cstddef>
+
+class ICanMsgDatabase;
+class CanMsgDesc;
+
+
+/** \brief Lookup index of CAN message descriptions by (id, extended) : a direct-indexed table for the standard ids
+           and an open-addressed hash table for the extended ids. The index also gives the position of a description
+           in the list it was built from so that users can attach their own data to each indexed message */
+class CanMsgDescIndex
+{
+    public:
+
+        /** \brief Position returned when a CAN message description is not found */
+        static const uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+
+        /** \brief Constructor */
+        CanMsgDescIndex();
+
+        /** \brief Destructor */
+        virtual ~CanMsgDescIndex();
+
+
+        /** \brief Build the index from all the CAN messages of a database, the positions follow the database's iteration order.
+                   A database which builds its CAN messages on demand builds all of them */
+        void build(const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Build the index from a list of CAN messages */
+        void build(const std::vector<const CanMsgDesc*>& can_msgs);
+
+        /** \brief Add a CAN message at the end of the index, the positions of the indexed CAN messages are unchanged.
+                   The CAN message must not be indexed yet */
+        void add(const CanMsgDesc* can_msg);
+
+        /** \brief Empty the index */
+        void clear();
+
+
+        /** \brief Get the number of indexed CAN message descriptions */
+        size_t size() const { return m_can_msgs.size(); }
+
+        /** \brief Get the indexed CAN message descriptions */
+        const std::vector<const CanMsgDesc*>& getCanMsgs() const { return m_can_msgs; }
+
+
+        /** \brief Look for a CAN message description, return nullptr if not found */
+        const CanMsgDesc* find(const uint32_t id, const bool extended) const
+        {
+            const uint32_t position = findPosition(id, extended);
+            return ((position != NOT_FOUND) ? m_can_msgs[position] : nullptr);
+        }
+
+        /** \brief Look for the position of a CAN message description, return NOT_FOUND if not found */
+        uint32_t findPosition(const uint32_t id, const bool extended) const
+        {
+            uint32_t position = NOT_FOUND;
+            if (extended)
+            {
+                position = findExtended(id);
+            }
+            else
+            {
+                if (id < STD_ID_COUNT)
+                {
+                    position = m_std_msgs[id];
+                }
+            }
+            return position;
+        }
+
+
+    private:
+
+        /** \brief Number of standard CAN ids */
+        static const uint32_t STD_ID_COUNT = 2048u;
+
+        /** \brief Entry of the extended ids hash table */
+        struct ExtEntry
+        {
+            /** \brief CAN id */
+            uint32_t id;
+            /** \brief Position of the CAN message description, NOT_FOUND if the entry is empty */
+            uint32_t position;
+        };
+
+
+        /** \brief Indexed CAN message descriptions */
+        std::vector<const CanMsgDesc*> m_can_msgs;
+
+        /** \brief Positions of the CAN message descriptions indexed by standard id */
+        std::vector<uint32_t> m_std_msgs;
+
+        /** \brief Hash table of the positions of the CAN message descriptions with an extended id */
+        std::vector<ExtEntry> m_ext_msgs;
+
+        /** \brief Number of bits of the hash table's index */
+        uint32_t m_ext_bits;
+
+        /** \brief Number of CAN message descriptions with an extended id */
+        size_t m_ext_count;
+
+
+        /** \brief Size the hash table for the extended ids and fill it with the indexed CAN message descriptions */
+        void buildExtended();
+
+        /** \brief Insert the position of a CAN message description with an extended id in the hash table */
+        void insertExtended(const uint32_t id, const uint32_t position);
+
+        /** \brief Compute the hash table's index of an extended id */
+        uint32_t hash(const uint32_t id) const { return static_cast<uint32_t>((id * 2654435761u) >> (32u - m_ext_bits)); }
+
+        /** \brief Look for the position of a CAN message description with an extended id */
+        uint32_t findExtended(const uint32_t id) const
+        {
+            uint32_t position = NOT_FOUND;
+            if (!m_ext_msgs.empty())
+            {
+                const uint32_t mask = static_cast<uint32_t>(m_ext_msgs.size() - 1u);
+                uint32_t index = hash(id);
+                while ((m_ext_msgs[index].position != NOT_FOUND) && (m_ext_msgs[index].id != id))
+                {
+                    index = ((index + 1u) & mask);
+                }
+                position = m_ext_msgs[index].position;
+            }
+            return position;
+        }
+};
+
+
+#endif // CANMSGDESCINDEX_H
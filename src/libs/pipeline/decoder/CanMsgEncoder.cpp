@@ -0,0 +1,175 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgEncoder.h"
+#include "CanMsgDesc.h"
+#include "CanMsgSignal.h"
+
+using namespace std;
+
+
+/** \brief Constructor, the CAN message description must outlive the encoder */
+CanMsgEncoder::CanMsgEncoder(const CanMsgDesc& can_msg)
+: m_can_msg(can_msg)
+, m_size(0)
+, m_multiplexer_field()
+, m_signals()
+{
+    // Payload size
+    const auto& values = m_can_msg.getValues();
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        const uint8_t size = CanMsgExtractionPlan::getPayloadSize(*values[i]);
+        if (size > m_size)
+        {
+            m_size = size;
+        }
+    }
+
+    // Multiplexer
+    bool multiplexer_valid = false;
+    if (m_can_msg.getMultiplexer() != nullptr)
+    {
+        multiplexer_valid = CanMsgExtractionPlan::compileField(*m_can_msg.getMultiplexer(), m_multiplexer_field);
+    }
+
+    // Signals
+    const auto& signals = m_can_msg.getSignals();
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+        const CanMsgSignal& signal = *signals[i];
+        SignalPlan signal_plan;
+        signal_plan.converter = signal.getConverter();
+        signal_plan.multiplexed = m_can_msg.getValueMultiplexerValue(m_can_msg.getSignalValueIndex(i), signal_plan.multiplexer_value);
+        signal_plan.valid = ((signal.getCanMsgValue() != nullptr) && 
+                             CanMsgExtractionPlan::compileField(*signal.getCanMsgValue(), signal_plan.field) && 
+                             (!signal_plan.multiplexed || multiplexer_valid));
+        m_signals.push_back(signal_plan);
+    }
+}
+
+/** \brief Destructor */
+CanMsgEncoder::~CanMsgEncoder()
+{}
+
+/** \brief Look for the index of a signal in the CAN message description, return false if the signal doesn't exist */
+bool CanMsgEncoder::findSignal(const std::string& signal_name, size_t& signal_index) const
+{
+    bool ret = false;
+
+    const auto& signals = m_can_msg.getSignals();
+    for (size_t i = 0; !ret && (i < signals.size()); i++)
+    {
+        if (signals[i]->getName() == signal_name)
+        {
+            signal_index = i;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Initialize a CAN message with the id and size of the CAN message description and a null payload */
+void CanMsgEncoder::init(CanMsg& can_msg) const
+{
+    can_msg.id = m_can_msg.getId();
+    can_msg.extended = m_can_msg.isExtented();
+    can_msg.rtr = false;
+    can_msg.size = m_size;
+    CanMsgExtractionPlan::storePayload(0u, can_msg);
+}
+
+/** \brief Encode the converted values of a list of signals into a CAN message, the other signals are set to 0 */
+bool CanMsgEncoder::encode(const size_t* signal_indexes, const CanMsgValueData* converted_values, const size_t count, CanMsg& can_msg) const
+{
+    bool ret = true;
+
+    init(can_msg);
+    for (size_t i = 0; i < count; i++)
+    {
+        ret = setValue(can_msg, signal_indexes[i], converted_values[i]) && ret;
+    }
+
+    return ret;
+}
+
+/** \brief Patch the converted value of a signal into the payload of a CAN message */
+bool CanMsgEncoder::setValue(CanMsg& can_msg, const size_t signal_index, const CanMsgValueData& converted_value) const
+{
+    bool ret = false;
+
+    if (signal_index < m_signals.size())
+    {
+        const ICanMsgValueConverter* converter = m_signals[signal_index].converter;
+        if (converter == nullptr)
+        {
+            ret = setRawValue(can_msg, signal_index, converted_value);
+        }
+        else
+        {
+            CanMsgValueData value;
+            if (converter->revert(converted_value, value))
+            {
+                ret = setRawValue(can_msg, signal_index, value);
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Patch the converted value of a signal into the payload of a CAN message */
+bool CanMsgEncoder::setValue(CanMsg& can_msg, const std::string& signal_name, const CanMsgValueData& converted_value) const
+{
+    size_t signal_index = 0;
+    return (findSignal(signal_name, signal_index) && setValue(can_msg, signal_index, converted_value));
+}
+
+/** \brief Patch the raw value of a signal into the payload of a CAN message */
+bool CanMsgEncoder::setRawValue(CanMsg& can_msg, const size_t signal_index, const CanMsgValueData& value) const
+{
+    bool ret = false;
+
+    // The values wider than the signal would be silently truncated
+    if ((signal_index < m_signals.size()) && m_signals[signal_index].valid && CanMsgExtractionPlan::fitsInField(m_signals[signal_index].field, value))
+    {
+        const SignalPlan& signal_plan = m_signals[signal_index];
+        uint64_t payload = CanMsgExtractionPlan::loadPayload(can_msg);
+        if (signal_plan.multiplexed)
+        {
+            // Select the layout of the signal
+            CanMsgValueData multiplexer_value;
+            multiplexer_value.uint_value = signal_plan.multiplexer_value;
+            payload = CanMsgExtractionPlan::insertValue(payload, m_multiplexer_field, multiplexer_value);
+        }
+        payload = CanMsgExtractionPlan::insertValue(payload, signal_plan.field, value);
+        CanMsgExtractionPlan::storePayload(payload, can_msg);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** \brief Patch the raw value of a signal into the payload of a CAN message */
+bool CanMsgEncoder::setRawValue(CanMsg& can_msg, const std::string& signal_name, const CanMsgValueData& value) const
+{
+    size_t signal_index = 0;
+    return (findSignal(signal_name, signal_index) && setRawValue(can_msg, signal_index, value));
+}
@@ -0,0 +1,114 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGENCODER_H
+#define CANMSGENCODER_H
+
+#include "CanMsgExtractionPlan.h"
+
+#include <string>
+#include <vector>
+
+class CanMsgDesc;
+class ICanMsgValueConverter;
+
+
+/** \brief Encode the signals of a CAN message description into CAN messages : the insertion of each signal's value
+           in the payload word is precompiled and the converted values are converted back to raw values by the
+           signals' converters. Signals can be patched one by one into an existing payload so that periodic
+           senders only update the signals which have changed */
+class CanMsgEncoder
+{
+    public:
+
+        /** \brief Constructor, the CAN message description must outlive the encoder */
+        CanMsgEncoder(const CanMsgDesc& can_msg);
+
+        /** \brief Destructor */
+        virtual ~CanMsgEncoder();
+
+
+        /** \brief Get the encoded CAN message description */
+        const CanMsgDesc& getCanMsg() const { return m_can_msg; }
+
+        /** \brief Get the size in bytes of the encoded payload */
+        uint8_t getSize() const { return m_size; }
+
+        /** \brief Look for the index of a signal in the CAN message description, return false if the signal doesn't exist */
+        bool findSignal(const std::string& signal_name, size_t& signal_index) const;
+
+
+        /** \brief Initialize a CAN message with the id and size of the CAN message description and a null payload */
+        void init(CanMsg& can_msg) const;
+
+        /** \brief Encode the converted values of a list of signals into a CAN message, the other signals are set to 0.
+                   Return false if one of the values can't be encoded */
+        bool encode(const size_t* signal_indexes, const CanMsgValueData* converted_values, const size_t count, CanMsg& can_msg) const;
+
+
+        /** \brief Patch the converted value of a signal into the payload of a CAN message (the multiplexer value is updated
+                   for a multiplexed signal), return false if the signal doesn't exist, if the value can't be converted back
+                   or if the raw value doesn't fit in the signal */
+        bool setValue(CanMsg& can_msg, const size_t signal_index, const CanMsgValueData& converted_value) const;
+
+        /** \brief Patch the converted value of a signal into the payload of a CAN message */
+        bool setValue(CanMsg& can_msg, const std::string& signal_name, const CanMsgValueData& converted_value) const;
+
+        /** \brief Patch the raw value of a signal into the payload of a CAN message (the multiplexer value is updated
+                   for a multiplexed signal), return false if the signal doesn't exist or if the value doesn't fit in
+                   the size and signedness of the signal, the payload is then left unchanged */
+        bool setRawValue(CanMsg& can_msg, const size_t signal_index, const CanMsgValueData& value) const;
+
+        /** \brief Patch the raw value of a signal into the payload of a CAN message */
+        bool setRawValue(CanMsg& can_msg, const std::string& signal_name, const CanMsgValueData& value) const;
+
+
+    private:
+
+        /** \brief Precompiled insertion of a signal */
+        struct SignalPlan
+        {
+            /** \brief Location of the signal's value in the payload word */
+            CanMsgExtractionPlan::Field field;
+            /** \brief Converter (nullptr if the raw value is the converted value) */
+            const ICanMsgValueConverter* converter;
+            /** \brief Indicate if the signal can be encoded */
+            bool valid;
+            /** \brief Indicate if the signal's value is multiplexed */
+            bool multiplexed;
+            /** \brief Multiplexer value which selects the signal's value */
+            uint64_t multiplexer_value;
+        };
+
+
+        /** \brief CAN message description */
+        const CanMsgDesc& m_can_msg;
+
+        /** \brief Size in bytes of the encoded payload */
+        uint8_t m_size;
+
+        /** \brief Location of the multiplexer in the payload word */
+        CanMsgExtractionPlan::Field m_multiplexer_field;
+
+        /** \brief Insertion plans of the signals */
+        std::vector<SignalPlan> m_signals;
+};
+
+
+#endif // CANMSGENCODER_H
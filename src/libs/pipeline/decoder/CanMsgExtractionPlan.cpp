@@ -0,0 +1,213 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgExtractionPlan.h"
+#include "ICanMsgValue.h"
+
+using namespace std;
+
+
+/** \brief Constructor */
+CanMsgExtractionPlan::CanMsgExtractionPlan()
+: m_shifts()
+, m_masks()
+, m_sign_bits()
+, m_types()
+, m_value_indexes()
+, m_byte_orders()
+, m_has_big_endian(false)
+{}
+
+/** \brief Destructor */
+CanMsgExtractionPlan::~CanMsgExtractionPlan()
+{}
+
+/** \brief Add a CAN message value to the plan, its extracted value will be written at the given index of the values array */
+bool CanMsgExtractionPlan::add(const ICanMsgValue& can_value, const size_t value_index)
+{
+    Field field;
+    const bool ret = compileField(can_value, field);
+    if (ret)
+    {
+        m_shifts.push_back(field.shift);
+        m_masks.push_back(field.mask);
+        m_sign_bits.push_back(field.sign_bit);
+        m_types.push_back(static_cast<uint8_t>(field.type));
+        m_value_indexes.push_back(static_cast<uint16_t>(value_index));
+        m_byte_orders.push_back(field.big_endian ? 1u : 0u);
+        m_has_big_endian = (m_has_big_endian || field.big_endian);
+    }
+
+    return ret;
+}
+
+/** \brief Remove all the values from the plan */
+void CanMsgExtractionPlan::clear()
+{
+    m_shifts.clear();
+    m_masks.clear();
+    m_sign_bits.clear();
+    m_types.clear();
+    m_value_indexes.clear();
+    m_byte_orders.clear();
+    m_has_big_endian = false;
+}
+
+/** \brief Compile the field of a CAN message value, return false if the value can't be extracted */
+bool CanMsgExtractionPlan::compileField(const ICanMsgValue& can_value, Field& field)
+{
+    const bool ret = getExtractionType(can_value.getType(), field.type);
+    if (ret)
+    {
+        const uint8_t size_in_bits = can_value.getSizeInBits();
+        field.mask = 0xFFFFFFFFFFFFFFFFull;
+        if (size_in_bits < 64u)
+        {
+            field.mask = ((1ull << size_in_bits) - 1u);
+        }
+        field.sign_bit = 0u;
+        if (can_value.getType() == CANMSGVALUE_INT)
+        {
+            field.sign_bit = (1ull << (size_in_bits - 1u));
+        }
+        field.shift = can_value.getStartBitPosition();
+        field.big_endian = (can_value.getByteOrder() == CANMSG_BIG_ENDIAN);
+    }
+
+    return ret;
+}
+
+/** \brief Get the number of bytes of the payload which contain a CAN message value */
+uint8_t CanMsgExtractionPlan::getPayloadSize(const ICanMsgValue& can_value)
+{
+    uint8_t size = CAN_MSG_MAX_LEN;
+    const uint64_t payload_mask = can_value.getPayloadMask();
+    while ((size > 0) && ((payload_mask >> ((size - 1u) * 8u)) == 0))
+    {
+        size--;
+    }
+    return size;
+}
+
+/** \brief Extract a value from an array of payload words into an array of values */
+void CanMsgExtractionPlan::extractColumn(const uint64_t* payloads, const size_t count, const Field& field, CanMsgValueData* values)
+{
+    // Dispatch on the byte order once so that the byte swap doesn't add a branch to the inner loops
+    if (field.big_endian)
+    {
+        extractColumn<true>(payloads, count, field, values);
+    }
+    else
+    {
+        extractColumn<false>(payloads, count, field, values);
+    }
+}
+
+/** \brief Extract a value from an array of payload words into an array of values */
+template <bool SWAP_BYTES>
+void CanMsgExtractionPlan::extractColumn(const uint64_t* payloads, const size_t count, const Field& field, CanMsgValueData* values)
+{
+    // Dispatch on the type once so that the inner loops can be vectorized by the compiler
+    const uint8_t shift = field.shift;
+    const uint64_t mask = field.mask;
+    switch (field.type)
+    {
+        case EXTRACT_BOOL:
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                values[i].uint_value = 0u;
+                values[i].bool_value = (((getWord<SWAP_BYTES>(payloads[i]) >> shift) & mask) != 0);
+            }
+            break;
+        }
+
+        case EXTRACT_FLOAT:
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint32_t raw_value_32 = static_cast<uint32_t>((getWord<SWAP_BYTES>(payloads[i]) >> shift) & mask);
+                memcpy(&values[i].float_value, &raw_value_32, sizeof(float));
+            }
+            break;
+        }
+
+        case EXTRACT_DOUBLE:
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint64_t raw_value = ((getWord<SWAP_BYTES>(payloads[i]) >> shift) & mask);
+                memcpy(&values[i].double_value, &raw_value, sizeof(double));
+            }
+            break;
+        }
+
+        default:
+        {
+            const uint64_t sign_bit = field.sign_bit;
+            for (size_t i = 0; i < count; i++)
+            {
+                values[i].uint_value = ((((getWord<SWAP_BYTES>(payloads[i]) >> shift) & mask) ^ sign_bit) - sign_bit);
+            }
+            break;
+        }
+    }
+}
+
+/** \brief Get the extraction type of a CAN message value type, return false if the type can't be extracted */
+bool CanMsgExtractionPlan::getExtractionType(const CanMsgValueType value_type, ExtractionType& type)
+{
+    bool ret = true;
+
+    switch (value_type)
+    {
+        case CANMSGVALUE_BOOL:
+        {
+            type = EXTRACT_BOOL;
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        case CANMSGVALUE_INT:
+        {
+            type = EXTRACT_INTEGER;
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            type = EXTRACT_FLOAT;
+            break;
+        }
+
+        case CANMSGVALUE_DOUBLE:
+        {
+            type = EXTRACT_DOUBLE;
+            break;
+        }
+
+        default:
+        {
+            ret = false;
+            break;
+        }
+    }
+
+    return ret;
+}
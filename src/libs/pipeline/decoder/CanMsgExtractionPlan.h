@@ -0,0 +1,292 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGEXTRACTIONPLAN_H
+#define CANMSGEXTRACTIONPLAN_H
+
+#include "CanData.h"
+#include "CanMsgValueData.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <cstdlib>
+#endif // _MSC_VER
+
+class ICanMsgValue;
+
+
+/** \brief Precompiled extraction of the values of a CAN message : the payload is loaded once as a 64 bits word
+           and each value is extracted with a shift, a mask and a sign extension stored as structure of arrays.
+           Big endian values are extracted the same way from the byte swapped payload word */
+class CanMsgExtractionPlan
+{
+    public:
+
+        /** \brief Extraction types */
+        enum ExtractionType
+        {
+            /** \brief Boolean */
+            EXTRACT_BOOL = 0,
+            /** \brief Unsigned or signed integer */
+            EXTRACT_INTEGER = 1u,
+            /** \brief Single precision floating point */
+            EXTRACT_FLOAT = 2u,
+            /** \brief Double precision floating point */
+            EXTRACT_DOUBLE = 3u
+        };
+
+        /** \brief Location and type of a value inside the payload word */
+        struct Field
+        {
+            /** \brief Mask of the value after shift */
+            uint64_t mask;
+            /** \brief Sign bit of the value after shift (0 for unsigned values) */
+            uint64_t sign_bit;
+            /** \brief Position of the value's first bit in the payload word */
+            uint8_t shift;
+            /** \brief Extraction type */
+            ExtractionType type;
+            /** \brief Indicate if the value is extracted from the byte swapped payload word */
+            bool big_endian;
+        };
+
+
+        /** \brief Constructor */
+        CanMsgExtractionPlan();
+
+        /** \brief Destructor */
+        virtual ~CanMsgExtractionPlan();
+
+
+        /** \brief Add a CAN message value to the plan, its extracted value will be written at the given index of the values array */
+        bool add(const ICanMsgValue& can_value, const size_t value_index);
+
+        /** \brief Remove all the values from the plan */
+        void clear();
+
+        /** \brief Get the number of values in the plan */
+        size_t size() const { return m_shifts.size(); }
+
+
+        /** \brief Extract all the values of the plan from a CAN message into an array of values */
+        void extract(const CanMsg& can_msg, CanMsgValueData* values) const
+        {
+            extract(loadPayload(can_msg), values);
+        }
+
+        /** \brief Extract all the values of the plan from a payload word into an array of values */
+        void extract(const uint64_t payload, CanMsgValueData* values) const
+        {
+            // The payload is swapped once for all the big endian values
+            const uint64_t words[2] = { payload, (m_has_big_endian ? swapBytes(payload) : payload) };
+            const size_t count = m_shifts.size();
+            for (size_t i = 0; i < count; i++)
+            {
+                values[m_value_indexes[i]] = extractValue(words[m_byte_orders[i]], m_shifts[i], m_masks[i], m_sign_bits[i], static_cast<ExtractionType>(m_types[i]));
+            }
+        }
+
+
+        /** \brief Compile the field of a CAN message value, return false if the value can't be extracted */
+        static bool compileField(const ICanMsgValue& can_value, Field& field);
+
+
+        /** \brief Get the extraction type of a CAN message value type, return false if the type can't be extracted */
+        static bool getExtractionType(const CanMsgValueType value_type, ExtractionType& type);
+
+        /** \brief Get the number of bytes of the payload which contain a CAN message value */
+        static uint8_t getPayloadSize(const ICanMsgValue& can_value);
+
+        /** \brief Reverse the byte order of a 64 bits word */
+        static uint64_t swapBytes(const uint64_t word)
+        {
+#if defined(_MSC_VER)
+            return _byteswap_uint64(word);
+#else
+            return __builtin_bswap64(word);
+#endif // _MSC_VER
+        }
+
+        /** \brief Get the payload word in the byte order of a field */
+        static uint64_t getFieldWord(const uint64_t payload, const Field& field)
+        {
+            return (field.big_endian ? swapBytes(payload) : payload);
+        }
+
+        /** \brief Load the payload of a CAN message as a 64 bits word */
+        static uint64_t loadPayload(const CanMsg& can_msg)
+        {
+            uint64_t payload;
+            memcpy(&payload, can_msg.data, sizeof(payload));
+            return payload;
+        }
+
+        /** \brief Extract a value from a payload word */
+        static CanMsgValueData extractValue(const uint64_t payload, const uint8_t shift, const uint64_t mask, const uint64_t sign_bit, const ExtractionType type)
+        {
+            CanMsgValueData value;
+            const uint64_t raw_value = ((payload >> shift) & mask);
+            switch (type)
+            {
+                case EXTRACT_BOOL:
+                {
+                    value.bool_value = (raw_value != 0);
+                    break;
+                }
+
+                case EXTRACT_FLOAT:
+                {
+                    const uint32_t raw_value_32 = static_cast<uint32_t>(raw_value);
+                    memcpy(&value.float_value, &raw_value_32, sizeof(value.float_value));
+                    break;
+                }
+
+                case EXTRACT_DOUBLE:
+                {
+                    memcpy(&value.double_value, &raw_value, sizeof(value.double_value));
+                    break;
+                }
+
+                default:
+                {
+                    // Sign extension is a no-op for unsigned values (sign bit = 0)
+                    value.uint_value = ((raw_value ^ sign_bit) - sign_bit);
+                    break;
+                }
+            }
+            return value;
+        }
+
+        /** \brief Extract a value from a payload word */
+        static CanMsgValueData extractValue(const uint64_t payload, const Field& field)
+        {
+            return extractValue(getFieldWord(payload, field), field.shift, field.mask, field.sign_bit, field.type);
+        }
+
+        /** \brief Extract the bits of a field from a payload word without sign extension */
+        static uint64_t extractBits(const uint64_t payload, const Field& field)
+        {
+            return ((getFieldWord(payload, field) >> field.shift) & field.mask);
+        }
+
+        /** \brief Store a payload word into the payload of a CAN message */
+        static void storePayload(const uint64_t payload, CanMsg& can_msg)
+        {
+            memcpy(can_msg.data, &payload, sizeof(payload));
+        }
+
+        /** \brief Indicate if an integer value can be inserted into a field without being truncated,
+                   the boolean and floating point values always fit */
+        static bool fitsInField(const Field& field, const CanMsgValueData& value)
+        {
+            bool ret = true;
+            if (field.type == EXTRACT_INTEGER)
+            {
+                if (field.sign_bit != 0u)
+                {
+                    // The bits above the sign bit must all be copies of the sign bit
+                    const uint64_t high_bits = (value.uint_value & ~(field.mask >> 1u));
+                    ret = ((high_bits == 0u) || (high_bits == ~(field.mask >> 1u)));
+                }
+                else
+                {
+                    ret = ((value.uint_value & ~field.mask) == 0u);
+                }
+            }
+            return ret;
+        }
+
+        /** \brief Insert a value into a payload word, the other bits of the payload are left unchanged */
+        static uint64_t insertValue(const uint64_t payload, const Field& field, const CanMsgValueData& value)
+        {
+            uint64_t raw_value;
+            switch (field.type)
+            {
+                case EXTRACT_BOOL:
+                {
+                    raw_value = (value.bool_value ? 1u : 0u);
+                    break;
+                }
+
+                case EXTRACT_FLOAT:
+                {
+                    uint32_t raw_value_32;
+                    memcpy(&raw_value_32, &value.float_value, sizeof(raw_value_32));
+                    raw_value = raw_value_32;
+                    break;
+                }
+
+                case EXTRACT_DOUBLE:
+                {
+                    memcpy(&raw_value, &value.double_value, sizeof(raw_value));
+                    break;
+                }
+
+                default:
+                {
+                    // Signed values are truncated to their size in two's complement
+                    raw_value = value.uint_value;
+                    break;
+                }
+            }
+            const uint64_t word = getFieldWord(payload, field);
+            return getFieldWord(((word & ~(field.mask << field.shift)) | ((raw_value & field.mask) << field.shift)), field);
+        }
+
+        /** \brief Extract a value from an array of payload words into an array of values */
+        static void extractColumn(const uint64_t* payloads, const size_t count, const Field& field, CanMsgValueData* values);
+
+
+    private:
+
+        /** \brief Position of the first bit of each value in the payload word */
+        std::vector<uint8_t> m_shifts;
+
+        /** \brief Mask of each value after shift */
+        std::vector<uint64_t> m_masks;
+
+        /** \brief Sign bit of each value after shift (0 for unsigned values) */
+        std::vector<uint64_t> m_sign_bits;
+
+        /** \brief Extraction type of each value */
+        std::vector<uint8_t> m_types;
+
+        /** \brief Index of each value in the values array */
+        std::vector<uint16_t> m_value_indexes;
+
+        /** \brief Byte order of each value (index of the payload word to extract from) */
+        std::vector<uint8_t> m_byte_orders;
+
+        /** \brief Indicate if the plan contains big endian values */
+        bool m_has_big_endian;
+
+
+        /** \brief Get a payload word in the given byte order */
+        template <bool SWAP_BYTES>
+        static uint64_t getWord(const uint64_t payload) { return (SWAP_BYTES ? swapBytes(payload) : payload); }
+
+        /** \brief Extract a value from an array of payload words into an array of values */
+        template <bool SWAP_BYTES>
+        static void extractColumn(const uint64_t* payloads, const size_t count, const Field& field, CanMsgValueData* values);
+};
+
+
+#endif // CANMSGEXTRACTIONPLAN_H
@@ -0,0 +1,276 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgNameIndex.h"
+#include "ICanMsgDatabase.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+
+/** \brief Handle returned when a name is not found */
+const CanMsgNameIndex::handle_t CanMsgNameIndex::INVALID_HANDLE;
+
+/** \brief Average number of names in a bucket of the perfect hash, the buckets with more names
+           are harder to place once most of the slots are taken */
+static const size_t NAMES_PER_BUCKET = 2u;
+
+/** \brief Number of seeds tried to build a perfect hash */
+static const uint64_t MAX_SEEDS = 16u;
+
+
+/** \brief Constructor */
+CanMsgNameIndex::CanMsgNameIndex()
+: m_can_msgs()
+, m_first_signals()
+, m_signals()
+, m_can_msg_hash()
+, m_signal_hash()
+{}
+
+/** \brief Destructor */
+CanMsgNameIndex::~CanMsgNameIndex()
+{}
+
+/** \brief Build the index from the CAN messages of a database, return false if the perfect hash can't be built */
+bool CanMsgNameIndex::build(const ICanMsgDatabase& can_msg_database)
+{
+    // Number the CAN messages and the signals in the database's iteration order
+    vector<const CanMsgDesc*> can_msgs;
+    const auto& db_can_msgs = can_msg_database.getCanMsgs();
+    for (auto iter = db_can_msgs.cbegin(); iter != db_can_msgs.cend(); ++iter)
+    {
+        can_msgs.push_back(iter->second.get());
+    }
+
+    return build(can_msgs);
+}
+
+/** \brief Build the index from a list of CAN messages, the handles follow the order of the list */
+bool CanMsgNameIndex::build(const std::vector<const CanMsgDesc*>& can_msgs)
+{
+    clear();
+
+    // Number the CAN messages and the signals in the list's order
+    for (size_t msg_index = 0; msg_index < can_msgs.size(); msg_index++)
+    {
+        const CanMsgDesc* can_msg = can_msgs[msg_index];
+        m_can_msgs.push_back(can_msg);
+        m_first_signals.push_back(static_cast<handle_t>(m_signals.size()));
+
+        const auto& signals = can_msg->getSignals();
+        for (size_t i = 0; i < signals.size(); i++)
+        {
+            SignalEntry entry;
+            entry.can_msg = can_msg;
+            entry.signal = signals[i].get();
+            entry.signal_index = static_cast<uint32_t>(i);
+            entry.next = INVALID_HANDLE;
+            m_signals.push_back(entry);
+        }
+    }
+
+    // Hash the first CAN message of each distinct name
+    vector<string_view> names;
+    vector<handle_t> handles;
+    unordered_map<string_view, handle_t> last_handles;
+    for (handle_t handle = 0; handle < m_can_msgs.size(); handle++)
+    {
+        const string& name = getCanMsgName(handle);
+        if (last_handles.emplace(name, handle).second)
+        {
+            names.push_back(name);
+            handles.push_back(handle);
+        }
+    }
+    bool ret = m_can_msg_hash.build(names, handles);
+
+    // Hash the first signal of each distinct name and chain the next ones to it
+    names.clear();
+    handles.clear();
+    last_handles.clear();
+    for (handle_t handle = 0; ret && (handle < m_signals.size()); handle++)
+    {
+        const string& name = getSignalName(handle);
+        auto result = last_handles.emplace(name, handle);
+        if (result.second)
+        {
+            names.push_back(name);
+            handles.push_back(handle);
+        }
+        else
+        {
+            m_signals[result.first->second].next = handle;
+            result.first->second = handle;
+        }
+    }
+    ret = (ret && m_signal_hash.build(names, handles));
+    if (!ret)
+    {
+        clear();
+    }
+
+    return ret;
+}
+
+/** \brief Empty the index */
+void CanMsgNameIndex::clear()
+{
+    m_can_msgs.clear();
+    m_first_signals.clear();
+    m_signals.clear();
+    m_can_msg_hash.clear();
+    m_signal_hash.clear();
+}
+
+
+/** \brief Flag of the displacements which are the slot of the single name of their bucket */
+const uint32_t CanMsgNameIndex::PerfectHash::DIRECT_SLOT;
+
+/** \brief Constructor */
+CanMsgNameIndex::PerfectHash::PerfectHash()
+: m_seed(0u)
+, m_displacements()
+, m_slots()
+{}
+
+/** \brief Build the hash from a list of distinct names, the value of each name is stored in its slot */
+bool CanMsgNameIndex::PerfectHash::build(const std::vector<std::string_view>& names, const std::vector<handle_t>& values)
+{
+    bool ret = true;
+
+    clear();
+    if (!names.empty())
+    {
+        // Another seed gives other buckets and positions when the names can't be placed
+        ret = false;
+        for (uint64_t seed = 0; !ret && (seed < MAX_SEEDS); seed++)
+        {
+            ret = tryBuild(names, values, seed);
+        }
+        if (!ret)
+        {
+            clear();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Empty the hash */
+void CanMsgNameIndex::PerfectHash::clear()
+{
+    m_seed = 0u;
+    m_displacements.clear();
+    m_slots.clear();
+}
+
+/** \brief Try to build the hash with a seed */
+bool CanMsgNameIndex::PerfectHash::tryBuild(const std::vector<std::string_view>& names, const std::vector<handle_t>& values, const uint64_t seed)
+{
+    // The slots must be addressable by a direct displacement
+    const size_t count = names.size();
+    bool ret = (count < DIRECT_SLOT);
+
+    // Dispatch the names into the buckets, the names of a bucket are stored
+    // contiguously starting at the bucket's first index
+    const size_t bucket_count = ((count + NAMES_PER_BUCKET - 1u) / NAMES_PER_BUCKET);
+    vector<uint64_t> hashes(count);
+    vector<uint32_t> bucket_firsts(bucket_count + 1u, 0u);
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hashName(names[i], seed);
+        bucket_firsts[(hashes[i] % bucket_count) + 1u]++;
+    }
+    size_t max_bucket_size = 0;
+    for (size_t i = 0; i < bucket_count; i++)
+    {
+        max_bucket_size = max<size_t>(max_bucket_size, bucket_firsts[i + 1u]);
+        bucket_firsts[i + 1u] += bucket_firsts[i];
+    }
+    vector<uint32_t> bucket_names(count);
+    vector<uint32_t> bucket_ends(bucket_firsts.begin(), bucket_firsts.end() - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        bucket_names[bucket_ends[hashes[i] % bucket_count]++] = static_cast<uint32_t>(i);
+    }
+
+    // Place the largest buckets first while most of the slots are free
+    vector<uint32_t> size_firsts(max_bucket_size + 2u, 0u);
+    for (size_t i = 0; i < bucket_count; i++)
+    {
+        size_firsts[max_bucket_size - (bucket_firsts[i + 1u] - bucket_firsts[i]) + 1u]++;
+    }
+    partial_sum(size_firsts.begin(), size_firsts.end(), size_firsts.begin());
+    vector<uint32_t> order(bucket_count);
+    for (size_t i = 0; i < bucket_count; i++)
+    {
+        order[size_firsts[max_bucket_size - (bucket_firsts[i + 1u] - bucket_firsts[i])]++] = static_cast<uint32_t>(i);
+    }
+
+    // Look for the first displacement which puts all the names of a bucket into free slots
+    const uint32_t max_displacement = static_cast<uint32_t>(16u * count + 64u);
+    m_seed = seed;
+    m_displacements.assign(bucket_count, 0u);
+    m_slots.assign(count, INVALID_HANDLE);
+    vector<size_t> slots;
+    size_t free_slot = 0;
+    for (size_t i = 0; ret && (i < bucket_count); i++)
+    {
+        const uint32_t* const bucket = &bucket_names[bucket_firsts[order[i]]];
+        const size_t bucket_size = (bucket_firsts[order[i] + 1u] - bucket_firsts[order[i]]);
+        bool placed = (bucket_size == 0u);
+        if (bucket_size == 1u)
+        {
+            // The single names take the remaining free slots in order
+            while (m_slots[free_slot] != INVALID_HANDLE)
+            {
+                free_slot++;
+            }
+            m_slots[free_slot] = values[bucket[0]];
+            m_displacements[order[i]] = (static_cast<uint32_t>(free_slot) | DIRECT_SLOT);
+            placed = true;
+        }
+        for (uint32_t displacement = 0; !placed && (displacement < DIRECT_SLOT) && (displacement < max_displacement); displacement++)
+        {
+            placed = true;
+            slots.clear();
+            for (size_t j = 0; placed && (j < bucket_size); j++)
+            {
+                const size_t slot = getSlot(hashes[bucket[j]], displacement, count);
+                placed = ((m_slots[slot] == INVALID_HANDLE) && (std::find(slots.begin(), slots.end(), slot) == slots.end()));
+                slots.push_back(slot);
+            }
+            if (placed)
+            {
+                for (size_t j = 0; j < bucket_size; j++)
+                {
+                    m_slots[slots[j]] = values[bucket[j]];
+                }
+                m_displacements[order[i]] = displacement;
+            }
+        }
+        ret = placed;
+    }
+
+    return ret;
+}
@@ -0,0 +1,225 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGNAMEINDEX_H
+#define CANMSGNAMEINDEX_H
+
+#include "CanMsgDesc.h"
+#include "CanMsgSignal.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class ICanMsgDatabase;
+
+
+/** \brief Lookup index of the CAN messages and signals of a database by name : a minimal perfect hash of the distinct names
+           gives the handle of a name with a single probe and without any allocation. The handles are stable for the lifetime
+           of the database and follow its iteration order : the message handles are the positions of the messages and the
+           signal handles number the signals message after message, so that users can attach their own data to each signal
+           in a flat array indexed by handle. The signals sharing a name are chained in handle order */
+class CanMsgNameIndex
+{
+    public:
+
+        /** \brief Handle of a CAN message or of a signal */
+        typedef uint32_t handle_t;
+
+        /** \brief Handle returned when a name is not found */
+        static const handle_t INVALID_HANDLE = 0xFFFFFFFFu;
+
+        /** \brief Indexed signal */
+        struct SignalEntry
+        {
+            /** \brief CAN message of the signal */
+            const CanMsgDesc* can_msg;
+            /** \brief Signal */
+            const CanMsgSignal* signal;
+            /** \brief Index of the signal in the signals of its CAN message */
+            uint32_t signal_index;
+            /** \brief Handle of the next signal with the same name (INVALID_HANDLE if there is none) */
+            handle_t next;
+        };
+
+
+        /** \brief Constructor */
+        CanMsgNameIndex();
+
+        /** \brief Destructor */
+        virtual ~CanMsgNameIndex();
+
+
+        /** \brief Build the index from the CAN messages of a database, return false if the perfect hash can't be built */
+        bool build(const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Build the index from a list of CAN messages, the handles follow the order of the list.
+                   Return false if the perfect hash can't be built */
+        bool build(const std::vector<const CanMsgDesc*>& can_msgs);
+
+        /** \brief Empty the index */
+        void clear();
+
+        /** \brief Indicate if the index is empty */
+        bool empty() const { return m_can_msgs.empty(); }
+
+
+        /** \brief Get the number of indexed CAN messages */
+        size_t getCanMsgCount() const { return m_can_msgs.size(); }
+
+        /** \brief Get the number of indexed signals */
+        size_t getSignalCount() const { return m_signals.size(); }
+
+        /** \brief Get an indexed CAN message, the handle must be valid */
+        const CanMsgDesc* getCanMsg(const handle_t can_msg_handle) const { return m_can_msgs[can_msg_handle]; }
+
+        /** \brief Get an indexed signal, the handle must be valid */
+        const SignalEntry& getSignal(const handle_t signal_handle) const { return m_signals[signal_handle]; }
+
+        /** \brief Get the handle of a signal from its index in the signals of a CAN message, the CAN message handle must be valid */
+        handle_t getSignalHandle(const handle_t can_msg_handle, const size_t signal_index) const { return (m_first_signals[can_msg_handle] + static_cast<handle_t>(signal_index)); }
+
+
+        /** \brief Look for the first CAN message with a name, return INVALID_HANDLE if not found */
+        handle_t findCanMsg(const std::string_view& name) const
+        {
+            const handle_t handle = m_can_msg_hash.find(name);
+            return (((handle != INVALID_HANDLE) && (getCanMsgName(handle) == name)) ? handle : INVALID_HANDLE);
+        }
+
+        /** \brief Look for the first signal with a name, the next ones are chained to it, return INVALID_HANDLE if not found */
+        handle_t findSignal(const std::string_view& name) const
+        {
+            const handle_t handle = m_signal_hash.find(name);
+            return (((handle != INVALID_HANDLE) && (getSignalName(handle) == name)) ? handle : INVALID_HANDLE);
+        }
+
+
+    private:
+
+        /** \brief Minimal perfect hash of a set of distinct names using hash and displace : the names are dispatched
+                   into buckets and the displacement of each bucket is searched so that all the names land in distinct
+                   slots of a table which has exactly one slot per name. The buckets with a single name are placed last
+                   and directly store the slot of their name */
+        class PerfectHash
+        {
+            public:
+
+                /** \brief Constructor */
+                PerfectHash();
+
+
+                /** \brief Build the hash from a list of distinct names, the value of each name is stored in its slot */
+                bool build(const std::vector<std::string_view>& names, const std::vector<handle_t>& values);
+
+                /** \brief Empty the hash */
+                void clear();
+
+                /** \brief Get the value of the slot of a name, the name must be checked against the value
+                           since any name lands in a slot (INVALID_HANDLE if the hash is empty) */
+                handle_t find(const std::string_view& name) const
+                {
+                    handle_t value = INVALID_HANDLE;
+                    if (!m_slots.empty())
+                    {
+                        const uint64_t hash = hashName(name, m_seed);
+                        const uint32_t displacement = m_displacements[hash % m_displacements.size()];
+                        if ((displacement & DIRECT_SLOT) != 0u)
+                        {
+                            value = m_slots[displacement & ~DIRECT_SLOT];
+                        }
+                        else
+                        {
+                            value = m_slots[getSlot(hash, displacement, m_slots.size())];
+                        }
+                    }
+                    return value;
+                }
+
+            private:
+
+                /** \brief Flag of the displacements which are the slot of the single name of their bucket */
+                static const uint32_t DIRECT_SLOT = 0x80000000u;
+
+
+                /** \brief Seed of the names hash */
+                uint64_t m_seed;
+
+                /** \brief Displacement of each bucket */
+                std::vector<uint32_t> m_displacements;
+
+                /** \brief Value of each slot */
+                std::vector<handle_t> m_slots;
+
+
+                /** \brief Compute the seeded FNV-1a hash of a name */
+                static uint64_t hashName(const std::string_view& name, const uint64_t seed)
+                {
+                    uint64_t hash = (14695981039346656037ull ^ seed);
+                    for (size_t i = 0; i < name.size(); i++)
+                    {
+                        hash ^= static_cast<uint8_t>(name[i]);
+                        hash *= 1099511628211ull;
+                    }
+                    return hash;
+                }
+
+                /** \brief Get the slot of a name hash for a displacement */
+                static size_t getSlot(const uint64_t hash, const uint32_t displacement, const size_t slot_count)
+                {
+                    // Finalizer of splitmix64 so that each displacement gives an independent position
+                    uint64_t x = hash + (displacement * 0x9E3779B97F4A7C15ull);
+                    x = (x ^ (x >> 30u)) * 0xBF58476D1CE4E5B9ull;
+                    x = (x ^ (x >> 27u)) * 0x94D049BB133111EBull;
+                    x = (x ^ (x >> 31u));
+                    return static_cast<size_t>(x % slot_count);
+                }
+
+                /** \brief Try to build the hash with a seed */
+                bool tryBuild(const std::vector<std::string_view>& names, const std::vector<handle_t>& values, const uint64_t seed);
+        };
+
+
+        /** \brief Indexed CAN messages */
+        std::vector<const CanMsgDesc*> m_can_msgs;
+
+        /** \brief Handle of the first signal of each CAN message */
+        std::vector<handle_t> m_first_signals;
+
+        /** \brief Indexed signals */
+        std::vector<SignalEntry> m_signals;
+
+        /** \brief Perfect hash of the CAN message names */
+        PerfectHash m_can_msg_hash;
+
+        /** \brief Perfect hash of the signal names */
+        PerfectHash m_signal_hash;
+
+
+        /** \brief Get the name of a CAN message */
+        const std::string& getCanMsgName(const handle_t can_msg_handle) const { return m_can_msgs[can_msg_handle]->getName(); }
+
+        /** \brief Get the name of a signal */
+        const std::string& getSignalName(const handle_t signal_handle) const { return m_signals[signal_handle].signal->getName(); }
+};
+
+
+#endif // CANMSGNAMEINDEX_H
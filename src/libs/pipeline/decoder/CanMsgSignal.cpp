@@ -19,14 +19,16 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CanMsgSignal.h"
 
+/** \brief Name and unit of the signals which have not been named */
+static const std::string EMPTY_STRING;
 
 
 /** \brief Constructor */
 CanMsgSignal::CanMsgSignal()
-: m_name("")
-, m_unit("")
-, m_raw_type("")
-, m_converted_type("")
+: m_name(&EMPTY_STRING)
+, m_unit(&EMPTY_STRING)
+, m_raw_type(CANMSGVALUE_UNKNOWN)
+, m_converted_type(CANMSGVALUE_UNKNOWN)
 , m_can_value(nullptr)
 , m_converter(nullptr)
 {}
@@ -75,51 +77,10 @@ bool CanMsgSignal::setConverter(ICanMsgValueConverter& converter)
     return ret;
 }
 
-/** \brief Get the raw value */
-const void* CanMsgSignal::getRawValue() const
+/** \brief Set a converter shared with other signals, the signal's value must be set before and the
+           converter must already be configured for its type since it is left unmodified */
+void CanMsgSignal::setSharedConverter(ICanMsgValueConverter& converter)
 {
-    const void* ret = nullptr;
-
-    if (m_can_value != nullptr)
-    {
-        ret = m_can_value->getValue();
-    }
-
-    return ret;
-}
-
-/** \brief Get the converted value */
-const void* CanMsgSignal::getConvertedValue() const
-{
-    const void* ret = nullptr;
-
-    if (m_converter != nullptr)
-    {
-        ret = m_converter->getValue();
-    }
-    else
-    {
-        if (m_can_value != nullptr)
-        {
-            ret = m_can_value->getValue();
-        }
-    }
-
-    return ret;
-}
-
-/** \brief Update the raw and converted values from a CAN message */
-void CanMsgSignal::updateValues(const CanMsg& can_msg)
-{
-    // Update the raw value
-    if (m_can_value != nullptr)
-    {
-        m_can_value->updateValue(can_msg);
-
-        // Update the converted value
-        if (m_converter != nullptr)
-        {
-            m_converter->convertValue();
-        }
-    }
+    m_converter = &converter;
+    m_converted_type = m_converter->getOutputType();
 }
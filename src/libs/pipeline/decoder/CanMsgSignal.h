@@ -40,24 +40,28 @@ class CanMsgSignal
 
 
         /** \brief Get the signal's name */
-        const std::string& getName() const { return m_name; }
+        const std::string& getName() const { return (*m_name); }
 
-        /** \brief Set the signal's name */
-        void setName(const std::string& name) { m_name = name; }
+        /** \brief Set the signal's name, the string is not copied and must outlive the signal
+                   (the databases intern it in their storage) */
+        void setName(const std::string& name) { m_name = &name; }
+        void setName(std::string&& name) = delete;
 
 
         /** \brief Get the signal's unit */
-        const std::string& getUnit() const { return m_unit; }
+        const std::string& getUnit() const { return (*m_unit); }
 
-        /** \brief Set the signal's unit */
-        void setUnit(const std::string& unit) { m_unit = unit; }
+        /** \brief Set the signal's unit, the string is not copied and must outlive the signal
+                   (the databases intern it in their storage) */
+        void setUnit(const std::string& unit) { m_unit = &unit; }
+        void setUnit(std::string&& unit) = delete;
 
 
         /** \brief Get the raw value type */
-        const std::string& getRawValueType() const { return m_raw_type; }
+        CanMsgValueType getRawValueType() const { return m_raw_type; }
 
         /** \brief Get the converted value type */
-        const std::string& getConvertedValueType() const { return m_converted_type; }
+        CanMsgValueType getConvertedValueType() const { return m_converted_type; }
 
 
         /** \brief Set the signal's value */
@@ -66,38 +70,30 @@ class CanMsgSignal
         /** \brief Set the signal's converter */
         bool setConverter(ICanMsgValueConverter& converter);
 
+        /** \brief Set a converter shared with other signals, the signal's value must be set before and the
+                   converter must already be configured for its type since it is left unmodified */
+        void setSharedConverter(ICanMsgValueConverter& converter);
 
-        /** \brief Get the raw value */
-        const void* getRawValue() const;
 
-        /** \brief Get the converted value */
-        const void* getConvertedValue() const;
-
-        /** \brief Get the raw value */
-        template <typename ValueType>
-        const ValueType& getRawValue() const { return *reinterpret_cast<const ValueType*>(m_can_value->getValue()); }
-
-        /** \brief Get the converted value */
-        template <typename ValueType>
-        const ValueType& getConvertedValue() const { return *reinterpret_cast<const ValueType*>(m_converter->getValue()); }
-
-        /** \brief Update the raw and converted values from a CAN message */
-        void updateValues(const CanMsg& can_msg);
+        /** \brief Get the signal's value */
+        const ICanMsgValue* getCanMsgValue() const { return m_can_value; }
+        /** \brief Get the signal's converter */
+        const ICanMsgValueConverter* getConverter() const { return m_converter; }
 
 
     private:
 
         /** \brief Name */
-        std::string m_name;
+        const std::string* m_name;
 
         /** \brief Unit */
-        std::string m_unit;
+        const std::string* m_unit;
 
         /** \brief Raw value type */
-        std::string m_raw_type;
+        CanMsgValueType m_raw_type;
 
         /** \brief Converted value type */
-        std::string m_converted_type;
+        CanMsgValueType m_converted_type;
 
         /** \brief Value */
         ICanMsgValue* m_can_value;
@@ -0,0 +1,216 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgSignalChangeDetector.h"
+#include "ICanMsgDatabase.h"
+#include "CanMsgSignal.h"
+
+#include <cmath>
+
+using namespace std;
+
+
+/** \brief Constructor, the database must be loaded and must outlive the detector */
+CanMsgSignalChangeDetector::CanMsgSignalChangeDetector(const ICanMsgDatabase& can_msg_database)
+: m_can_msg_index()
+, m_lazy_name_index()
+, m_name_index(can_msg_database.isLazy() ? m_lazy_name_index : can_msg_database.getNameIndex())
+, m_first_states()
+, m_states()
+, m_listener(nullptr)
+{
+    // A database which builds its CAN messages on demand builds them all now so that each decoded message has its states
+    m_can_msg_index.build(can_msg_database);
+    if (can_msg_database.isLazy())
+    {
+        // Index the names of the built messages in the order of the states
+        m_lazy_name_index.build(m_can_msg_index.getCanMsgs());
+    }
+
+    // Allocate the states of the signals of each message
+    const auto& can_msgs = m_can_msg_index.getCanMsgs();
+    for (size_t msg_index = 0; msg_index < can_msgs.size(); msg_index++)
+    {
+        m_first_states.push_back(m_states.size());
+
+        const auto& signals = can_msgs[msg_index]->getSignals();
+        for (size_t i = 0; i < signals.size(); i++)
+        {
+            SignalState state;
+            state.last_value.uint_value = 0u;
+            state.absolute_deadband = 0.;
+            state.relative_deadband = 0.;
+            state.type = signals[i]->getConvertedValueType();
+            state.valid = false;
+            m_states.push_back(state);
+        }
+    }
+}
+
+/** \brief Destructor */
+CanMsgSignalChangeDetector::~CanMsgSignalChangeDetector()
+{}
+
+/** \brief Set the deadbands of a signal */
+bool CanMsgSignalChangeDetector::setDeadband(const std::string& signal_name, const double absolute_deadband, const double relative_deadband)
+{
+    bool ret = false;
+
+    // The signals sharing the name are chained in the name index
+    for (CanMsgNameIndex::handle_t handle = m_name_index.findSignal(signal_name); handle != CanMsgNameIndex::INVALID_HANDLE; handle = m_name_index.getSignal(handle).next)
+    {
+        ret = (setDeadband(handle, absolute_deadband, relative_deadband) || ret);
+    }
+
+    return ret;
+}
+
+/** \brief Set the deadbands of a signal identified by its handle in the name index of the database (0 = no deadband),
+           return false if the handle is invalid */
+bool CanMsgSignalChangeDetector::setDeadband(const CanMsgNameIndex::handle_t signal_handle, const double absolute_deadband, const double relative_deadband)
+{
+    // The states are allocated in the database's iteration order like the signal handles
+    const bool ret = ((signal_handle < m_name_index.getSignalCount()) && (signal_handle < m_states.size()));
+    if (ret)
+    {
+        SignalState& state = m_states[signal_handle];
+        state.absolute_deadband = absolute_deadband;
+        state.relative_deadband = relative_deadband;
+    }
+
+    return ret;
+}
+
+/** \brief Set the deadbands of all the signals */
+void CanMsgSignalChangeDetector::setDeadband(const double absolute_deadband, const double relative_deadband)
+{
+    for (size_t i = 0; i < m_states.size(); i++)
+    {
+        m_states[i].absolute_deadband = absolute_deadband;
+        m_states[i].relative_deadband = relative_deadband;
+    }
+}
+
+/** \brief Forget the last notified values so that the next value of each signal is notified */
+void CanMsgSignalChangeDetector::reset()
+{
+    for (size_t i = 0; i < m_states.size(); i++)
+    {
+        m_states[i].valid = false;
+    }
+}
+
+/** \brief Called when message has been decoded */
+void CanMsgSignalChangeDetector::canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame)
+{
+    const CanMsgDesc* can_msg_desc = decoded_frame.getCanMsg();
+    const uint32_t position = m_can_msg_index.findPosition(can_msg_desc->getId(), can_msg_desc->isExtented());
+    if ((position != CanMsgDescIndex::NOT_FOUND) && (m_can_msg_index.getCanMsgs()[position] == can_msg_desc))
+    {
+        // Compare the decoded signals with their last notified value
+        SignalState* states = &m_states[m_first_states[position]];
+        const vector<size_t>& decoded_signals = decoded_frame.getDecodedSignals();
+        for (size_t i = 0; i < decoded_signals.size(); i++)
+        {
+            const size_t signal_index = decoded_signals[i];
+            SignalState& state = states[signal_index];
+            const CanMsgValueData& value = decoded_frame.getConvertedValue(signal_index);
+            if (hasChanged(state, value))
+            {
+                state.last_value = value;
+                state.valid = true;
+                if (m_listener != nullptr)
+                {
+                    m_listener->signalChanged(can_msg, *can_msg_desc->getSignals()[signal_index], value, decoded_frame.getRawValue(signal_index));
+                }
+            }
+        }
+    }
+}
+
+/** \brief Check if a value has changed enough to be notified */
+bool CanMsgSignalChangeDetector::hasChanged(const SignalState& state, const CanMsgValueData& value)
+{
+    bool ret = false;
+    double delta = 0.;
+    double last_value = 0.;
+
+    switch (state.type)
+    {
+        case CANMSGVALUE_BOOL:
+        {
+            ret = (!state.valid || (value.bool_value != state.last_value.bool_value));
+            break;
+        }
+
+        case CANMSGVALUE_STRING:
+        {
+            // The strings are interned by the converters : same label, same pointer
+            ret = (!state.valid || (value.string_value != state.last_value.string_value));
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        {
+            last_value = static_cast<double>(state.last_value.uint_value);
+            delta = static_cast<double>(value.uint_value) - last_value;
+            ret = (!state.valid || (value.uint_value != state.last_value.uint_value));
+            break;
+        }
+
+        case CANMSGVALUE_INT:
+        {
+            last_value = static_cast<double>(state.last_value.int_value);
+            delta = static_cast<double>(value.int_value) - last_value;
+            ret = (!state.valid || (value.int_value != state.last_value.int_value));
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            last_value = static_cast<double>(state.last_value.float_value);
+            delta = static_cast<double>(value.float_value) - last_value;
+            ret = (!state.valid || (value.float_value != state.last_value.float_value));
+            break;
+        }
+
+        case CANMSGVALUE_DOUBLE:
+        {
+            last_value = state.last_value.double_value;
+            delta = value.double_value - last_value;
+            ret = (!state.valid || (value.double_value != state.last_value.double_value));
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+
+    // Apply the deadbands on the numeric values
+    if (ret && state.valid && ((state.absolute_deadband > 0.) || (state.relative_deadband > 0.)))
+    {
+        delta = fabs(delta);
+        ret = (((state.absolute_deadband > 0.) && (delta > state.absolute_deadband)) ||
+               ((state.relative_deadband > 0.) && (delta > (state.relative_deadband * fabs(last_value)))));
+    }
+
+    return ret;
+}
@@ -0,0 +1,126 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGSIGNALCHANGEDETECTOR_H
+#define CANMSGSIGNALCHANGEDETECTOR_H
+
+#include "CanMsgDecoder.h"
+
+#include <string>
+#include <vector>
+
+class CanMsgSignal;
+
+
+/** \brief Interface for all listener implementations of the signal change detector */
+class ICanMsgSignalChangeListener
+{
+    public:
+
+        /** \brief Destructor */
+        virtual ~ICanMsgSignalChangeListener() {}
+
+
+        /** \brief Called when the converted value of a signal has changed, the values are only valid during the call */
+        virtual void signalChanged(const CanMsg& can_msg, const CanMsgSignal& signal, const CanMsgValueData& converted_value, const CanMsgValueData& raw_value) = 0;
+};
+
+
+/** \brief Decoder listener which notifies the signals whose converted value has changed since the last notification.
+           Numeric values can be filtered with an absolute and/or a relative deadband : a change is notified only when
+           it exceeds one of the configured deadbands. The last notified values are stored in a contiguous array
+           indexed by signal so that no allocation is done while decoding */
+class CanMsgSignalChangeDetector : public ICanMsgDecoderListener
+{
+    public:
+
+
+        /** \brief Constructor, the database must be loaded and must outlive the detector. All the CAN messages
+                   of a database which builds them on demand are built */
+        CanMsgSignalChangeDetector(const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Destructor */
+        virtual ~CanMsgSignalChangeDetector();
+
+
+        /** \brief Set the listener to signal changes */
+        void setListener(ICanMsgSignalChangeListener& listener) { m_listener = &listener; }
+
+        /** \brief Set the deadbands of a signal (0 = no deadband), the relative deadband is a ratio
+                   of the last notified value. Return false if the signal doesn't exist in the database */
+        bool setDeadband(const std::string& signal_name, const double absolute_deadband, const double relative_deadband);
+
+        /** \brief Set the deadbands of a signal identified by its handle in the name index of the database (0 = no deadband),
+                   return false if the handle is invalid */
+        bool setDeadband(const CanMsgNameIndex::handle_t signal_handle, const double absolute_deadband, const double relative_deadband);
+
+        /** \brief Set the deadbands of all the signals (0 = no deadband) */
+        void setDeadband(const double absolute_deadband, const double relative_deadband);
+
+        /** \brief Forget the last notified values so that the next value of each signal is notified */
+        void reset();
+
+
+        /** \brief Called when message has been decoded */
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) override;
+
+
+    private:
+
+        /** \brief Last notified value and deadbands of a signal */
+        struct SignalState
+        {
+            /** \brief Last notified value */
+            CanMsgValueData last_value;
+            /** \brief Absolute deadband */
+            double absolute_deadband;
+            /** \brief Relative deadband */
+            double relative_deadband;
+            /** \brief Type of the converted value */
+            CanMsgValueType type;
+            /** \brief Indicate if a value has already been notified */
+            bool valid;
+        };
+
+
+        /** \brief Lookup index of the CAN messages database */
+        CanMsgDescIndex m_can_msg_index;
+
+        /** \brief Name index of the CAN messages built on demand, a database which builds them on demand has an empty name index */
+        CanMsgNameIndex m_lazy_name_index;
+
+        /** \brief Name index of the CAN messages database */
+        const CanMsgNameIndex& m_name_index;
+
+        /** \brief Index of the state of the first signal of each CAN message, at the position of the message in the lookup index */
+        std::vector<size_t> m_first_states;
+
+        /** \brief States of all the signals of the database, in the order of the signal handles */
+        std::vector<SignalState> m_states;
+
+        /** \brief Listener */
+        ICanMsgSignalChangeListener* m_listener;
+
+
+        /** \brief Check if a value has changed enough to be notified */
+        static bool hasChanged(const SignalState& state, const CanMsgValueData& value);
+};
+
+
+#endif // CANMSGSIGNALCHANGEDETECTOR_H
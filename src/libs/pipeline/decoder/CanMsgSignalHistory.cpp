@@ -0,0 +1,299 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CanMsgSignalHistory.h"
+#include "ICanMsgDatabase.h"
+#include "CanMsgSignal.h"
+#include "DecodedFrame.h"
+
+using namespace std;
+
+
+/** \brief Constructor, the database must be loaded and must outlive the history */
+CanMsgSignalHistory::CanMsgSignalHistory(const ICanMsgDatabase& can_msg_database, const size_t samples_per_signal)
+: m_samples_per_signal(samples_per_signal)
+, m_can_msg_index()
+, m_lazy_name_index()
+, m_name_index(can_msg_database.isLazy() ? m_lazy_name_index : can_msg_database.getNameIndex())
+, m_first_rings()
+, m_rings()
+, m_samples()
+, m_mutex()
+{
+    // The CAN messages built on demand are all built here, the decoder gets the same descriptions when it loads them
+    m_can_msg_index.build(can_msg_database);
+    if (can_msg_database.isLazy())
+    {
+        // The signals are found by name through their own index since the database doesn't index the built messages
+        m_lazy_name_index.build(m_can_msg_index.getCanMsgs());
+    }
+
+    // Allocate the rings of the signals of each message
+    const auto& can_msgs = m_can_msg_index.getCanMsgs();
+    for (size_t msg_index = 0; msg_index < can_msgs.size(); msg_index++)
+    {
+        m_first_rings.push_back(m_rings.size());
+
+        const auto& signals = can_msgs[msg_index]->getSignals();
+        for (size_t i = 0; i < signals.size(); i++)
+        {
+            const CanMsgSignal& signal = *signals[i];
+            Ring ring;
+            ring.first = m_rings.size() * m_samples_per_signal;
+            ring.head = 0;
+            ring.count = 0;
+            ring.raw = (signal.getConvertedValueType() == CANMSGVALUE_STRING);
+            ring.type = (ring.raw ? signal.getRawValueType() : signal.getConvertedValueType());
+            m_rings.push_back(ring);
+        }
+    }
+    m_samples.resize(m_rings.size() * m_samples_per_signal);
+}
+
+/** \brief Destructor */
+CanMsgSignalHistory::~CanMsgSignalHistory()
+{}
+
+/** \brief Look for the id of a signal in the history, return false if the signal doesn't exist in the database */
+bool CanMsgSignalHistory::findSignal(const std::string& signal_name, size_t& signal_id) const
+{
+    // The rings are allocated in the database's iteration order like the signal handles
+    const CanMsgNameIndex::handle_t handle = m_name_index.findSignal(signal_name);
+    const bool ret = ((handle != CanMsgNameIndex::INVALID_HANDLE) && (handle < m_rings.size()));
+    if (ret)
+    {
+        signal_id = handle;
+    }
+
+    return ret;
+}
+
+/** \brief Record the decoded signals of a CAN message */
+void CanMsgSignalHistory::record(const CanMsg& can_msg, const DecodedFrame& decoded_frame)
+{
+    const CanMsgDesc* can_msg_desc = decoded_frame.getCanMsg();
+    const uint32_t position = m_can_msg_index.findPosition(can_msg_desc->getId(), can_msg_desc->isExtented());
+    if ((m_samples_per_signal != 0) && (position != CanMsgDescIndex::NOT_FOUND) && (m_can_msg_index.getCanMsgs()[position] == can_msg_desc))
+    {
+        const int64_t timestamp = can_msg.header.timestamp_sec * 1000000000 + can_msg.header.timestamp_nsec;
+
+        lock_guard<mutex> lock(m_mutex);
+
+        Ring* rings = &m_rings[m_first_rings[position]];
+        const vector<size_t>& decoded_signals = decoded_frame.getDecodedSignals();
+        for (size_t i = 0; i < decoded_signals.size(); i++)
+        {
+            const size_t signal_index = decoded_signals[i];
+            Ring& ring = rings[signal_index];
+
+            // Write the sample over the oldest one when the ring is full
+            Sample& sample = m_samples[ring.first + ring.head];
+            sample.timestamp = timestamp;
+            sample.value = toDouble(ring.type, (ring.raw ? decoded_frame.getRawValue(signal_index) : decoded_frame.getConvertedValue(signal_index)));
+            ring.head++;
+            if (ring.head == m_samples_per_signal)
+            {
+                ring.head = 0;
+            }
+            if (ring.count < m_samples_per_signal)
+            {
+                ring.count++;
+            }
+        }
+    }
+}
+
+/** \brief Remove all the samples */
+void CanMsgSignalHistory::clear()
+{
+    lock_guard<mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_rings.size(); i++)
+    {
+        m_rings[i].head = 0;
+        m_rings[i].count = 0;
+    }
+}
+
+/** \brief Get the last samples of a signal (oldest first), return the number of samples copied */
+size_t CanMsgSignalHistory::getLast(const size_t signal_id, const size_t count, Sample* samples) const
+{
+    size_t copied = 0;
+
+    if (signal_id < m_rings.size())
+    {
+        lock_guard<mutex> lock(m_mutex);
+        const Ring& ring = m_rings[signal_id];
+        const size_t first = ((count < ring.count) ? (ring.count - count) : 0);
+        for (size_t i = first; i < ring.count; i++)
+        {
+            samples[copied] = getSample(ring, i);
+            copied++;
+        }
+    }
+
+    return copied;
+}
+
+/** \brief Get the samples of a signal in the time range [start, end] (oldest first), return the number of samples copied */
+size_t CanMsgSignalHistory::getRange(const size_t signal_id, const int64_t start, const int64_t end, Sample* samples, const size_t max_count) const
+{
+    size_t copied = 0;
+
+    if (signal_id < m_rings.size())
+    {
+        lock_guard<mutex> lock(m_mutex);
+        const Ring& ring = m_rings[signal_id];
+        const size_t last = lowerBound(ring, end, false);
+        for (size_t i = lowerBound(ring, start, true); (i < last) && (copied < max_count); i++)
+        {
+            samples[copied] = getSample(ring, i);
+            copied++;
+        }
+    }
+
+    return copied;
+}
+
+/** \brief Get the statistics of a signal in the time range [start, end], return false if there is no sample in the range */
+bool CanMsgSignalHistory::getStats(const size_t signal_id, const int64_t start, const int64_t end, Stats& stats) const
+{
+    bool ret = false;
+
+    if (signal_id < m_rings.size())
+    {
+        lock_guard<mutex> lock(m_mutex);
+        const Ring& ring = m_rings[signal_id];
+        const size_t first = lowerBound(ring, start, true);
+        const size_t last = lowerBound(ring, end, false);
+        if (first < last)
+        {
+            double sum = 0.;
+            stats.count = last - first;
+            stats.min = getSample(ring, first).value;
+            stats.max = stats.min;
+            for (size_t i = first; i < last; i++)
+            {
+                const double value = getSample(ring, i).value;
+                if (value < stats.min)
+                {
+                    stats.min = value;
+                }
+                if (value > stats.max)
+                {
+                    stats.max = value;
+                }
+                sum += value;
+            }
+            stats.mean = sum / static_cast<double>(stats.count);
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Get the last sample of a signal at or before a timestamp, return false if there is no such sample */
+bool CanMsgSignalHistory::getValueAt(const size_t signal_id, const int64_t timestamp, Sample& sample) const
+{
+    bool ret = false;
+
+    if (signal_id < m_rings.size())
+    {
+        lock_guard<mutex> lock(m_mutex);
+        const Ring& ring = m_rings[signal_id];
+        const size_t index = lowerBound(ring, timestamp, false);
+        if (index != 0)
+        {
+            sample = getSample(ring, index - 1u);
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Get the index of the first sample of a ring which is after a timestamp (or equal if inclusive) */
+size_t CanMsgSignalHistory::lowerBound(const Ring& ring, const int64_t timestamp, const bool inclusive) const
+{
+    // Binary search, the samples are recorded in chronological order
+    size_t first = 0;
+    size_t count = ring.count;
+    while (count != 0)
+    {
+        const size_t step = count / 2u;
+        const int64_t sample_timestamp = getSample(ring, first + step).timestamp;
+        if (inclusive ? (sample_timestamp < timestamp) : (sample_timestamp <= timestamp))
+        {
+            first += step + 1u;
+            count -= step + 1u;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+/** \brief Convert a value to a double precision floating point value */
+double CanMsgSignalHistory::toDouble(const CanMsgValueType type, const CanMsgValueData& value)
+{
+    double ret;
+
+    switch (type)
+    {
+        case CANMSGVALUE_BOOL:
+        {
+            ret = (value.bool_value ? 1. : 0.);
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        {
+            ret = static_cast<double>(value.uint_value);
+            break;
+        }
+
+        case CANMSGVALUE_INT:
+        {
+            ret = static_cast<double>(value.int_value);
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            ret = static_cast<double>(value.float_value);
+            break;
+        }
+
+        case CANMSGVALUE_DOUBLE:
+        {
+            ret = value.double_value;
+            break;
+        }
+
+        default:
+        {
+            ret = 0.;
+            break;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,168 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGSIGNALHISTORY_H
+#define CANMSGSIGNALHISTORY_H
+
+#include "CanMsgDescIndex.h"
+#include "CanMsgNameIndex.h"
+#include "CanMsgValueData.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+class ICanMsgDatabase;
+class DecodedFrame;
+
+
+/** \brief In-memory history of the decoded signals : each signal of the database has a preallocated ring
+           of (timestamp, value) samples so that the memory used is fixed when the history is created
+           and no allocation is done while recording. The values are stored as double precision
+           floating point values (raw value for the signals converted to strings) */
+class CanMsgSignalHistory
+{
+    public:
+
+        /** \brief Sample of a signal */
+        struct Sample
+        {
+            /** \brief Timestamp in nanoseconds */
+            int64_t timestamp;
+            /** \brief Value */
+            double value;
+        };
+
+        /** \brief Statistics of a signal over a time window */
+        struct Stats
+        {
+            /** \brief Number of samples */
+            size_t count;
+            /** \brief Minimum value */
+            double min;
+            /** \brief Maximum value */
+            double max;
+            /** \brief Mean value */
+            double mean;
+        };
+
+
+        /** \brief Constructor, the database must be loaded and must outlive the history. All the CAN messages
+                   of a database which builds them on demand are built */
+        CanMsgSignalHistory(const ICanMsgDatabase& can_msg_database, const size_t samples_per_signal);
+
+        /** \brief Destructor */
+        virtual ~CanMsgSignalHistory();
+
+
+        /** \brief Get the number of samples kept for each signal */
+        size_t getSamplesPerSignal() const { return m_samples_per_signal; }
+
+        /** \brief Get the memory used by the samples in bytes */
+        size_t getMemorySize() const { return (m_samples.size() * sizeof(Sample)); }
+
+        /** \brief Look for the id of a signal in the history, return false if the signal doesn't exist in the database.
+                   The signal ids are the signal handles of the name index of the database, a handle can be used as id
+                   without looking for it (the ids of a database which builds its CAN messages on demand must be looked for) */
+        bool findSignal(const std::string& signal_name, size_t& signal_id) const;
+
+
+        /** \brief Record the decoded signals of a CAN message */
+        void record(const CanMsg& can_msg, const DecodedFrame& decoded_frame);
+
+        /** \brief Remove all the samples */
+        void clear();
+
+
+        /** \brief Get the last samples of a signal (oldest first), return the number of samples copied */
+        size_t getLast(const size_t signal_id, const size_t count, Sample* samples) const;
+
+        /** \brief Get the samples of a signal in the time range [start, end] (oldest first), return the number of samples copied */
+        size_t getRange(const size_t signal_id, const int64_t start, const int64_t end, Sample* samples, const size_t max_count) const;
+
+        /** \brief Get the statistics of a signal in the time range [start, end], return false if there is no sample in the range */
+        bool getStats(const size_t signal_id, const int64_t start, const int64_t end, Stats& stats) const;
+
+        /** \brief Get the last sample of a signal at or before a timestamp, return false if there is no such sample */
+        bool getValueAt(const size_t signal_id, const int64_t timestamp, Sample& sample) const;
+
+
+    private:
+
+        /** \brief Ring of samples of a signal */
+        struct Ring
+        {
+            /** \brief Index of the ring's first sample in the samples array */
+            size_t first;
+            /** \brief Index of the next sample to write relative to the first sample */
+            size_t head;
+            /** \brief Number of samples in the ring */
+            size_t count;
+            /** \brief Type of the recorded value */
+            CanMsgValueType type;
+            /** \brief Indicate if the raw value is recorded instead of the converted value */
+            bool raw;
+        };
+
+
+        /** \brief Number of samples kept for each signal */
+        const size_t m_samples_per_signal;
+
+        /** \brief Lookup index of the CAN messages database */
+        CanMsgDescIndex m_can_msg_index;
+
+        /** \brief Name index of the CAN messages built on demand, a database which builds them on demand has an empty name index */
+        CanMsgNameIndex m_lazy_name_index;
+
+        /** \brief Name index of the CAN messages database */
+        const CanMsgNameIndex& m_name_index;
+
+        /** \brief Index of the ring of the first signal of each CAN message, at the position of the message in the lookup index */
+        std::vector<size_t> m_first_rings;
+
+        /** \brief Rings of all the signals of the database, in the order of the signal handles */
+        std::vector<Ring> m_rings;
+
+        /** \brief Samples of all the signals */
+        std::vector<Sample> m_samples;
+
+        /** \brief Mutex to protect the samples between the recording and the queries */
+        mutable std::mutex m_mutex;
+
+
+        /** \brief Get a sample of a ring (0 = oldest sample) */
+        const Sample& getSample(const Ring& ring, const size_t index) const
+        {
+            size_t position = ring.head + m_samples_per_signal - ring.count + index;
+            if (position >= m_samples_per_signal)
+            {
+                position -= m_samples_per_signal;
+            }
+            return m_samples[ring.first + position];
+        }
+
+        /** \brief Get the index of the first sample of a ring which is after a timestamp (or equal if inclusive) */
+        size_t lowerBound(const Ring& ring, const int64_t timestamp, const bool inclusive) const;
+
+        /** \brief Convert a value to a double precision floating point value */
+        static double toDouble(const CanMsgValueType type, const CanMsgValueData& value);
+};
+
+
+#endif // CANMSGSIGNALHISTORY_H
@@ -18,12 +18,12 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "CanMsgValueBase.h"
-
-#include <cstring>
+#include "CanMsgExtractionPlan.h"
 
 /** \brief Constructor */
 CanMsgValueBase::CanMsgValueBase()
 : m_can_msg(nullptr)
+, m_byte_order(CANMSG_LITTLE_ENDIAN)
 , m_byte_position(0)
 , m_bit_position(0)
 , m_size_in_bits(0)
@@ -37,14 +37,8 @@ CanMsgValueBase::~CanMsgValueBase()
 /** \brief Set the value's byte position inside the CAN message */
 bool CanMsgValueBase::setBytePosition(const uint8_t position)
 {
-    // Convert to bit position
-    const uint8_t bit_position = position * 8u + m_bit_position;
-    
-    // Size of a CAN message in bits
-    const uint8_t can_msg_size_in_bits = CAN_MSG_MAX_LEN * 8u;
-
     // Check if there is some place left in the message
-    const bool ret = ((bit_position + m_size_in_bits) <= can_msg_size_in_bits);
+    const bool ret = fitsInPayload(position, m_bit_position);
     if (ret)
     {
         // Save value
@@ -56,14 +50,8 @@ bool CanMsgValueBase::setBytePosition(const uint8_t position)
 /** \brief Set the value's byte position inside its first byte into the CAN message */
 bool CanMsgValueBase::setBitPosition(const uint8_t position)
 {
-    // Convert to bit position
-    const uint8_t bit_position = m_byte_position * 8u + position;
-
-    // Size of a CAN message in bits
-    const uint8_t can_msg_size_in_bits = CAN_MSG_MAX_LEN * 8u;
-
     // Check if there is some place left in the message
-    const bool ret = ((bit_position + m_size_in_bits) <= can_msg_size_in_bits);
+    const bool ret = fitsInPayload(m_byte_position, position);
     if (ret)
     {
         // Save value
@@ -79,17 +67,43 @@ void CanMsgValueBase::setSizeInBits(const uint8_t size_in_bits)
     m_size_in_bits = size_in_bits;
 
     // Update value mask
-    m_value_mask = (1ull << m_size_in_bits) - 1u;
+    if (m_size_in_bits >= 64u)
+    {
+        m_value_mask = 0xFFFFFFFFFFFFFFFFull;
+    }
+    else
+    {
+        m_value_mask = (1ull << m_size_in_bits) - 1u;
+    }
 }
 
-/** \brief Retrieve the masked value */
-void CanMsgValueBase::getMaskedValue(const CanMsg& can_msg, void* value)
+/** \brief Get the mask of the value's bits inside the CAN message payload loaded as a little endian 64 bits word */
+uint64_t CanMsgValueBase::getPayloadMask() const
 {
-    uint64_t value_64 = 0;
-    for (int8_t i = CAN_MSG_MAX_LEN; i >= 0; i--)
+    uint64_t payload_mask = (m_value_mask << getStartBitPosition());
+    if (m_byte_order == CANMSG_BIG_ENDIAN)
     {
-        value_64 = (value_64 << 8u) + can_msg.data[i];
+        payload_mask = CanMsgExtractionPlan::swapBytes(payload_mask);
     }
-    value_64 = ((value_64 >> getStartBitPosition()) & m_value_mask);
-    memcpy(value, &value_64, sizeof(uint64_t));
+    return payload_mask;
+}
+
+/** \brief Check if a value fits inside the CAN message payload */
+bool CanMsgValueBase::fitsInPayload(const uint8_t byte_position, const uint8_t bit_position) const
+{
+    // Size of a CAN message in bits
+    const int can_msg_size_in_bits = CAN_MSG_MAX_LEN * 8u;
+
+    bool ret;
+    if (m_byte_order == CANMSG_BIG_ENDIAN)
+    {
+        // The value's bits go from its most significant bit towards the end of the payload
+        ret = ((byte_position < CAN_MSG_MAX_LEN) && (bit_position < 8u) &&
+               ((can_msg_size_in_bits - 8 - (byte_position * 8) + bit_position + 1) >= m_size_in_bits));
+    }
+    else
+    {
+        ret = (((byte_position * 8) + bit_position + m_size_in_bits) <= can_msg_size_in_bits);
+    }
+    return ret;
 }
@@ -43,6 +43,13 @@ class CanMsgValueBase : public ICanMsgValue
         virtual void setCanMsg(CanMsgDesc& can_msg) override { m_can_msg = &can_msg; }
 
 
+        /** \brief Get the value's byte order */
+        virtual CanMsgByteOrder getByteOrder() const override { return m_byte_order; }
+
+        /** \brief Set the value's byte order, the byte and bit positions must be set afterwards */
+        virtual void setByteOrder(const CanMsgByteOrder byte_order) override { m_byte_order = byte_order; }
+
+
         /** \brief Get the value's byte position inside the CAN message */
         virtual uint8_t getBytePosition() const override { return m_byte_position; }
 
@@ -57,11 +64,16 @@ class CanMsgValueBase : public ICanMsgValue
         virtual bool setBitPosition(const uint8_t position) override;
 
 
-        /** \brief Get the value's start bit position inside inside the CAN message */
-        virtual uint8_t getStartBitPosition() const override { return ((m_byte_position * 8u) + m_bit_position); }
+        /** \brief Get the value's start bit position inside the CAN message payload loaded as a 64 bits word
+                   in the value's byte order */
+        virtual uint8_t getStartBitPosition() const override { return (getEndBitPosition() + 1u - m_size_in_bits); }
+
+        /** \brief Get the value's end bit position inside the CAN message payload loaded as a 64 bits word
+                   in the value's byte order */
+        virtual uint8_t getEndBitPosition() const override { return getMsbPosition(m_byte_position, m_bit_position, m_size_in_bits); }
 
-        /** \brief Get the value's end bit position inside inside the CAN message */
-        virtual uint8_t getEndBitPosition() const override { return (getStartBitPosition() + m_size_in_bits - 1u); }
+        /** \brief Get the mask of the value's bits inside the CAN message payload loaded as a little endian 64 bits word */
+        virtual uint64_t getPayloadMask() const override;
 
 
         /** \brief Get the value's size in bits */
@@ -76,15 +88,15 @@ class CanMsgValueBase : public ICanMsgValue
         /** \brief Retrieve the bit mask of the value */
         uint64_t getBitMask() { return m_value_mask; }
 
-        /** \brief Retrieve the masked value */
-        void getMaskedValue(const CanMsg& can_msg, void* value);
-
 
     private:
 
         /** \brief Associated CAN message description */
         CanMsgDesc* m_can_msg;
 
+        /** \brief Byte order */
+        CanMsgByteOrder m_byte_order;
+
         /** \brief Byte position */
         uint8_t m_byte_position;
 
@@ -96,6 +108,26 @@ class CanMsgValueBase : public ICanMsgValue
 
         /** \brief Bit mask of the value on the CAN message */
         uint64_t m_value_mask;
+
+
+        /** \brief Get the position of the most significant bit of a value inside the payload word in the value's byte order :
+                   in big endian the payload word is byte swapped so that the value's bits are contiguous */
+        uint8_t getMsbPosition(const uint8_t byte_position, const uint8_t bit_position, const uint8_t size_in_bits) const
+        {
+            uint8_t msb_position;
+            if (m_byte_order == CANMSG_BIG_ENDIAN)
+            {
+                msb_position = static_cast<uint8_t>(56u - (byte_position * 8u) + bit_position);
+            }
+            else
+            {
+                msb_position = static_cast<uint8_t>((byte_position * 8u) + bit_position + size_in_bits - 1u);
+            }
+            return msb_position;
+        }
+
+        /** \brief Check if a value fits inside the CAN message payload */
+        bool fitsInPayload(const uint8_t byte_position, const uint8_t bit_position) const;
 };
 
 
@@ -22,6 +22,8 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "ICanMsgValueConverter.h"
 
+#include <cmath>
+
 
 /** \brief Base class for CAN message value converters implementations */
 class CanMsgValueConverterBase : public ICanMsgValueConverter
@@ -29,7 +31,7 @@ class CanMsgValueConverterBase : public ICanMsgValueConverter
     public:
 
         /** \brief Destructor */
-        CanMsgValueConverterBase(const std::string& name, const std::string& type, const std::string& output_type)
+        CanMsgValueConverterBase(const std::string& name, const std::string& type, const CanMsgValueType output_type)
         : m_name(name)
         , m_type(type)
         , m_output_type(output_type)
@@ -46,7 +48,52 @@ class CanMsgValueConverterBase : public ICanMsgValueConverter
         virtual const std::string& getType() const override { return m_type; }
 
         /** \brief Get the converter's output type */
-        virtual const std::string& getOutputType() const override { return m_output_type; }
+        virtual CanMsgValueType getOutputType() const override { return m_output_type; }
+
+
+    protected:
+
+        /** \brief Convert a double precision floating point value to a CAN message value type,
+                   integer values are rounded to the nearest integer */
+        static CanMsgValueData fromDouble(const double value, const CanMsgValueType type)
+        {
+            CanMsgValueData ret;
+            switch (type)
+            {
+                case CANMSGVALUE_BOOL:
+                {
+                    ret.uint_value = 0u;
+                    ret.bool_value = (value != 0.);
+                    break;
+                }
+
+                case CANMSGVALUE_UINT:
+                {
+                    ret.uint_value = ((value > 0.) ? static_cast<uint64_t>(std::round(value)) : 0u);
+                    break;
+                }
+
+                case CANMSGVALUE_INT:
+                {
+                    ret.int_value = std::llround(value);
+                    break;
+                }
+
+                case CANMSGVALUE_FLOAT:
+                {
+                    ret.uint_value = 0u;
+                    ret.float_value = static_cast<float>(value);
+                    break;
+                }
+
+                default:
+                {
+                    ret.double_value = value;
+                    break;
+                }
+            }
+            return ret;
+        }
 
 
     private:
@@ -58,7 +105,7 @@ class CanMsgValueConverterBase : public ICanMsgValueConverter
         const std::string m_type;
 
         /** \brief Converter's output type */
-        const std::string m_output_type;
+        const CanMsgValueType m_output_type;
 };
 
 
@@ -0,0 +1,98 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CANMSGVALUEDATA_H
+#define CANMSGVALUEDATA_H
+
+#include <cstdint>
+#include <string>
+
+
+/** \brief Types of the CAN message values */
+enum CanMsgValueType
+{
+    /** \brief Boolean */
+    CANMSGVALUE_BOOL = 0,
+    /** \brief Unsigned integer */
+    CANMSGVALUE_UINT = 1,
+    /** \brief Signed integer */
+    CANMSGVALUE_INT = 2,
+    /** \brief Single precision floating point */
+    CANMSGVALUE_FLOAT = 3,
+    /** \brief Double precision floating point */
+    CANMSGVALUE_DOUBLE = 4,
+    /** \brief String */
+    CANMSGVALUE_STRING = 5,
+    /** \brief Unknown type */
+    CANMSGVALUE_UNKNOWN = 6
+};
+
+
+/** \brief Storage of a CAN message value */
+union CanMsgValueData
+{
+    /** \brief Boolean value */
+    bool bool_value;
+    /** \brief Unsigned integer value */
+    uint64_t uint_value;
+    /** \brief Signed integer value */
+    int64_t int_value;
+    /** \brief Single precision floating point value */
+    float float_value;
+    /** \brief Double precision floating point value */
+    double double_value;
+    /** \brief String value */
+    const std::string* string_value;
+};
+
+
+/** \brief CAN message value tagged with its type */
+struct CanMsgTypedValue
+{
+    /** \brief Type */
+    CanMsgValueType type;
+    /** \brief Value */
+    CanMsgValueData value;
+};
+
+
+/** \brief Get the name of a CAN message value type */
+inline const char* getCanMsgValueTypeName(const CanMsgValueType type)
+{
+    static const char* const type_names[] = { "bool", "uint", "int", "float", "double", "string", "unknown" };
+    return type_names[((type <= CANMSGVALUE_UNKNOWN) ? type : CANMSGVALUE_UNKNOWN)];
+}
+
+/** \brief Get a CAN message value type from its name, return false if the name is not a known type */
+inline bool getCanMsgValueType(const std::string& type_name, CanMsgValueType& type)
+{
+    bool ret = false;
+    for (int i = CANMSGVALUE_BOOL; !ret && (i < CANMSGVALUE_UNKNOWN); i++)
+    {
+        if (type_name == getCanMsgValueTypeName(static_cast<CanMsgValueType>(i)))
+        {
+            type = static_cast<CanMsgValueType>(i);
+            ret = true;
+        }
+    }
+    return ret;
+}
+
+
+#endif // CANMSGVALUEDATA_H
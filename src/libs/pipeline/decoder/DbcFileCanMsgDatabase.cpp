@@ -0,0 +1,730 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DbcFileCanMsgDatabase.h"
+#include "MappedFile.h"
+
+#include "CanMsgDesc.h"
+#include "CanMsgSignal.h"
+#include "IntegerCanMsgValue.h"
+#include "FloatCanMsgValue.h"
+
+#include "EnumCanMsgValueConverter.h"
+#include "LinearCanMsgValueConverter.h"
+
+#include <charconv>
+#include <sstream>
+
+using namespace std;
+
+
+/** \brief Bit of the DBC message ids which indicates an extended message */
+static const uint32_t DBC_EXTENDED_ID_FLAG = 0x80000000u;
+
+/** \brief Mask of the CAN id in the DBC message ids */
+static const uint32_t DBC_ID_MASK = 0x1FFFFFFFu;
+
+
+/** \brief Check if a character can be part of a DBC identifier */
+static bool isIdentifierChar(const char c)
+{
+    return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_'));
+}
+
+
+/** \brief Constructor */
+DbcFileCanMsgDatabase::DbcFileCanMsgDatabase()
+: m_storage()
+, m_last_error("")
+, m_can_msgs()
+, m_name_index()
+, m_current(nullptr)
+, m_end(nullptr)
+, m_line(0)
+, m_dbc_msgs()
+, m_dbc_msg_indexes()
+{}
+
+/** \brief Destructor */
+DbcFileCanMsgDatabase::~DbcFileCanMsgDatabase()
+{}
+
+
+/** \brief Load the message database from the file */
+bool DbcFileCanMsgDatabase::load(const std::string& dbc_file)
+{
+    bool ret = false;
+
+    // Map file, the parsed names and strings refer to its contents until the messages are built
+    MappedFile file;
+    if (file.open(dbc_file))
+    {
+        m_current = file.getData();
+        m_end = m_current + file.getSize();
+        m_line = 1u;
+        ret = parse();
+        if (ret)
+        {
+            ret = build();
+        }
+
+        // Release the parsed messages
+        vector<DbcMessage>().swap(m_dbc_msgs);
+        m_dbc_msg_indexes.clear();
+        m_current = nullptr;
+        m_end = nullptr;
+    }
+    else
+    {
+        m_last_error = "Unable to open the DBC file";
+    }
+
+    // Index the names of the CAN messages and signals
+    if (ret)
+    {
+        ret = m_name_index.build(*this);
+        if (!ret)
+        {
+            m_last_error = "Unable to build the index of the names";
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Set the error message of a statement */
+void DbcFileCanMsgDatabase::setErrorMessage(const char* statement, const size_t line, const char* error_msg)
+{
+    stringstream ss_error_msg;
+    ss_error_msg << "Statement : " << statement << " - Line : " << line << " => " << error_msg;
+    m_last_error = ss_error_msg.str();
+}
+
+/** \brief Parse the statements of the file */
+bool DbcFileCanMsgDatabase::parse()
+{
+    bool ret = true;
+
+    // Signals are attached to the last message definition
+    DbcMessage* dbc_msg = nullptr;
+    skipSpaces();
+    while (ret && (m_current < m_end))
+    {
+        string_view keyword;
+        if (!readIdentifier(keyword))
+        {
+            skipStatement();
+        }
+        else if (keyword == "BO_")
+        {
+            ret = parseMessage(dbc_msg);
+        }
+        else if (keyword == "SG_")
+        {
+            ret = parseSignal(dbc_msg);
+        }
+        else if (keyword == "VAL_")
+        {
+            ret = parseValueDescriptions();
+        }
+        else if (keyword == "SIG_VALTYPE_")
+        {
+            ret = parseSignalValueType();
+        }
+        else if (keyword == "NS_")
+        {
+            skipNamespaceSection();
+        }
+        else
+        {
+            skipStatement();
+        }
+        skipSpaces();
+    }
+
+    return ret;
+}
+
+/** \brief Parse a BO_ statement */
+bool DbcFileCanMsgDatabase::parseMessage(DbcMessage*& dbc_msg)
+{
+    const size_t line = m_line;
+    uint64_t id = 0;
+    string_view name;
+    uint64_t dlc = 0;
+    string_view transmitter;
+    bool ret = (readUint(id) && (id <= 0xFFFFFFFFu) && readIdentifier(name) && expect(':') && readUint(dlc) && readIdentifier(transmitter));
+    if (ret)
+    {
+        // The pseudo message which holds the signals not attached to any message is ignored
+        dbc_msg = nullptr;
+        if (name != "VECTOR__INDEPENDENT_SIG_MSG")
+        {
+            const uint32_t dbc_id = static_cast<uint32_t>(id);
+            ret = m_dbc_msg_indexes.emplace(dbc_id, m_dbc_msgs.size()).second;
+            if (ret)
+            {
+                m_dbc_msgs.emplace_back();
+                dbc_msg = &m_dbc_msgs.back();
+                dbc_msg->id = dbc_id;
+                dbc_msg->name = name;
+                dbc_msg->line = line;
+            }
+            else
+            {
+                setErrorMessage("BO_", line, "Duplicate CAN message id");
+            }
+        }
+    }
+    else
+    {
+        setErrorMessage("BO_", line, "Invalid CAN message definition");
+    }
+
+    return ret;
+}
+
+/** \brief Parse a SG_ statement */
+bool DbcFileCanMsgDatabase::parseSignal(DbcMessage* dbc_msg)
+{
+    const char* error_msg = "Invalid CAN signal definition";
+    DbcSignal dbc_signal;
+    dbc_signal.line = m_line;
+    dbc_signal.multiplexer = false;
+    dbc_signal.multiplexed = false;
+    dbc_signal.multiplexer_value = 0;
+
+    // Name and multiplexer indicator : M for the multiplexer, mX for a signal multiplexed by the value X
+    bool ret = readIdentifier(dbc_signal.name);
+    if (ret)
+    {
+        skipSpaces();
+        if ((m_current < m_end) && (*m_current != ':'))
+        {
+            string_view multiplexer_indicator;
+            ret = readIdentifier(multiplexer_indicator);
+            if (ret)
+            {
+                if (multiplexer_indicator == "M")
+                {
+                    dbc_signal.multiplexer = true;
+                }
+                else if ((multiplexer_indicator.size() > 1u) && (multiplexer_indicator[0] == 'm'))
+                {
+                    const char* indicator_end = multiplexer_indicator.data() + multiplexer_indicator.size();
+                    const auto result = from_chars(multiplexer_indicator.data() + 1u, indicator_end, dbc_signal.multiplexer_value);
+                    dbc_signal.multiplexed = true;
+                    ret = ((result.ec == errc()) && (result.ptr == indicator_end));
+                    if (!ret && (result.ec == errc()) && (*result.ptr == 'M'))
+                    {
+                        error_msg = "Extended multiplexing is not supported";
+                    }
+                }
+                else
+                {
+                    ret = false;
+                }
+            }
+        }
+    }
+
+    // Position and encoding : start_bit|size@byte_order sign
+    uint64_t start_bit = 0;
+    uint64_t size_in_bits = 0;
+    if (ret)
+    {
+        ret = (expect(':') && readUint(start_bit) && expect('|') && readUint(size_in_bits) && expect('@'));
+    }
+    if (ret)
+    {
+        dbc_signal.big_endian = expect('0');
+        ret = (dbc_signal.big_endian || expect('1'));
+    }
+    if (ret)
+    {
+        dbc_signal.type = (expect('-') ? CANMSGVALUE_INT : CANMSGVALUE_UINT);
+        ret = ((dbc_signal.type == CANMSGVALUE_INT) || expect('+'));
+    }
+    if (ret)
+    {
+        ret = ((start_bit < 64u) && (size_in_bits > 0u) && (size_in_bits <= 64u));
+        if (ret)
+        {
+            dbc_signal.start_bit = static_cast<uint8_t>(start_bit);
+            dbc_signal.size_in_bits = static_cast<uint8_t>(size_in_bits);
+        }
+        else
+        {
+            error_msg = "Only the CAN signals contained in the first 8 bytes of the payload are supported";
+        }
+    }
+
+    // Conversion : (factor,offset) [min|max] "unit"
+    if (ret)
+    {
+        ret = (expect('(') && readDouble(dbc_signal.factor) && expect(',') && readDouble(dbc_signal.offset) && expect(')') &&
+               expect('[') && readDouble(dbc_signal.min) && expect('|') && readDouble(dbc_signal.max) && expect(']') &&
+               readString(dbc_signal.unit));
+    }
+
+    if (ret)
+    {
+        // Skip receivers
+        skipStatement();
+
+        // Signals of ignored messages are ignored
+        if (dbc_msg != nullptr)
+        {
+            dbc_msg->dbc_signals.push_back(dbc_signal);
+        }
+    }
+    else
+    {
+        setErrorMessage("SG_", dbc_signal.line, error_msg);
+    }
+
+    return ret;
+}
+
+/** \brief Parse a VAL_ statement */
+bool DbcFileCanMsgDatabase::parseValueDescriptions()
+{
+    bool ret = true;
+    const size_t line = m_line;
+
+    // The value descriptions of the environment variables don't start with a message id
+    skipSpaces();
+    if ((m_current < m_end) && (*m_current >= '0') && (*m_current <= '9'))
+    {
+        uint64_t id = 0;
+        string_view name;
+        ret = (readUint(id) && readIdentifier(name));
+
+        // Labels of unknown signals are ignored
+        DbcSignal* dbc_signal = (ret ? findSignal(id, name) : nullptr);
+        while (ret && !expect(';'))
+        {
+            int64_t value = 0;
+            string_view label;
+            ret = (readInt(value) && readString(label));
+            if (ret && (dbc_signal != nullptr))
+            {
+                dbc_signal->labels.emplace_back(value, label);
+            }
+        }
+        if (!ret)
+        {
+            setErrorMessage("VAL_", line, "Invalid value descriptions");
+        }
+    }
+    else
+    {
+        skipStatement();
+    }
+
+    return ret;
+}
+
+/** \brief Parse a SIG_VALTYPE_ statement */
+bool DbcFileCanMsgDatabase::parseSignalValueType()
+{
+    const size_t line = m_line;
+    uint64_t id = 0;
+    string_view name;
+    uint64_t value_type = 0;
+
+    // The colon is optional for some DBC editors
+    bool ret = (readUint(id) && readIdentifier(name));
+    if (ret)
+    {
+        expect(':');
+        ret = (readUint(value_type) && expect(';'));
+    }
+    if (ret)
+    {
+        // 0 = integer, 1 = single precision float, 2 = double precision float
+        DbcSignal* dbc_signal = findSignal(id, name);
+        if (dbc_signal != nullptr)
+        {
+            if (value_type == 1u)
+            {
+                dbc_signal->type = CANMSGVALUE_FLOAT;
+            }
+            else if (value_type == 2u)
+            {
+                dbc_signal->type = CANMSGVALUE_DOUBLE;
+            }
+            else
+            {
+                ret = (value_type == 0u);
+            }
+        }
+    }
+    if (!ret)
+    {
+        setErrorMessage("SIG_VALTYPE_", line, "Invalid signal value type");
+    }
+
+    return ret;
+}
+
+/** \brief Look for a parsed signal (nullptr if the signal doesn't exist) */
+DbcFileCanMsgDatabase::DbcSignal* DbcFileCanMsgDatabase::findSignal(const uint64_t id, const std::string_view& name)
+{
+    DbcSignal* dbc_signal = nullptr;
+
+    const auto iter = m_dbc_msg_indexes.find(static_cast<uint32_t>(id));
+    if ((id <= 0xFFFFFFFFu) && (iter != m_dbc_msg_indexes.end()))
+    {
+        vector<DbcSignal>& dbc_signals = m_dbc_msgs[iter->second].dbc_signals;
+        for (size_t i = 0; (dbc_signal == nullptr) && (i < dbc_signals.size()); i++)
+        {
+            if (dbc_signals[i].name == name)
+            {
+                dbc_signal = &dbc_signals[i];
+            }
+        }
+    }
+
+    return dbc_signal;
+}
+
+/** \brief Create the CAN message descriptions from the parsed messages */
+bool DbcFileCanMsgDatabase::build()
+{
+    bool ret = true;
+    for (size_t i = 0; ret && (i < m_dbc_msgs.size()); i++)
+    {
+        ret = buildMessage(m_dbc_msgs[i]);
+    }
+    return ret;
+}
+
+/** \brief Create the CAN message description of a parsed message */
+bool DbcFileCanMsgDatabase::buildMessage(const DbcMessage& dbc_msg)
+{
+    bool ret = true;
+
+    const bool extended = ((dbc_msg.id & DBC_EXTENDED_ID_FLAG) != 0);
+    auto can_msg = m_storage.create<CanMsgDesc>(dbc_msg.id & DBC_ID_MASK, string(dbc_msg.name), extended);
+
+    // Create values, the multiplexer value must be added before the multiplexed values
+    const vector<DbcSignal>& dbc_signals = dbc_msg.dbc_signals;
+    vector<shared_ptr<ICanMsgValue>> values(dbc_signals.size());
+    for (size_t pass = 0; ret && (pass < 2u); pass++)
+    {
+        for (size_t i = 0; ret && (i < dbc_signals.size()); i++)
+        {
+            const DbcSignal& dbc_signal = dbc_signals[i];
+            if (dbc_signal.multiplexer == (pass == 0))
+            {
+                ret = buildValue(dbc_signal, values[i]);
+                if (ret)
+                {
+                    if (dbc_signal.multiplexer)
+                    {
+                        ret = can_msg->addMultiplexerValue(values[i]);
+                        if (!ret)
+                        {
+                            setErrorMessage("SG_", dbc_signal.line, "The multiplexer signal for the CAN message must be a single unsigned signal which doesn't overlap another signal");
+                        }
+                    }
+                    else if (dbc_signal.multiplexed)
+                    {
+                        ret = can_msg->addMultiplexedValue(values[i], dbc_signal.multiplexer_value);
+                        if (!ret)
+                        {
+                            setErrorMessage("SG_", dbc_signal.line, "The multiplexed signal for the CAN message overlaps another signal or the CAN message has no multiplexer signal");
+                        }
+                    }
+                    else
+                    {
+                        ret = can_msg->addValue(values[i]);
+                        if (!ret)
+                        {
+                            setErrorMessage("SG_", dbc_signal.line, "The signal for the CAN message overlaps another signal");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Create signals
+    for (size_t i = 0; ret && (i < dbc_signals.size()); i++)
+    {
+        const DbcSignal& dbc_signal = dbc_signals[i];
+        auto signal = m_storage.create<CanMsgSignal>();
+        signal->setName(m_storage.intern(dbc_signal.name));
+        signal->setUnit(m_storage.intern(dbc_signal.unit));
+        ret = signal->setValue(*values[i]);
+        if (ret)
+        {
+            shared_ptr<ICanMsgValueConverter> converter = buildConverter(dbc_signal);
+            if (converter)
+            {
+                ret = signal->setConverter(*converter);
+                if (!ret)
+                {
+                    setErrorMessage("SG_", dbc_signal.line, "Incompatible CAN value type and CAN values converter type for the CAN signal");
+                }
+            }
+        }
+        else
+        {
+            setErrorMessage("SG_", dbc_signal.line, "Incompatible CAN value type for the CAN signal");
+        }
+        if (ret)
+        {
+            can_msg->addSignal(signal);
+        }
+    }
+
+    // Add message to the list
+    if (ret)
+    {
+        m_can_msgs[dbc_msg.id] = can_msg;
+    }
+
+    return ret;
+}
+
+/** \brief Create the CAN message value of a parsed signal */
+bool DbcFileCanMsgDatabase::buildValue(const DbcSignal& dbc_signal, std::shared_ptr<ICanMsgValue>& value)
+{
+    bool ret = true;
+
+    shared_ptr<ICanMsgValue> can_value;
+    if ((dbc_signal.type == CANMSGVALUE_FLOAT) || (dbc_signal.type == CANMSGVALUE_DOUBLE))
+    {
+        auto float_value = m_storage.create<FloatCanMsgValue>();
+        float_value->setPrecision(dbc_signal.type == CANMSGVALUE_FLOAT);
+        ret = (float_value->getSizeInBits() == dbc_signal.size_in_bits);
+        can_value = float_value;
+    }
+    else
+    {
+        auto int_value = m_storage.create<IntegerCanMsgValue>();
+        int_value->setSignedness(dbc_signal.type == CANMSGVALUE_INT);
+        ret = int_value->setSizeInBits(dbc_signal.size_in_bits);
+        can_value = int_value;
+    }
+    value = can_value;
+
+    // The DBC start bit has the same layout as the byte and bit positions : 8 * byte + bit
+    if (ret)
+    {
+        can_value->setByteOrder(dbc_signal.big_endian ? CANMSG_BIG_ENDIAN : CANMSG_LITTLE_ENDIAN);
+        ret = (can_value->setBitPosition(dbc_signal.start_bit % 8u) && can_value->setBytePosition(dbc_signal.start_bit / 8u));
+    }
+    if (!ret)
+    {
+        setErrorMessage("SG_", dbc_signal.line, "Invalid size or position for the CAN signal");
+    }
+
+    return ret;
+}
+
+/** \brief Create the converter of a parsed signal (nullptr if the signal has no converter) */
+std::shared_ptr<ICanMsgValueConverter> DbcFileCanMsgDatabase::buildConverter(const DbcSignal& dbc_signal)
+{
+    shared_ptr<ICanMsgValueConverter> converter;
+
+    // The value descriptions apply to the raw values and take precedence over the linear conversion
+    const string name(dbc_signal.name);
+    if (!dbc_signal.labels.empty())
+    {
+        auto enum_converter = m_storage.create<EnumCanMsgValueConverter>(name, "enum_converter");
+        for (size_t i = 0; i < dbc_signal.labels.size(); i++)
+        {
+            enum_converter->addValue(dbc_signal.labels[i].first, string(dbc_signal.labels[i].second));
+        }
+        converter = enum_converter;
+    }
+    else if ((dbc_signal.factor != 1.) || (dbc_signal.offset != 0.))
+    {
+        // A range of [0|0] means that the range is not specified
+        auto linear_converter = m_storage.create<LinearCanMsgValueConverter>(name, "linear_converter");
+        linear_converter->setCoefficients(dbc_signal.factor, dbc_signal.offset);
+        if (dbc_signal.min < dbc_signal.max)
+        {
+            linear_converter->setBounds(dbc_signal.min, dbc_signal.max);
+        }
+        converter = linear_converter;
+    }
+
+    return converter;
+}
+
+
+/** \brief Skip the spaces and the line endings */
+void DbcFileCanMsgDatabase::skipSpaces()
+{
+    bool space = true;
+    while (space && (m_current < m_end))
+    {
+        const char c = *m_current;
+        if (c == '\n')
+        {
+            m_line++;
+        }
+        else
+        {
+            space = ((c == ' ') || (c == '\t') || (c == '\r'));
+        }
+        if (space)
+        {
+            m_current++;
+        }
+    }
+}
+
+/** \brief Skip the end of the current statement, a string left open at the end of a line continues the statement */
+void DbcFileCanMsgDatabase::skipStatement()
+{
+    bool in_string = false;
+    bool end_of_statement = false;
+    while (!end_of_statement && (m_current < m_end))
+    {
+        const char c = *m_current;
+        m_current++;
+        if (c == '\n')
+        {
+            m_line++;
+            end_of_statement = !in_string;
+        }
+        else if (c == '"')
+        {
+            in_string = !in_string;
+        }
+        else if ((c == '\\') && in_string && (m_current < m_end) && (*m_current == '"'))
+        {
+            m_current++;
+        }
+    }
+}
+
+/** \brief Skip the namespace section : the NS_ statement and its indented lines */
+void DbcFileCanMsgDatabase::skipNamespaceSection()
+{
+    // The section ends at the first line which is neither empty nor indented
+    skipStatement();
+    while ((m_current < m_end) && ((*m_current == ' ') || (*m_current == '\t') || (*m_current == '\r') || (*m_current == '\n')))
+    {
+        skipStatement();
+    }
+}
+
+/** \brief Check if the next character is the expected one and skip it */
+bool DbcFileCanMsgDatabase::expect(const char c)
+{
+    skipSpaces();
+    const bool ret = ((m_current < m_end) && (*m_current == c));
+    if (ret)
+    {
+        m_current++;
+    }
+    return ret;
+}
+
+/** \brief Read an identifier */
+bool DbcFileCanMsgDatabase::readIdentifier(std::string_view& identifier)
+{
+    skipSpaces();
+    const char* start = m_current;
+    while ((m_current < m_end) && isIdentifierChar(*m_current))
+    {
+        m_current++;
+    }
+    identifier = string_view(start, static_cast<size_t>(m_current - start));
+    return !identifier.empty();
+}
+
+/** \brief Read a double quoted string */
+bool DbcFileCanMsgDatabase::readString(std::string_view& str)
+{
+    bool ret = false;
+    if (expect('"'))
+    {
+        const char* start = m_current;
+        while ((m_current < m_end) && (*m_current != '"'))
+        {
+            if (*m_current == '\n')
+            {
+                m_line++;
+            }
+            else if ((*m_current == '\\') && ((m_current + 1) < m_end) && (*(m_current + 1) == '"'))
+            {
+                m_current++;
+            }
+            m_current++;
+        }
+        if (m_current < m_end)
+        {
+            str = string_view(start, static_cast<size_t>(m_current - start));
+            m_current++;
+            ret = true;
+        }
+    }
+    return ret;
+}
+
+/** \brief Read an unsigned integer value */
+bool DbcFileCanMsgDatabase::readUint(uint64_t& value)
+{
+    skipSpaces();
+    const auto result = from_chars(m_current, m_end, value);
+    const bool ret = (result.ec == errc());
+    if (ret)
+    {
+        m_current = result.ptr;
+    }
+    return ret;
+}
+
+/** \brief Read an integer value */
+bool DbcFileCanMsgDatabase::readInt(int64_t& value)
+{
+    skipSpaces();
+    const auto result = from_chars(m_current, m_end, value);
+    const bool ret = (result.ec == errc());
+    if (ret)
+    {
+        m_current = result.ptr;
+    }
+    return ret;
+}
+
+/** \brief Read a floating point value */
+bool DbcFileCanMsgDatabase::readDouble(double& value)
+{
+    // The conversion doesn't accept an explicit positive sign
+    skipSpaces();
+    if ((m_current < m_end) && (*m_current == '+'))
+    {
+        m_current++;
+    }
+    const auto result = from_chars(m_current, m_end, value);
+    const bool ret = (result.ec == errc());
+    if (ret)
+    {
+        m_current = result.ptr;
+    }
+    return ret;
+}
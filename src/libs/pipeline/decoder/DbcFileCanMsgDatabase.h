@@ -0,0 +1,207 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DBCFILECANMSGDATABASE_H
+#define DBCFILECANMSGDATABASE_H
+
+#include "ICanMsgDatabase.h"
+#include "ICanMsgValueConverter.h"
+#include "CanMsgValueData.h"
+#include "CanMsgDatabaseStorage.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+
+/** \brief CAN message database stored in a Vector DBC file.
+           The file is memory-mapped and parsed in a single pass, only the BO_, SG_, VAL_ and
+           SIG_VALTYPE_ statements are interpreted, the other statements are skipped.
+           The messages are keyed by their DBC id (bit 31 set for the extended messages) */
+class DbcFileCanMsgDatabase : public ICanMsgDatabase
+{
+    public:
+
+        /** \brief Constructor */
+        DbcFileCanMsgDatabase();
+
+        /** \brief Destructor */
+        virtual ~DbcFileCanMsgDatabase();
+
+
+        /** \brief Load the message database from the file */
+        bool load(const std::string& dbc_file);
+
+
+        /** \brief Get the list of CAN messages */
+        virtual const std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& getCanMsgs() const override { return m_can_msgs; }
+
+        /** \brief Get the index of the names of the CAN messages and signals */
+        virtual const CanMsgNameIndex& getNameIndex() const override { return m_name_index; }
+
+
+        /** \brief Get the last error string */
+        const std::string& getLastError() { return m_last_error; }
+
+    private:
+
+        /** \brief Signal parsed from a SG_ statement */
+        struct DbcSignal
+        {
+            /** \brief Name */
+            std::string_view name;
+            /** \brief Unit */
+            std::string_view unit;
+            /** \brief Line of the statement */
+            size_t line;
+            /** \brief Start bit (least significant bit for Intel, most significant bit for Motorola) */
+            uint8_t start_bit;
+            /** \brief Size in bits */
+            uint8_t size_in_bits;
+            /** \brief Byte order */
+            bool big_endian;
+            /** \brief Type of the raw value */
+            CanMsgValueType type;
+            /** \brief Indicate if the signal is the multiplexer of the message */
+            bool multiplexer;
+            /** \brief Indicate if the signal is multiplexed */
+            bool multiplexed;
+            /** \brief Multiplexer value for which the signal is present */
+            uint64_t multiplexer_value;
+            /** \brief Factor */
+            double factor;
+            /** \brief Offset */
+            double offset;
+            /** \brief Minimum physical value */
+            double min;
+            /** \brief Maximum physical value */
+            double max;
+            /** \brief Labels of the raw values */
+            std::vector<std::pair<int64_t, std::string_view>> labels;
+        };
+
+        /** \brief Message parsed from a BO_ statement */
+        struct DbcMessage
+        {
+            /** \brief DBC id */
+            uint32_t id;
+            /** \brief Name */
+            std::string_view name;
+            /** \brief Line of the statement */
+            size_t line;
+            /** \brief Signals */
+            std::vector<DbcSignal> dbc_signals;
+        };
+
+
+        /** \brief Storage of the CAN messages, values, signals and converters, declared first so that it outlives their references */
+        CanMsgDatabaseStorage m_storage;
+
+        /** \brief Get the last error string */
+        std::string m_last_error;
+
+        /** \brief List of CAN messages */
+        std::map<uint32_t, std::shared_ptr<CanMsgDesc>> m_can_msgs;
+
+        /** \brief Index of the names of the CAN messages and signals */
+        CanMsgNameIndex m_name_index;
+
+
+        /** \brief Current parsing position in the file */
+        const char* m_current;
+
+        /** \brief End of the file */
+        const char* m_end;
+
+        /** \brief Current line in the file */
+        size_t m_line;
+
+        /** \brief Parsed messages */
+        std::vector<DbcMessage> m_dbc_msgs;
+
+        /** \brief Index of the parsed messages by DBC id */
+        std::unordered_map<uint32_t, size_t> m_dbc_msg_indexes;
+
+
+        /** \brief Set the error message of a statement */
+        void setErrorMessage(const char* statement, const size_t line, const char* error_msg);
+
+        /** \brief Parse the statements of the file */
+        bool parse();
+
+        /** \brief Parse a BO_ statement */
+        bool parseMessage(DbcMessage*& dbc_msg);
+
+        /** \brief Parse a SG_ statement */
+        bool parseSignal(DbcMessage* dbc_msg);
+
+        /** \brief Parse a VAL_ statement */
+        bool parseValueDescriptions();
+
+        /** \brief Parse a SIG_VALTYPE_ statement */
+        bool parseSignalValueType();
+
+        /** \brief Look for a parsed signal (nullptr if the signal doesn't exist) */
+        DbcSignal* findSignal(const uint64_t id, const std::string_view& name);
+
+        /** \brief Create the CAN message descriptions from the parsed messages */
+        bool build();
+
+        /** \brief Create the CAN message description of a parsed message */
+        bool buildMessage(const DbcMessage& dbc_msg);
+
+        /** \brief Create the CAN message value of a parsed signal */
+        bool buildValue(const DbcSignal& dbc_signal, std::shared_ptr<ICanMsgValue>& value);
+
+        /** \brief Create the converter of a parsed signal (nullptr if the signal has no converter) */
+        std::shared_ptr<ICanMsgValueConverter> buildConverter(const DbcSignal& dbc_signal);
+
+
+        /** \brief Skip the spaces and the line endings */
+        void skipSpaces();
+
+        /** \brief Skip the end of the current statement, a string left open at the end of a line continues the statement */
+        void skipStatement();
+
+        /** \brief Skip the namespace section : the NS_ statement and its indented lines */
+        void skipNamespaceSection();
+
+        /** \brief Check if the next character is the expected one and skip it */
+        bool expect(const char c);
+
+        /** \brief Read an identifier */
+        bool readIdentifier(std::string_view& identifier);
+
+        /** \brief Read a double quoted string */
+        bool readString(std::string_view& str);
+
+        /** \brief Read an unsigned integer value */
+        bool readUint(uint64_t& value);
+
+        /** \brief Read an integer value */
+        bool readInt(int64_t& value);
+
+        /** \brief Read a floating point value */
+        bool readDouble(double& value);
+};
+
+
+#endif // DBCFILECANMSGDATABASE_H
@@ -0,0 +1,63 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DecodedFrame.h"
+#include "CanMsgSignal.h"
+
+using namespace std;
+
+
+/** \brief Empty list of decoded signals */
+static const vector<size_t> s_no_decoded_signals;
+
+
+/** \brief Constructor */
+DecodedFrame::DecodedFrame()
+: m_can_msg(nullptr)
+, m_decoded_signals(&s_no_decoded_signals)
+, m_values()
+, m_converted_values()
+{}
+
+/** \brief Destructor */
+DecodedFrame::~DecodedFrame()
+{}
+
+/** \brief Prepare the frame to receive the values and signals of a CAN message */
+void DecodedFrame::reset(const CanMsgDesc& can_msg)
+{
+    m_can_msg = &can_msg;
+    m_decoded_signals = &s_no_decoded_signals;
+    m_values.resize(can_msg.getValues().size());
+    m_converted_values.resize(can_msg.getSignals().size());
+}
+
+/** \brief Get the raw value of a signal with its type */
+CanMsgTypedValue DecodedFrame::getTypedRawValue(const size_t signal_index) const
+{
+    const CanMsgTypedValue typed_value = { m_can_msg->getSignals()[signal_index]->getRawValueType(), getRawValue(signal_index) };
+    return typed_value;
+}
+
+/** \brief Get the converted value of a signal with its type */
+CanMsgTypedValue DecodedFrame::getTypedConvertedValue(const size_t signal_index) const
+{
+    const CanMsgTypedValue typed_value = { m_can_msg->getSignals()[signal_index]->getConvertedValueType(), m_converted_values[signal_index] };
+    return typed_value;
+}
@@ -0,0 +1,94 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DECODEDFRAME_H
+#define DECODEDFRAME_H
+
+#include "CanMsgDesc.h"
+#include "CanMsgValueData.h"
+
+#include <vector>
+
+
+/** \brief Values and signals of a decoded CAN message, a frame is owned by the caller of the decoding
+           and can be reused for any number of decodings without memory allocations once it has reached
+           the size of the biggest CAN message */
+class DecodedFrame
+{
+    public:
+
+        /** \brief Constructor */
+        DecodedFrame();
+
+        /** \brief Destructor */
+        virtual ~DecodedFrame();
+
+
+        /** \brief Prepare the frame to receive the values and signals of a CAN message */
+        void reset(const CanMsgDesc& can_msg);
+
+
+        /** \brief Get the decoded CAN message description */
+        const CanMsgDesc* getCanMsg() const { return m_can_msg; }
+
+        /** \brief Get the indexes of the decoded signals, the values of the other signals of the CAN message
+                   are not valid (multiplexed signals which are not selected) */
+        const std::vector<size_t>& getDecodedSignals() const { return *m_decoded_signals; }
+
+        /** \brief Set the indexes of the decoded signals */
+        void setDecodedSignals(const std::vector<size_t>& decoded_signals) { m_decoded_signals = &decoded_signals; }
+
+
+        /** \brief Get the values of the CAN message */
+        CanMsgValueData* getValues() { return m_values.data(); }
+
+        /** \brief Get the converted values of the CAN message's signals */
+        CanMsgValueData* getConvertedValues() { return m_converted_values.data(); }
+
+
+        /** \brief Get the raw value of a signal */
+        const CanMsgValueData& getRawValue(const size_t signal_index) const { return m_values[m_can_msg->getSignalValueIndex(signal_index)]; }
+
+        /** \brief Get the converted value of a signal */
+        const CanMsgValueData& getConvertedValue(const size_t signal_index) const { return m_converted_values[signal_index]; }
+
+        /** \brief Get the raw value of a signal with its type */
+        CanMsgTypedValue getTypedRawValue(const size_t signal_index) const;
+
+        /** \brief Get the converted value of a signal with its type */
+        CanMsgTypedValue getTypedConvertedValue(const size_t signal_index) const;
+
+
+    private:
+
+        /** \brief Decoded CAN message description */
+        const CanMsgDesc* m_can_msg;
+
+        /** \brief Indexes of the decoded signals */
+        const std::vector<size_t>* m_decoded_signals;
+
+        /** \brief Values of the CAN message */
+        std::vector<CanMsgValueData> m_values;
+
+        /** \brief Converted values of the CAN message's signals */
+        std::vector<CanMsgValueData> m_converted_values;
+};
+
+
+#endif // DECODEDFRAME_H
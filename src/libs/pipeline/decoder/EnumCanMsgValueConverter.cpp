@@ -19,25 +19,34 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "EnumCanMsgValueConverter.h"
 
+#include <algorithm>
 
 using namespace std;
 
 
+/** \brief Index of the label of the unknown enumerate values (empty label) */
+const uint32_t EnumCanMsgValueConverter::UNKNOWN_LABEL_INDEX;
+
+/** \brief Maximum number of entries of a dense table */
+static const uint64_t MAX_DENSE_TABLE_SIZE = 65536u;
+
 
 /** \brief Constructor */
 EnumCanMsgValueConverter::EnumCanMsgValueConverter(const std::string& name, const std::string& type)
-: CanMsgValueConverterBase(name, type, "string")
-, m_value("")
-, m_enum()
-, m_can_value(nullptr)
+: CanMsgValueConverterBase(name, type, CANMSGVALUE_STRING)
+, m_labels(1u, "")
+, m_entries()
+, m_dense_first_value(0)
+, m_dense_labels()
 {}
 
 /** \brief Copy constructor */
 EnumCanMsgValueConverter::EnumCanMsgValueConverter(const EnumCanMsgValueConverter& copy)
-: CanMsgValueConverterBase(getName(), getType(), "string")
-, m_value(copy.m_value)
-, m_enum(copy.m_enum)
-, m_can_value(nullptr)
+: CanMsgValueConverterBase(copy.getName(), copy.getType(), CANMSGVALUE_STRING)
+, m_labels(copy.m_labels)
+, m_entries(copy.m_entries)
+, m_dense_first_value(copy.m_dense_first_value)
+, m_dense_labels(copy.m_dense_labels)
 {}
 
 /** \brief Destructor */
@@ -46,38 +55,48 @@ EnumCanMsgValueConverter::~EnumCanMsgValueConverter()
 
 
 /** \brief Set the associated CAN message value type */
-bool EnumCanMsgValueConverter::setCanMsgValue(ICanMsgValue& can_value)
+bool EnumCanMsgValueConverter::setCanMsgValue(const ICanMsgValue& can_value)
 {
     bool ret = false;
 
     // Check input type
-    const string& input_type = can_value.getType();
-    if ((input_type == "int") ||
-        (input_type == "uint"))
+    switch (can_value.getType())
     {
-        m_can_value = &can_value;
-        ret = true;
+        case CANMSGVALUE_INT:
+        case CANMSGVALUE_UINT:
+        {
+            ret = true;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
     }
 
     return ret;
 }
 
-/** \brief Convert the value from the associated CAN message value */
-void EnumCanMsgValueConverter::convertValue()
+/** \brief Convert a value of the associated CAN message value type */
+void EnumCanMsgValueConverter::convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const
+{
+    // Signed and unsigned values share the same bits
+    converted_value.string_value = &m_labels[getLabelIndex(value.int_value)];
+}
+
+/** \brief Convert back a converted value to a value of the associated CAN message value type */
+bool EnumCanMsgValueConverter::revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const
 {
-    if (m_can_value != nullptr)
+    bool ret = false;
+
+    if (converted_value.string_value != nullptr)
     {
-        uint64_t value = m_input_converter.convert(m_can_value->getValue());
-        auto iter = m_enum.find(value);
-        if (iter == m_enum.end())
-        {
-            m_value = "";
-        }
-        else
-        {
-            m_value = iter->second;
-        }
+        // Signed and unsigned values share the same bits
+        ret = getValue(*converted_value.string_value, value.int_value);
     }
+
+    return ret;
 }
 
 /** \brief Clone the converter */
@@ -89,5 +108,95 @@ ICanMsgValueConverter* EnumCanMsgValueConverter::clone() const
 /** \brief Add a value to the enumerate */
 void EnumCanMsgValueConverter::addValue(const int64_t value, const std::string& str_value)
 {
-    m_enum[value] = str_value;
+    const uint32_t label_index = internLabel(str_value);
+
+    // Insert or replace the entry, keeping the entries sorted
+    auto iter = lower_bound(m_entries.begin(), m_entries.end(), value, [](const EnumEntry& entry, const int64_t val) { return (entry.value < val); });
+    if ((iter != m_entries.end()) && (iter->value == value))
+    {
+        iter->label_index = label_index;
+    }
+    else
+    {
+        const EnumEntry entry = { value, label_index };
+        m_entries.insert(iter, entry);
+    }
+
+    buildDenseTable();
+}
+
+/** \brief Get the index of the label of an enumerate value, UNKNOWN_LABEL_INDEX if the value is unknown */
+uint32_t EnumCanMsgValueConverter::getLabelIndex(const int64_t value) const
+{
+    uint32_t label_index = UNKNOWN_LABEL_INDEX;
+
+    if (!m_dense_labels.empty())
+    {
+        // Direct access
+        const uint64_t offset = static_cast<uint64_t>(value) - static_cast<uint64_t>(m_dense_first_value);
+        if (offset < m_dense_labels.size())
+        {
+            label_index = m_dense_labels[offset];
+        }
+    }
+    else
+    {
+        // Binary search
+        auto iter = lower_bound(m_entries.begin(), m_entries.end(), value, [](const EnumEntry& entry, const int64_t val) { return (entry.value < val); });
+        if ((iter != m_entries.end()) && (iter->value == value))
+        {
+            label_index = iter->label_index;
+        }
+    }
+
+    return label_index;
+}
+
+/** \brief Look for the enumerate value of a label, return false if the label doesn't exist */
+bool EnumCanMsgValueConverter::getValue(const std::string_view& label, int64_t& value) const
+{
+    bool ret = false;
+
+    for (size_t i = 0; !ret && (i < m_entries.size()); i++)
+    {
+        if (m_labels[m_entries[i].label_index] == label)
+        {
+            value = m_entries[i].value;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Get the index of a label, the label is interned if needed */
+uint32_t EnumCanMsgValueConverter::internLabel(const std::string& label)
+{
+    auto iter = find(m_labels.begin(), m_labels.end(), label);
+    if (iter == m_labels.end())
+    {
+        iter = m_labels.insert(m_labels.end(), label);
+    }
+    return static_cast<uint32_t>(iter - m_labels.begin());
+}
+
+/** \brief Build the dense table if the enumerate values are dense enough */
+void EnumCanMsgValueConverter::buildDenseTable()
+{
+    m_dense_labels.clear();
+
+    if (!m_entries.empty())
+    {
+        // The table is used when at least 1 entry out of 2 is defined
+        const uint64_t range = static_cast<uint64_t>(m_entries.back().value) - static_cast<uint64_t>(m_entries.front().value);
+        if ((range < MAX_DENSE_TABLE_SIZE) && (range < (2u * m_entries.size() + 16u)))
+        {
+            m_dense_first_value = m_entries.front().value;
+            m_dense_labels.resize(range + 1u, UNKNOWN_LABEL_INDEX);
+            for (size_t i = 0; i < m_entries.size(); i++)
+            {
+                m_dense_labels[static_cast<uint64_t>(m_entries[i].value) - static_cast<uint64_t>(m_dense_first_value)] = m_entries[i].label_index;
+            }
+        }
+    }
 }
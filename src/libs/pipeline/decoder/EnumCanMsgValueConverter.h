@@ -21,16 +21,21 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define ENUMCANMSGVALUECONVERTER_H
 
 #include "CanMsgValueConverterBase.h"
-#include "InputCanMsgValueConverter.h"
 
-#include <map>
+#include <vector>
+#include <string_view>
 
 
-/** \brief Convert a CAN message value to a string */
+/** \brief Convert a CAN message value to a string : the labels are interned when the enumerate is built
+           and the conversion returns a stable reference to the label without any copy */
 class EnumCanMsgValueConverter : public CanMsgValueConverterBase
 {
     public:
 
+        /** \brief Index of the label of the unknown enumerate values (empty label) */
+        static const uint32_t UNKNOWN_LABEL_INDEX = 0u;
+
+
         /** \brief Constructor */
         EnumCanMsgValueConverter(const std::string& name, const std::string& type);
 
@@ -42,13 +47,13 @@ class EnumCanMsgValueConverter : public CanMsgValueConverterBase
 
 
         /** \brief Set the associated CAN message value type */
-        virtual bool setCanMsgValue(ICanMsgValue& can_value) override;
+        virtual bool setCanMsgValue(const ICanMsgValue& can_value) override;
 
-        /** \brief Convert the value from the associated CAN message value */
-        virtual void convertValue() override;
+        /** \brief Convert a value of the associated CAN message value type */
+        virtual void convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const override;
 
-        /** \brief Get the converted value */
-        virtual const void* getValue() const override { return &m_value; }
+        /** \brief Convert back a converted value to a value of the associated CAN message value type */
+        virtual bool revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const override;
 
 
         /** \brief Clone the converter */
@@ -60,19 +65,55 @@ class EnumCanMsgValueConverter : public CanMsgValueConverterBase
         void addValue(const int64_t value, const std::string& str_value);
 
 
+        /** \brief Get the index of the label of an enumerate value, UNKNOWN_LABEL_INDEX if the value is unknown */
+        uint32_t getLabelIndex(const int64_t value) const;
+
+        /** \brief Get a label from its index */
+        std::string_view getLabel(const uint32_t label_index) const { return m_labels[label_index]; }
+
+        /** \brief Get the number of labels, including the label of the unknown values */
+        size_t getLabelCount() const { return m_labels.size(); }
+
+        /** \brief Look for the enumerate value of a label, return false if the label doesn't exist */
+        bool getValue(const std::string_view& label, int64_t& value) const;
+
+        /** \brief Get the number of values of the enumerate */
+        size_t getEntryCount() const { return m_entries.size(); }
+
+        /** \brief Get a value of the enumerate and its label from its index, the values are sorted */
+        int64_t getEntry(const size_t index, std::string_view& label) const { label = m_labels[m_entries[index].label_index]; return m_entries[index].value; }
+
+
     private:
 
-        /** \brief Value */
-        std::string m_value;
+        /** \brief Entry of the enumerate */
+        struct EnumEntry
+        {
+            /** \brief Value */
+            int64_t value;
+            /** \brief Index of the label */
+            uint32_t label_index;
+        };
+
+
+        /** \brief Interned labels */
+        std::vector<std::string> m_labels;
+
+        /** \brief Enumerate entries sorted by value */
+        std::vector<EnumEntry> m_entries;
+
+        /** \brief Value of the first entry of the dense table */
+        int64_t m_dense_first_value;
+
+        /** \brief Labels indexes by value for dense enumerates (empty for sparse enumerates) */
+        std::vector<uint32_t> m_dense_labels;
 
-        /** \brief Enumerate */
-        std::map<int64_t, std::string> m_enum;
 
-        /** \brief CAN message value object */
-        ICanMsgValue* m_can_value;
+        /** \brief Get the index of a label, the label is interned if needed */
+        uint32_t internLabel(const std::string& label);
 
-        /** \brief Input value converter */
-        InputCanMsgValueConverter<uint64_t, uint64_t> m_input_converter;
+        /** \brief Build the dense table if the enumerate values are dense enough */
+        void buildDenseTable();
 };
 
 
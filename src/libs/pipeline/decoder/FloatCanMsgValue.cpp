@@ -22,10 +22,8 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Constructor */
 FloatCanMsgValue::FloatCanMsgValue()
 : CanMsgValueBase()
-, m_type("float")
+, m_type(CANMSGVALUE_FLOAT)
 , m_sp_float_value(true)
-, m_sp_value(0.f)
-, m_dp_value(0.)
 {
     // Set bit size
     setPrecision(true);
@@ -35,19 +33,6 @@ FloatCanMsgValue::FloatCanMsgValue()
 FloatCanMsgValue::~FloatCanMsgValue()
 {}
 
-/** \brief Update the value from a CAN message */
-void FloatCanMsgValue::updateValue(const CanMsg& can_msg)
-{
-    if (m_sp_float_value)
-    {
-        getMaskedValue(can_msg, &m_sp_value);
-    }
-    else
-    {
-        getMaskedValue(can_msg, &m_dp_value);
-    }
-}
-
 /** \brief Set the precision of the floating point value */
 bool FloatCanMsgValue::setPrecision(const bool sp_float_value)
 {
@@ -70,11 +55,11 @@ bool FloatCanMsgValue::setPrecision(const bool sp_float_value)
         m_sp_float_value = sp_float_value;
         if (m_sp_float_value)
         {
-            m_type = "float";
+            m_type = CANMSGVALUE_FLOAT;
         }
         else 
         {
-            m_type = "double";
+            m_type = CANMSGVALUE_DOUBLE;
         }
     }
     else
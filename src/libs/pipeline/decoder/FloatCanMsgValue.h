@@ -37,14 +37,7 @@ class FloatCanMsgValue : public CanMsgValueBase
 
 
         /** \brief Get the value's type */
-        virtual const std::string& getType() const override { return m_type; }
-
-
-        /** \brief Get the value */
-        virtual const void* getValue() const override { if (m_sp_float_value) return &m_sp_value; else return &m_dp_value; }
-
-        /** \brief Update the value from a CAN message */
-        virtual void updateValue(const CanMsg& can_msg) override;
+        virtual CanMsgValueType getType() const override { return m_type; }
 
 
         /** \brief Set the precision of the floating point value */
@@ -54,16 +47,10 @@ class FloatCanMsgValue : public CanMsgValueBase
     private:
 
         /** \brief Type */
-        std::string m_type;
+        CanMsgValueType m_type;
 
         /** \brief Indicate if its a single precision floating point value */
         bool m_sp_float_value;
-
-        /** \brief Value as single precision floating point value */
-        float m_sp_value;
-
-        /** \brief Value as double precision floating point value */
-        double m_dp_value;
 };
 
 
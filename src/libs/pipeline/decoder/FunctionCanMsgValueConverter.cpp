@@ -25,27 +25,30 @@ using namespace std;
 
 /** \brief Constructor */
 FunctionCanMsgValueConverter::FunctionCanMsgValueConverter(const std::string& name, const std::string& type)
-: CanMsgValueConverterBase(name, type, "double")
+: CanMsgValueConverterBase(name, type, CANMSGVALUE_DOUBLE)
 , m_transfer_function("")
 , m_transfer_math_expr()
-, m_value(0.)
-, m_can_value(nullptr)
 , m_input_converter(nullptr)
-, m_math_expr_env()
+, m_input_type(CANMSGVALUE_DOUBLE)
+, m_invertible(false)
+, m_factor(1.)
+, m_offset(0.)
 {}
 
 /** \brief Copy constructor */
 FunctionCanMsgValueConverter::FunctionCanMsgValueConverter(const FunctionCanMsgValueConverter& copy)
-: CanMsgValueConverterBase(getName(), getType(), "double")
+: CanMsgValueConverterBase(copy.getName(), copy.getType(), CANMSGVALUE_DOUBLE)
 , m_transfer_function(copy.m_transfer_function)
 , m_transfer_math_expr()
-, m_value(copy.m_value)
-, m_can_value(nullptr)
 , m_input_converter(nullptr)
-, m_math_expr_env(copy.m_math_expr_env)
+, m_input_type(CANMSGVALUE_DOUBLE)
+, m_invertible(false)
+, m_factor(1.)
+, m_offset(0.)
 {
     MathExpressionParser parser;
     parser.parse(m_transfer_function, m_transfer_math_expr);
+    updateInverse();
 }
 
 /** \brief Destructor */
@@ -56,52 +59,78 @@ FunctionCanMsgValueConverter::~FunctionCanMsgValueConverter()
 
 
 /** \brief Set the associated CAN message value type */
-bool FunctionCanMsgValueConverter::setCanMsgValue(ICanMsgValue& can_value)
+bool FunctionCanMsgValueConverter::setCanMsgValue(const ICanMsgValue& can_value)
 {
     bool ret = true;
     IInputCanMsgValueConverter<double>* input_converter = nullptr;
 
     // Check input type
-    const string& input_type = can_value.getType();
-    if (input_type == "int")
+    switch (can_value.getType())
     {
-        input_converter = new InputCanMsgValueConverter<int64_t, double>();
-    }
-    else if (input_type == "uint")
-    {
-        input_converter = new InputCanMsgValueConverter<uint64_t, double>();
-    }
-    else if (input_type == "float")
-    {
-        input_converter = new InputCanMsgValueConverter<float, double>();
-    }
-    else if(input_type == "double")
-    {
-        input_converter = new InputCanMsgValueConverter<double, double>();
-    }
-    else
-    {
-        ret = false;
+        case CANMSGVALUE_INT:
+        {
+            input_converter = new InputCanMsgValueConverter<int64_t, double>();
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        {
+            input_converter = new InputCanMsgValueConverter<uint64_t, double>();
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            input_converter = new InputCanMsgValueConverter<float, double>();
+            break;
+        }
+
+        case CANMSGVALUE_DOUBLE:
+        {
+            input_converter = new InputCanMsgValueConverter<double, double>();
+            break;
+        }
+
+        default:
+        {
+            ret = false;
+            break;
+        }
     }
     if (ret)
     {
-        // Save CAN message value and input converter
-        m_can_value = &can_value;
+        // Save input converter
         delete m_input_converter;
         m_input_converter = input_converter;
+        m_input_type = can_value.getType();
     }
 
     return ret;
 }
 
-/** \brief Convert the value from the associated CAN message value */
-void FunctionCanMsgValueConverter::convertValue()
+/** \brief Convert a value of the associated CAN message value type */
+void FunctionCanMsgValueConverter::convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const
+{
+    // Environment for the evaluation, one per thread to avoid allocations and data races
+    static thread_local IMathExpression::MathExpressionEnv math_expr_env;
+
+    math_expr_env["in_val"] = m_input_converter->convert(&value);
+    converted_value.double_value = m_transfer_math_expr->evaluate(math_expr_env);
+}
+
+/** \brief Convert back a converted value to a value of the associated CAN message value type */
+bool FunctionCanMsgValueConverter::revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const
 {
-    if (m_can_value != nullptr)
+    bool ret = false;
+
+    // Only the linear transfer functions can be inverted
+    if (m_invertible)
     {
-        m_math_expr_env["in_val"] = m_input_converter->convert(m_can_value->getValue());
-        m_value = m_transfer_math_expr->evaluate(m_math_expr_env);
+        value = fromDouble((converted_value.double_value - m_offset) / m_factor, m_input_type);
+        ret = true;
     }
+
+    return ret;
 }
 
 /** \brief Clone the converter */
@@ -110,9 +139,29 @@ ICanMsgValueConverter* FunctionCanMsgValueConverter::clone() const
     return new FunctionCanMsgValueConverter(*this);
 }
 
+/** \brief Decompose the transfer function as in_val * factor + offset, return false if it is not linear */
+bool FunctionCanMsgValueConverter::getLinearCoefficients(double& factor, double& offset) const
+{
+    bool ret = false;
+
+    if (m_transfer_math_expr)
+    {
+        ret = m_transfer_math_expr->getLinearCoefficients("in_val", factor, offset);
+    }
+
+    return ret;
+}
+
 /** \brief Set the custom transfer function */
 void FunctionCanMsgValueConverter::setTransferFunction(const std::string& transfer_function, std::unique_ptr<IMathExpression>& transfer_math_expr)
 {
     m_transfer_function = transfer_function;
     m_transfer_math_expr.swap(transfer_math_expr);
+    updateInverse();
+}
+
+/** \brief Check if the transfer function can be inverted */
+void FunctionCanMsgValueConverter::updateInverse()
+{
+    m_invertible = (getLinearCoefficients(m_factor, m_offset) && (m_factor != 0.));
 }
@@ -44,13 +44,13 @@ class FunctionCanMsgValueConverter : public CanMsgValueConverterBase
 
 
         /** \brief Set the associated CAN message value type */
-        virtual bool setCanMsgValue(ICanMsgValue& can_value) override;
+        virtual bool setCanMsgValue(const ICanMsgValue& can_value) override;
 
-        /** \brief Convert the value from the associated CAN message value */
-        virtual void convertValue() override;
+        /** \brief Convert a value of the associated CAN message value type */
+        virtual void convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const override;
 
-        /** \brief Get the converted value */
-        virtual const void* getValue() const override { return &m_value; }
+        /** \brief Convert back a converted value to a value of the associated CAN message value type */
+        virtual bool revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const override;
 
 
         /** \brief Clone the converter */
@@ -60,6 +60,12 @@ class FunctionCanMsgValueConverter : public CanMsgValueConverterBase
         /** \brief Set the custom transfer function */
         void setTransferFunction(const std::string& transfer_function, std::unique_ptr<IMathExpression>& transfer_math_expr);
 
+        /** \brief Get the custom transfer function */
+        const std::string& getTransferFunction() const { return m_transfer_function; }
+
+        /** \brief Decompose the transfer function as in_val * factor + offset, return false if it is not linear */
+        bool getLinearCoefficients(double& factor, double& offset) const;
+
 
     private:
 
@@ -69,17 +75,24 @@ class FunctionCanMsgValueConverter : public CanMsgValueConverterBase
         /** \brief Transfer function as a mathematical expression */
         std::unique_ptr<IMathExpression> m_transfer_math_expr;
 
-        /** \brief Value */
-        double m_value;
-
-        /** \brief CAN message value object */
-        ICanMsgValue* m_can_value;
-
         /** \brief Input value converter */
         IInputCanMsgValueConverter<double>* m_input_converter;
 
-        /** \brief Environment for CAN message value's evalutation */
-        IMathExpression::MathExpressionEnv m_math_expr_env;
+        /** \brief Input value type */
+        CanMsgValueType m_input_type;
+
+        /** \brief Indicate if the transfer function is linear and can be inverted */
+        bool m_invertible;
+
+        /** \brief Factor of the linear transfer function */
+        double m_factor;
+
+        /** \brief Offset of the linear transfer function */
+        double m_offset;
+
+
+        /** \brief Check if the transfer function can be inverted */
+        void updateInverse();
 
 };
 
@@ -21,9 +21,12 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define ICANMSGDATABASE_H
 
 #include "CanMsgDesc.h"
+#include "CanMsgNameIndex.h"
 
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 /** \brief Interface for all CAN message database implementations */
 class ICanMsgDatabase
@@ -37,6 +40,34 @@ class ICanMsgDatabase
         /** \brief Get the list of CAN messages */
         virtual const std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& getCanMsgs() const = 0;
 
+        /** \brief Get the index of the names of the CAN messages and signals, it is built when the database is loaded */
+        virtual const CanMsgNameIndex& getNameIndex() const = 0;
+
+        /** \brief Indicate if the database builds its CAN messages on demand : getCanMsgs() and the index of the names
+                   then stay empty and the CAN messages are only reachable through loadCanMsg(), loadSignalCanMsg()
+                   and loadAllCanMsgs() */
+        virtual bool isLazy() const { return false; }
+
+        /** \brief Load a CAN message of a database which builds its CAN messages on demand, return nullptr if the database
+                   doesn't contain the message or doesn't build its CAN messages on demand. A loaded message stays valid
+                   as long as the database exists and the same description is returned on each call */
+        virtual const CanMsgDesc* loadCanMsg(const uint32_t id, const bool extended) const { (void)id; (void)extended; return nullptr; }
+
+        /** \brief Load the CAN message containing a signal of a database which builds its CAN messages on demand,
+                   return nullptr if the database doesn't contain the signal or doesn't build its CAN messages on demand */
+        virtual const CanMsgDesc* loadSignalCanMsg(const std::string& signal_name) const { (void)signal_name; return nullptr; }
+
+        /** \brief List all the CAN messages of the database in the order of getCanMsgs(), a database which builds its CAN
+                   messages on demand builds all of them and lists them by id (the CAN messages which can't be built are skipped) */
+        virtual void loadAllCanMsgs(std::vector<const CanMsgDesc*>& can_msgs) const
+        {
+            can_msgs.clear();
+            const auto& db_can_msgs = getCanMsgs();
+            for (auto iter = db_can_msgs.cbegin(); iter != db_can_msgs.cend(); ++iter)
+            {
+                can_msgs.push_back(iter->second.get());
+            }
+        }
 
 };
 
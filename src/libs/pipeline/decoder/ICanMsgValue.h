@@ -21,11 +21,23 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define ICANMSGVALUE_H
 
 #include "CanData.h"
+#include "CanMsgValueData.h"
 
 #include <string>
 
 class CanMsgDesc;
 
+
+/** \brief Byte orders of the CAN message values */
+enum CanMsgByteOrder
+{
+    /** \brief Little endian (Intel) : the byte and bit positions are the ones of the value's least significant bit */
+    CANMSG_LITTLE_ENDIAN = 0,
+    /** \brief Big endian (Motorola) : the byte and bit positions are the ones of the value's most significant bit */
+    CANMSG_BIG_ENDIAN = 1
+};
+
+
 /** \brief Interface for CAN message values implementations */
 class ICanMsgValue
 {
@@ -43,7 +55,14 @@ class ICanMsgValue
 
 
         /** \brief Get the value's type */
-        virtual const std::string& getType() const = 0;
+        virtual CanMsgValueType getType() const = 0;
+
+
+        /** \brief Get the value's byte order */
+        virtual CanMsgByteOrder getByteOrder() const = 0;
+
+        /** \brief Set the value's byte order, the byte and bit positions must be set afterwards */
+        virtual void setByteOrder(const CanMsgByteOrder byte_order) = 0;
 
 
         /** \brief Get the value's byte position inside the CAN message */
@@ -60,23 +79,20 @@ class ICanMsgValue
         virtual bool setBitPosition(const uint8_t position) = 0;
 
 
-        /** \brief Get the value's start bit position inside inside the CAN message */
+        /** \brief Get the value's start bit position inside the CAN message payload loaded as a 64 bits word
+                   in the value's byte order */
         virtual uint8_t getStartBitPosition() const = 0;
 
-        /** \brief Get the value's end bit position inside inside the CAN message */
+        /** \brief Get the value's end bit position inside the CAN message payload loaded as a 64 bits word
+                   in the value's byte order */
         virtual uint8_t getEndBitPosition() const = 0;
 
+        /** \brief Get the mask of the value's bits inside the CAN message payload loaded as a little endian 64 bits word */
+        virtual uint64_t getPayloadMask() const = 0;
+
 
         /** \brief Get the value's size in bits */
         virtual uint8_t getSizeInBits() const = 0;
-
-
-        /** \brief Get the value */
-        virtual const void* getValue() const = 0;
-
-        /** \brief Update the value from a CAN message */
-        virtual void updateValue(const CanMsg& can_msg) = 0;
-
 };
 
 
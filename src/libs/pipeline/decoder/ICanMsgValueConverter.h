@@ -21,9 +21,11 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define ICANMSGVALUECONVERTER_H
 
 #include "ICanMsgValue.h"
+#include "CanMsgValueData.h"
 
 
-/** \brief Interface for CAN message value converters implementations */
+/** \brief Interface for CAN message value converters implementations, a converter is immutable once
+           associated to its CAN message value so that it can be used concurrently by several threads */
 class ICanMsgValueConverter
 {
     public:
@@ -39,17 +41,18 @@ class ICanMsgValueConverter
         virtual const std::string& getType() const = 0;
 
         /** \brief Get the converter's output type */
-        virtual const std::string& getOutputType() const = 0;
+        virtual CanMsgValueType getOutputType() const = 0;
 
 
         /** \brief Set the associated CAN message value type */
-        virtual bool setCanMsgValue(ICanMsgValue& can_value) = 0;
+        virtual bool setCanMsgValue(const ICanMsgValue& can_value) = 0;
 
-        /** \brief Convert the value from the associated CAN message value */
-        virtual void convertValue() = 0;
+        /** \brief Convert a value of the associated CAN message value type */
+        virtual void convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const = 0;
 
-        /** \brief Get the converted value */
-        virtual const void* getValue() const = 0;
+        /** \brief Convert back a converted value to a value of the associated CAN message value type,
+                   return false if the converter can't be inverted or if the converted value has no antecedent */
+        virtual bool revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const = 0;
 
 
         /** \brief Clone the converter */
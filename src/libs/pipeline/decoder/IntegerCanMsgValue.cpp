@@ -22,10 +22,8 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Constructor */
 IntegerCanMsgValue::IntegerCanMsgValue()
 : CanMsgValueBase()
-, m_type("int")
+, m_type(CANMSGVALUE_INT)
 , m_signed_value(true)
-, m_svalue(0)
-, m_uvalue(0)
 {
     // Set bit size
     setSizeInBits(64u);
@@ -35,21 +33,6 @@ IntegerCanMsgValue::IntegerCanMsgValue()
 IntegerCanMsgValue::~IntegerCanMsgValue()
 {}
 
-/** \brief Update the value from a CAN message */
-void IntegerCanMsgValue::updateValue(const CanMsg& can_msg)
-{
-    if (m_signed_value)
-    {
-        int64_t inverted_value_mask = ~static_cast<uint64_t>(getBitMask());
-        getMaskedValue(can_msg, &m_svalue);
-        m_svalue |= inverted_value_mask;
-    }
-    else
-    {
-        getMaskedValue(can_msg, &m_uvalue);
-    }
-}
-
 /** \brief Set the size in bits of the value */
 bool IntegerCanMsgValue::setSizeInBits(const uint8_t size_in_bits)
 {
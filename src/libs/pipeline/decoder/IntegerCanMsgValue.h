@@ -37,18 +37,11 @@ class IntegerCanMsgValue : public CanMsgValueBase
 
 
         /** \brief Get the value's type */
-        virtual const std::string& getType() const override { return m_type; }
-
-
-        /** \brief Get the value */
-        virtual const void* getValue() const override { if (m_signed_value) return &m_svalue; else return &m_uvalue; }
-
-        /** \brief Update the value from a CAN message */
-        virtual void updateValue(const CanMsg& can_msg) override;
+        virtual CanMsgValueType getType() const override { return m_type; }
 
 
         /** \brief Set the signedness of the value */
-        void setSignedness(const bool signed_value) { m_signed_value = signed_value; if (m_signed_value) m_type = "int"; else m_type = "uint"; }
+        void setSignedness(const bool signed_value) { m_signed_value = signed_value; if (m_signed_value) m_type = CANMSGVALUE_INT; else m_type = CANMSGVALUE_UINT; }
 
         /** \brief Set the size in bits of the value */
         bool setSizeInBits(const uint8_t size_in_bits);
@@ -57,16 +50,10 @@ class IntegerCanMsgValue : public CanMsgValueBase
     private:
 
         /** \brief Type */
-        std::string m_type;
+        CanMsgValueType m_type;
 
         /** \brief Indicate if its a signed value */
         bool m_signed_value;
-
-        /** \brief Value as signed integer value */
-        int64_t m_svalue;
-
-        /** \brief Value as double precision floating point value */
-        uint64_t m_uvalue;
 };
 
 
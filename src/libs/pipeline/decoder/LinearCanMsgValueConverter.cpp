@@ -0,0 +1,141 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LinearCanMsgValueConverter.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+
+
+/** \brief Constructor */
+LinearCanMsgValueConverter::LinearCanMsgValueConverter(const std::string& name, const std::string& type)
+: CanMsgValueConverterBase(name, type, CANMSGVALUE_DOUBLE)
+, m_factor(1.)
+, m_offset(0.)
+, m_min(-numeric_limits<double>::infinity())
+, m_max(numeric_limits<double>::infinity())
+, m_input_type(CANMSGVALUE_DOUBLE)
+{}
+
+/** \brief Copy constructor */
+LinearCanMsgValueConverter::LinearCanMsgValueConverter(const LinearCanMsgValueConverter& copy)
+: CanMsgValueConverterBase(copy.getName(), copy.getType(), CANMSGVALUE_DOUBLE)
+, m_factor(copy.m_factor)
+, m_offset(copy.m_offset)
+, m_min(copy.m_min)
+, m_max(copy.m_max)
+, m_input_type(copy.m_input_type)
+{}
+
+/** \brief Destructor */
+LinearCanMsgValueConverter::~LinearCanMsgValueConverter()
+{}
+
+
+/** \brief Set the associated CAN message value type */
+bool LinearCanMsgValueConverter::setCanMsgValue(const ICanMsgValue& can_value)
+{
+    bool ret = true;
+
+    // Check input type
+    switch (can_value.getType())
+    {
+        case CANMSGVALUE_INT:
+        case CANMSGVALUE_UINT:
+        case CANMSGVALUE_FLOAT:
+        case CANMSGVALUE_DOUBLE:
+        {
+            m_input_type = can_value.getType();
+            break;
+        }
+
+        default:
+        {
+            ret = false;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Convert a value of the associated CAN message value type */
+void LinearCanMsgValueConverter::convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const
+{
+    double input_value;
+    switch (m_input_type)
+    {
+        case CANMSGVALUE_INT:
+        {
+            input_value = static_cast<double>(value.int_value);
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        {
+            input_value = static_cast<double>(value.uint_value);
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            input_value = value.float_value;
+            break;
+        }
+
+        default:
+        {
+            input_value = value.double_value;
+            break;
+        }
+    }
+
+#ifdef FP_FAST_FMA
+    const double output_value = fma(input_value, m_factor, m_offset);
+#else
+    // Without hardware support, std::fma is a slow software emulation
+    const double output_value = (input_value * m_factor) + m_offset;
+#endif // FP_FAST_FMA
+    converted_value.double_value = min(max(output_value, m_min), m_max);
+}
+
+/** \brief Convert back a converted value to a value of the associated CAN message value type */
+bool LinearCanMsgValueConverter::revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const
+{
+    bool ret = false;
+
+    // Values outside the bounds would have been clamped by the conversion
+    const double output_value = converted_value.double_value;
+    if ((m_factor != 0.) && (output_value >= m_min) && (output_value <= m_max))
+    {
+        value = fromDouble((output_value - m_offset) / m_factor, m_input_type);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** \brief Clone the converter */
+ICanMsgValueConverter* LinearCanMsgValueConverter::clone() const
+{
+    return new LinearCanMsgValueConverter(*this);
+}
@@ -0,0 +1,94 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LINEARCANMSGVALUECONVERTER_H
+#define LINEARCANMSGVALUECONVERTER_H
+
+#include "CanMsgValueConverterBase.h"
+
+
+/** \brief Convert a CAN message value to a double precision floating point value using
+           in_val * factor + offset, with an optional clamp of the result */
+class LinearCanMsgValueConverter : public CanMsgValueConverterBase
+{
+    public:
+
+        /** \brief Constructor */
+        LinearCanMsgValueConverter(const std::string& name, const std::string& type);
+
+        /** \brief Copy constructor */
+        LinearCanMsgValueConverter(const LinearCanMsgValueConverter& copy);
+
+        /** \brief Destructor */
+        virtual ~LinearCanMsgValueConverter();
+
+
+        /** \brief Set the associated CAN message value type */
+        virtual bool setCanMsgValue(const ICanMsgValue& can_value) override;
+
+        /** \brief Convert a value of the associated CAN message value type */
+        virtual void convert(const CanMsgValueData& value, CanMsgValueData& converted_value) const override;
+
+        /** \brief Convert back a converted value to a value of the associated CAN message value type */
+        virtual bool revert(const CanMsgValueData& converted_value, CanMsgValueData& value) const override;
+
+
+        /** \brief Clone the converter */
+        virtual ICanMsgValueConverter* clone() const;
+
+
+        /** \brief Set the transfer function coefficients */
+        void setCoefficients(const double factor, const double offset) { m_factor = factor; m_offset = offset; }
+
+        /** \brief Set the bounds of the converted value */
+        void setBounds(const double min, const double max) { m_min = min; m_max = max; }
+
+        /** \brief Get the factor */
+        double getFactor() const { return m_factor; }
+
+        /** \brief Get the offset */
+        double getOffset() const { return m_offset; }
+
+        /** \brief Get the lower bound of the converted value */
+        double getMin() const { return m_min; }
+
+        /** \brief Get the upper bound of the converted value */
+        double getMax() const { return m_max; }
+
+
+    private:
+
+        /** \brief Factor */
+        double m_factor;
+
+        /** \brief Offset */
+        double m_offset;
+
+        /** \brief Lower bound of the converted value */
+        double m_min;
+
+        /** \brief Upper bound of the converted value */
+        double m_max;
+
+        /** \brief Input value type */
+        CanMsgValueType m_input_type;
+};
+
+
+#endif // LINEARCANMSGVALUECONVERTER_H
@@ -27,23 +27,339 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "EnumCanMsgValueConverter.h"
 #include "FunctionCanMsgValueConverter.h"
+#include "LinearCanMsgValueConverter.h"
 #include "MathExpressionParser.h"
 
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
+#include <charconv>
 
 using namespace std;
 using namespace tinyxml2;
 
 
+/** \brief Tag of an XML element read by the XML tag scanner */
+struct XmlTag
+{
+    /** \brief Name */
+    string_view name;
+    /** \brief Indicate if it is an end tag */
+    bool end_tag;
+    /** \brief Indicate if it is the tag of an empty element */
+    bool empty_element;
+    /** \brief Offset of the tag in the file */
+    size_t offset;
+    /** \brief Line of the tag in the file */
+    int line;
+    /** \brief Attributes names and raw values */
+    vector<pair<string_view, string_view>> attributes;
+
+    /** \brief Get the raw value of an attribute, return false if the attribute doesn't exist */
+    bool getAttribute(const char* attribute_name, string_view& value) const
+    {
+        bool ret = false;
+        for (size_t i = 0; !ret && (i < attributes.size()); i++)
+        {
+            if (attributes[i].first == attribute_name)
+            {
+                value = attributes[i].second;
+                ret = true;
+            }
+        }
+        return ret;
+    }
+};
+
+/** \brief Scanner which reads the tags of an XML file without building the document, it only checks the syntax
+           of the tags so that the position of the elements can be indexed and the elements parsed later */
+class XmlTagScanner
+{
+    public:
+
+        /** \brief Constructor */
+        XmlTagScanner(const char* data, const size_t size)
+        : m_begin(data)
+        , m_current(data)
+        , m_end(data + size)
+        , m_line(1)
+        , m_error(nullptr)
+        {}
+
+        /** \brief Read the next tag, return false at the end of the file or on error */
+        bool next(XmlTag& tag)
+        {
+            bool ret = false;
+            bool done = false;
+            while (!done && (m_error == nullptr))
+            {
+                const char* tag_start = reinterpret_cast<const char*>(memchr(m_current, '<', static_cast<size_t>(m_end - m_current)));
+                if (tag_start == nullptr)
+                {
+                    moveTo(m_end);
+                    done = true;
+                }
+                else
+                {
+                    // Skip comments, CDATA sections, processing instructions and declarations
+                    moveTo(tag_start);
+                    if (startsWith("<!--"))
+                    {
+                        skipPast("-->");
+                    }
+                    else if (startsWith("<![CDATA["))
+                    {
+                        skipPast("]]>");
+                    }
+                    else if (startsWith("<?"))
+                    {
+                        skipPast("?>");
+                    }
+                    else if (startsWith("<!"))
+                    {
+                        skipPast(">");
+                    }
+                    else
+                    {
+                        ret = readTag(tag);
+                        done = true;
+                    }
+                }
+            }
+            return ret;
+        }
+
+        /** \brief Get the offset of the current position in the file */
+        size_t getOffset() const { return static_cast<size_t>(m_current - m_begin); }
+
+        /** \brief Get the line of the current position in the file */
+        int getLine() const { return m_line; }
+
+        /** \brief Get the syntax error (nullptr if no error) */
+        const char* getError() const { return m_error; }
+
+
+    private:
+
+        /** \brief Beginning of the file */
+        const char* const m_begin;
+        /** \brief Current position */
+        const char* m_current;
+        /** \brief End of the file */
+        const char* const m_end;
+        /** \brief Line of the current position */
+        int m_line;
+        /** \brief Syntax error */
+        const char* m_error;
+
+
+        /** \brief Move forward to a position and count the lines */
+        void moveTo(const char* position)
+        {
+            m_line += static_cast<int>(count(m_current, position, '\n'));
+            m_current = position;
+        }
+
+        /** \brief Indicate if the current position starts with a string */
+        bool startsWith(const char* str) const
+        {
+            const size_t len = strlen(str);
+            return ((static_cast<size_t>(m_end - m_current) >= len) && (memcmp(m_current, str, len) == 0));
+        }
+
+        /** \brief Move past the next occurence of a string */
+        void skipPast(const char* str)
+        {
+            const string_view remaining(m_current, static_cast<size_t>(m_end - m_current));
+            const size_t position = remaining.find(str, 1u);
+            if (position == string_view::npos)
+            {
+                m_error = "Unexpected end of file";
+            }
+            else
+            {
+                moveTo(m_current + position + strlen(str));
+            }
+        }
+
+        /** \brief Skip the whitespaces */
+        void skipSpaces()
+        {
+            const char* position = m_current;
+            while ((position < m_end) && isspace(static_cast<unsigned char>(*position)))
+            {
+                position++;
+            }
+            moveTo(position);
+        }
+
+        /** \brief Read a name */
+        string_view readName()
+        {
+            const char* start = m_current;
+            while ((m_current < m_end) && !isspace(static_cast<unsigned char>(*m_current)) &&
+                   (*m_current != '>') && (*m_current != '/') && (*m_current != '='))
+            {
+                m_current++;
+            }
+            return string_view(start, static_cast<size_t>(m_current - start));
+        }
+
+        /** \brief Read a start or end tag */
+        bool readTag(XmlTag& tag)
+        {
+            tag.offset = getOffset();
+            tag.line = m_line;
+            tag.end_tag = false;
+            tag.empty_element = false;
+            tag.attributes.clear();
+
+            m_current++;
+            if ((m_current < m_end) && (*m_current == '/'))
+            {
+                tag.end_tag = true;
+                m_current++;
+            }
+            tag.name = readName();
+            bool ret = !tag.name.empty();
+
+            bool closed = false;
+            while (ret && !closed)
+            {
+                skipSpaces();
+                if (startsWith(">"))
+                {
+                    m_current++;
+                    closed = true;
+                }
+                else if (!tag.end_tag && startsWith("/>"))
+                {
+                    m_current += 2;
+                    tag.empty_element = true;
+                    closed = true;
+                }
+                else if (tag.end_tag || (m_current == m_end))
+                {
+                    ret = false;
+                }
+                else
+                {
+                    // Attribute
+                    const string_view attribute_name = readName();
+                    skipSpaces();
+                    ret = (!attribute_name.empty() && startsWith("="));
+                    if (ret)
+                    {
+                        m_current++;
+                        skipSpaces();
+                        ret = (startsWith("\"") || startsWith("'"));
+                    }
+                    if (ret)
+                    {
+                        const char* value_start = m_current + 1;
+                        const char* value_end = reinterpret_cast<const char*>(memchr(value_start, *m_current, static_cast<size_t>(m_end - value_start)));
+                        ret = (value_end != nullptr);
+                        if (ret)
+                        {
+                            tag.attributes.emplace_back(attribute_name, string_view(value_start, static_cast<size_t>(value_end - value_start)));
+                            moveTo(value_end + 1);
+                        }
+                    }
+                }
+            }
+            if (!ret)
+            {
+                m_error = "Malformed XML tag";
+            }
+
+            return ret;
+        }
+};
+
+/** \brief Decode the entities of a raw XML attribute value */
+static string decodeXmlText(const string_view& raw_value)
+{
+    static const pair<const char*, char> entities[] = { {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''} };
+
+    string value;
+    value.reserve(raw_value.size());
+    size_t i = 0;
+    while (i < raw_value.size())
+    {
+        bool decoded = false;
+        if (raw_value[i] == '&')
+        {
+            for (size_t j = 0; !decoded && (j < (sizeof(entities) / sizeof(entities[0]))); j++)
+            {
+                const size_t len = strlen(entities[j].first);
+                if (raw_value.compare(i, len, entities[j].first) == 0)
+                {
+                    value += entities[j].second;
+                    i += len;
+                    decoded = true;
+                }
+            }
+        }
+        if (!decoded)
+        {
+            value += raw_value[i];
+            i++;
+        }
+    }
+    return value;
+}
+
+/** \brief Convert a raw XML attribute value representing either a decimal or an hexadecimal unsigned integer value */
+static bool parseUint(const string_view& raw_value, uint64_t& value)
+{
+    int base = 10;
+    string_view digits = raw_value;
+    if ((digits.size() > 2u) && (digits.substr(0u, 2u) == "0x"))
+    {
+        base = 16;
+        digits.remove_prefix(2u);
+    }
+    const auto result = from_chars(digits.data(), digits.data() + digits.size(), value, base);
+    return ((result.ec == errc()) && (result.ptr != digits.data()));
+}
+
+/** \brief Convert a raw XML attribute value representing a boolean value */
+static bool parseBool(const string_view& raw_value, bool& value)
+{
+    bool ret = true;
+    if ((raw_value == "true") || (raw_value == "True") || (raw_value == "TRUE") || (raw_value == "1"))
+    {
+        value = true;
+    }
+    else if ((raw_value == "false") || (raw_value == "False") || (raw_value == "FALSE") || (raw_value == "0"))
+    {
+        value = false;
+    }
+    else
+    {
+        ret = false;
+    }
+    return ret;
+}
+
+
 
 /** \brief Constructor */
 XmlFileCanMsgDatabase::XmlFileCanMsgDatabase()
-: m_last_error("")
+: m_storage()
+, m_last_error("")
 , m_can_msgs()
+, m_name_index()
 , m_can_msg_values()
 , m_can_msg_value_converters()
-, m_cloned_can_msg_value_converters()
-, m_can_msg_signals()
+, m_lazy(false)
+, m_xml_file()
+, m_lazy_can_msgs()
+, m_lazy_signals()
+, m_lazy_converters()
+, m_lazy_mutex()
+, m_line_offset(0)
 {}
 
 /** \brief Destructor */
@@ -51,61 +367,90 @@ XmlFileCanMsgDatabase::~XmlFileCanMsgDatabase()
 {}
 
 
-/** \brief Load the message database from the file */
-bool XmlFileCanMsgDatabase::load(const std::string& xml_file)
+/** \brief Load the message database from the file, in lazy mode the CAN messages are built on demand */
+bool XmlFileCanMsgDatabase::load(const std::string& xml_file, const bool lazy)
 {
     bool ret = false;
 
-    // Open file
-    XMLDocument xml_doc;
-    XMLError error = xml_doc.LoadFile(xml_file.c_str());
-    if (error == XML_SUCCESS)
+    m_lazy = lazy;
+    if (lazy)
     {
-        // Look for root node
-        XMLElement* root_node = xml_doc.FirstChildElement("message_db");
-        if (root_node == nullptr)
+        // Only index the elements of the file, the XML document is never built as a whole
+        if (m_xml_file.open(xml_file))
         {
-            m_last_error = "Unable to find root XML node";
+            ret = indexFile();
         }
         else
         {
-            // Load messages
-            XMLElement* messages_node = root_node->FirstChildElement("messages");
-            if (messages_node == nullptr)
+            m_last_error = "Unable to open file : " + xml_file;
+        }
+    }
+    else
+    {
+        // Open file
+        XMLDocument xml_doc;
+        XMLError error = xml_doc.LoadFile(xml_file.c_str());
+        if (error == XML_SUCCESS)
+        {
+            // Look for root node
+            XMLElement* root_node = xml_doc.FirstChildElement("message_db");
+            if (root_node == nullptr)
             {
-                m_last_error = "Unable to find messages XML node";
+                m_last_error = "Unable to find root XML node";
             }
             else
             {
-                ret = loadMessages(messages_node);
-                if (ret)
+                // Load messages
+                XMLElement* messages_node = root_node->FirstChildElement("messages");
+                if (messages_node == nullptr)
                 {
-                    // Load converters
-                    XMLElement* converters_node = root_node->FirstChildElement("converters");
-                    if (converters_node != nullptr)
-                    {
-                        ret = loadConverters(converters_node);
-                    }
+                    m_last_error = "Unable to find messages XML node";
+                }
+                else
+                {
+                    ret = loadMessages(messages_node, m_can_msgs);
                     if (ret)
                     {
-                        // Load signals
-                        XMLElement* signals_node = root_node->FirstChildElement("signals");
-                        if (signals_node == nullptr)
+                        // Load converters
+                        XMLElement* converters_node = root_node->FirstChildElement("converters");
+                        if (converters_node != nullptr)
                         {
-                            m_last_error = "Unable to find signals XML node";
+                            ret = loadConverters(converters_node);
                         }
-                        else
+                        if (ret)
                         {
-                            ret = loadSignals(signals_node);
+                            // Load signals
+                            XMLElement* signals_node = root_node->FirstChildElement("signals");
+                            if (signals_node == nullptr)
+                            {
+                                m_last_error = "Unable to find signals XML node";
+                            }
+                            else
+                            {
+                                ret = loadSignals(signals_node);
+
+                                // The values are only looked up by id while the signals are loaded
+                                m_can_msg_values.clear();
+                            }
                         }
                     }
                 }
             }
         }
-    }
-    else
-    {
-        m_last_error = xml_doc.ErrorStr();
+        else
+        {
+            m_last_error = xml_doc.ErrorStr();
+        }
+
+        // Index the names of the CAN messages and signals
+        if (ret)
+        {
+            ret = m_name_index.build(*this);
+            if (!ret)
+            {
+                m_last_error = "Unable to build the index of the names";
+            }
+        }
     }
 
     return ret;
@@ -115,8 +460,14 @@ bool XmlFileCanMsgDatabase::load(const std::string& xml_file)
 void XmlFileCanMsgDatabase::setErrorMessage(void* xml_node, const char* error_msg)
 {
     XMLElement* error_node = reinterpret_cast<XMLElement*>(xml_node);
+    setErrorMessage(error_node->Value(), error_node->GetLineNum() + m_line_offset, error_msg);
+}
+
+/** \brief Set the error message based on an xml element name and line */
+void XmlFileCanMsgDatabase::setErrorMessage(const std::string& element, const int line, const char* error_msg)
+{
     stringstream ss_error_msg;
-    ss_error_msg << "Element : " << error_node->Value() << " - Line : " << error_node->GetLineNum() << " => " << error_msg;
+    ss_error_msg << "Element : " << element << " - Line : " << line << " => " << error_msg;
     m_last_error = ss_error_msg.str();
 }
 
@@ -159,7 +510,7 @@ bool XmlFileCanMsgDatabase::toInt(const void* attribute, int64_t& value)
 }
 
 /** \brief Load the list of CAN messages */
-bool XmlFileCanMsgDatabase::loadMessages(void* root_node)
+bool XmlFileCanMsgDatabase::loadMessages(void* root_node, std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& can_msgs)
 {
     bool ret = true;
     XMLElement* messages_node = reinterpret_cast<XMLElement*>(root_node);
@@ -207,7 +558,7 @@ bool XmlFileCanMsgDatabase::loadMessages(void* root_node)
         // Create CAN message description
         if (ret)
         {
-            CanMsgDesc* can_msg = new CanMsgDesc(static_cast<uint32_t>(id), name, extended);
+            auto can_msg = m_storage.create<CanMsgDesc>(static_cast<uint32_t>(id), name, extended);
 
             // Load values
             XMLElement* values_node = message_node->FirstChildElement("values");
@@ -217,8 +568,7 @@ bool XmlFileCanMsgDatabase::loadMessages(void* root_node)
             }
 
             // Add message to the list
-            auto sp = shared_ptr<CanMsgDesc>(can_msg);
-            m_can_msgs[sp->getId()] = sp;
+            can_msgs[can_msg->getId()] = can_msg;
         }
 
         // Next message
@@ -310,67 +660,134 @@ bool XmlFileCanMsgDatabase::loadValues(void* root_node, CanMsgDesc& can_msg)
             }
         }
 
-        // Create value
-        ICanMsgValue* value = nullptr;
-        if (type == "bool")
-        {
-            value = new BooleanCanMsgValue();
-        }
-        else if (type == "uint")
-        {
-            IntegerCanMsgValue* int_value = new IntegerCanMsgValue();
-            int_value->setSignedness(false);
-            int_value->setSizeInBits(static_cast<uint8_t>(size_in_bits));
-            value = int_value;
-        }
-        else if (type == "int")
+        // Extract byte order
+        CanMsgByteOrder byte_order = CANMSG_LITTLE_ENDIAN;
+        const XMLAttribute* byte_order_attribute = value_node->FindAttribute("byte_order");
+        if (byte_order_attribute != nullptr)
         {
-            IntegerCanMsgValue* int_value = new IntegerCanMsgValue();
-            int_value->setSignedness(true);
-            int_value->setSizeInBits(static_cast<uint8_t>(size_in_bits));
-            value = int_value;
+            const string byte_order_str = byte_order_attribute->Value();
+            if (byte_order_str == "big_endian")
+            {
+                byte_order = CANMSG_BIG_ENDIAN;
+            }
+            else if (byte_order_str != "little_endian")
+            {
+                ret = false;
+                setErrorMessage(value_node, "Byte order of a CAN message value must be little_endian or big_endian");
+            }
         }
-        else if (type == "float")
+
+        // Extract multiplexing attributes
+        bool multiplexer = false;
+        const XMLAttribute* multiplexer_attribute = value_node->FindAttribute("multiplexer");
+        if (multiplexer_attribute != nullptr)
         {
-            FloatCanMsgValue* float_value = new FloatCanMsgValue();
-            float_value->setPrecision(true);
-            value = float_value;
+            if (multiplexer_attribute->QueryBoolValue(&multiplexer) != XML_SUCCESS)
+            {
+                ret = false;
+                setErrorMessage(value_node, "Multiplexer attribute of a CAN message value must be a boolean value");
+            }
         }
-        else if (type == "double")
+        uint64_t multiplexer_value = 0;
+        const XMLAttribute* multiplexer_value_attribute = value_node->FindAttribute("multiplexer_value");
+        if (multiplexer_value_attribute != nullptr)
         {
-            FloatCanMsgValue* float_value = new FloatCanMsgValue();
-            float_value->setPrecision(false);
-            value = float_value;
+            if (multiplexer)
+            {
+                ret = false;
+                setErrorMessage(value_node, "A multiplexer CAN message value can't be multiplexed");
+            }
+            else if (!toUint(multiplexer_value_attribute, multiplexer_value))
+            {
+                ret = false;
+                setErrorMessage(value_node, "Invalid value for the CAN message value's multiplexer value");
+            }
         }
-        else
+
+        // Create value
+        CanMsgValueType value_type = CANMSGVALUE_UNKNOWN;
+        getCanMsgValueType(type, value_type);
+        shared_ptr<ICanMsgValue> value;
+        switch (value_type)
         {
-            ret = false;
-            setErrorMessage(value_node, "Invalid value for the CAN message value's type");
+            case CANMSGVALUE_BOOL:
+            {
+                value = m_storage.create<BooleanCanMsgValue>();
+                break;
+            }
+
+            case CANMSGVALUE_UINT:
+            case CANMSGVALUE_INT:
+            {
+                auto int_value = m_storage.create<IntegerCanMsgValue>();
+                int_value->setSignedness(value_type == CANMSGVALUE_INT);
+                int_value->setSizeInBits(static_cast<uint8_t>(size_in_bits));
+                value = int_value;
+                break;
+            }
+
+            case CANMSGVALUE_FLOAT:
+            case CANMSGVALUE_DOUBLE:
+            {
+                auto float_value = m_storage.create<FloatCanMsgValue>();
+                float_value->setPrecision(value_type == CANMSGVALUE_FLOAT);
+                value = float_value;
+                break;
+            }
+
+            default:
+            {
+                ret = false;
+                setErrorMessage(value_node, "Invalid value for the CAN message value's type");
+                break;
+            }
         }
         if (ret)
         {
-            // Set generic attributes
-            ret = value->setBytePosition(static_cast<uint8_t>(byte_position));
-            if (!ret)
-            {
-                setErrorMessage(value_node, "Invalid value for the CAN message value's byte position");
-            }
+            // Set generic attributes, the positions are checked against the byte order
+            value->setByteOrder(byte_order);
             ret = value->setBitPosition(static_cast<uint8_t>(bit_position));
             if (!ret)
             {
                 setErrorMessage(value_node, "Invalid value for the CAN message value's bit position");
             }
+            else
+            {
+                ret = value->setBytePosition(static_cast<uint8_t>(byte_position));
+                if (!ret)
+                {
+                    setErrorMessage(value_node, "Invalid value for the CAN message value's byte position");
+                }
+            }
 
             // Add value to CAN message
-            auto sp = shared_ptr<ICanMsgValue>(value);
-            ret = can_msg.addValue(sp);
-            if (!ret)
+            if (multiplexer)
             {
-                setErrorMessage(value_node, "The value for the CAN message overlaps another value");
+                ret = can_msg.addMultiplexerValue(value);
+                if (!ret)
+                {
+                    setErrorMessage(value_node, "The multiplexer value for the CAN message must be a single uint value which doesn't overlap another value");
+                }
+            }
+            else if (multiplexer_value_attribute != nullptr)
+            {
+                ret = can_msg.addMultiplexedValue(value, multiplexer_value);
+                if (!ret)
+                {
+                    setErrorMessage(value_node, "The multiplexed value for the CAN message overlaps another value or is defined before the multiplexer value");
+                }
             }
             else
             {
-                m_can_msg_values[id] = sp;
+                ret = can_msg.addValue(value);
+                if (!ret)
+                {
+                    setErrorMessage(value_node, "The value for the CAN message overlaps another value");
+                }
+            }
+            if (ret)
+            {
+                m_can_msg_values[id] = value;
             }
         }
 
@@ -436,6 +853,10 @@ bool XmlFileCanMsgDatabase::loadConverters(void* root_node)
                 {
                     converter = enum_converter;
                 }
+                else
+                {
+                    delete enum_converter;
+                }
             }
             else if (type == "function_converter")
             {
@@ -443,7 +864,37 @@ bool XmlFileCanMsgDatabase::loadConverters(void* root_node)
                 ret = loadFunctionConverter(*function_converter, converter_node);
                 if (ret)
                 {
-                    converter = function_converter;
+                    // Lower the linear transfer functions to a linear converter
+                    double factor = 0.;
+                    double offset = 0.;
+                    if (function_converter->getLinearCoefficients(factor, offset))
+                    {
+                        LinearCanMsgValueConverter* linear_converter = new LinearCanMsgValueConverter(id, "linear_converter");
+                        linear_converter->setCoefficients(factor, offset);
+                        converter = linear_converter;
+                        delete function_converter;
+                    }
+                    else
+                    {
+                        converter = function_converter;
+                    }
+                }
+                else
+                {
+                    delete function_converter;
+                }
+            }
+            else if (type == "linear_converter")
+            {
+                LinearCanMsgValueConverter* linear_converter = new LinearCanMsgValueConverter(id, type);
+                ret = loadLinearConverter(*linear_converter, converter_node);
+                if (ret)
+                {
+                    converter = linear_converter;
+                }
+                else
+                {
+                    delete linear_converter;
                 }
             }
             else
@@ -572,6 +1023,87 @@ bool XmlFileCanMsgDatabase::loadFunctionConverter(FunctionCanMsgValueConverter&
     return ret;
 }
 
+/** \brief Load a linear CAN values converter */
+bool XmlFileCanMsgDatabase::loadLinearConverter(LinearCanMsgValueConverter& converter, void* root_node)
+{
+    bool ret = true;
+    XMLElement* converter_node = reinterpret_cast<XMLElement*>(root_node);
+
+    XMLElement* linear_node = converter_node->FirstChildElement("linear");
+    if (linear_node == nullptr)
+    {
+        ret = false;
+        setErrorMessage(converter_node, "Missing linear node for the linear CAN values converter");
+    }
+    else
+    {
+        // Extract factor
+        double factor = 1.;
+        const XMLAttribute* factor_attribute = linear_node->FindAttribute("factor");
+        if (factor_attribute == nullptr)
+        {
+            ret = false;
+            setErrorMessage(linear_node, "No factor attribute defined for the linear CAN values converter");
+        }
+        else
+        {
+            if (factor_attribute->QueryDoubleValue(&factor) != XML_SUCCESS)
+            {
+                ret = false;
+                setErrorMessage(linear_node, "Factor attribute of a linear CAN values converter must be a floating point value");
+            }
+        }
+
+        // Extract offset
+        double offset = 0.;
+        const XMLAttribute* offset_attribute = linear_node->FindAttribute("offset");
+        if (offset_attribute != nullptr)
+        {
+            if (offset_attribute->QueryDoubleValue(&offset) != XML_SUCCESS)
+            {
+                ret = false;
+                setErrorMessage(linear_node, "Offset attribute of a linear CAN values converter must be a floating point value");
+            }
+        }
+
+        // Extract bounds
+        double min = converter.getMin();
+        const XMLAttribute* min_attribute = linear_node->FindAttribute("min");
+        if (min_attribute != nullptr)
+        {
+            if (min_attribute->QueryDoubleValue(&min) != XML_SUCCESS)
+            {
+                ret = false;
+                setErrorMessage(linear_node, "Min attribute of a linear CAN values converter must be a floating point value");
+            }
+        }
+        double max = converter.getMax();
+        const XMLAttribute* max_attribute = linear_node->FindAttribute("max");
+        if (max_attribute != nullptr)
+        {
+            if (max_attribute->QueryDoubleValue(&max) != XML_SUCCESS)
+            {
+                ret = false;
+                setErrorMessage(linear_node, "Max attribute of a linear CAN values converter must be a floating point value");
+            }
+        }
+        if (ret && (min > max))
+        {
+            ret = false;
+            setErrorMessage(linear_node, "Min attribute of a linear CAN values converter must be lower than its max attribute");
+        }
+
+        // Configure converter
+        if (ret)
+        {
+            converter.setCoefficients(factor, offset);
+            converter.setBounds(min, max);
+        }
+    }
+
+    return ret;
+}
+
 /** \brief Load the list of CAN signals */
 bool XmlFileCanMsgDatabase::loadSignals(void* root_node)
 {
@@ -637,9 +1169,9 @@ bool XmlFileCanMsgDatabase::loadSignals(void* root_node)
         // Create CAN signal
         if (ret)
         {
-            CanMsgSignal* signal = new CanMsgSignal();
-            signal->setName(id);
-            signal->setUnit(unit);
+            auto signal = m_storage.create<CanMsgSignal>();
+            signal->setName(m_storage.intern(id));
+            signal->setUnit(m_storage.intern(unit));
 
             ICanMsgValue& can_value = *(m_can_msg_values[value]);
             ret = signal->setValue(can_value);
@@ -647,15 +1179,16 @@ bool XmlFileCanMsgDatabase::loadSignals(void* root_node)
             {
                 if (!converter.empty())
                 {
-                    auto msg_converter = shared_ptr<ICanMsgValueConverter>(m_can_msg_value_converters[converter]->clone());
-                    ret = signal->setConverter(*msg_converter);
+                    // The signals using the same converter with the same value type share its copy
+                    ICanMsgValueConverter* msg_converter = m_storage.shareConverter(*m_can_msg_value_converters[converter], can_value);
+                    ret = (msg_converter != nullptr);
                     if (!ret)
                     {
                         setErrorMessage(signal_node, "Incompatible CAN value type and CAN values converter type for the CAN signal");
                     }
                     else
                     {
-                        m_cloned_can_msg_value_converters.push_back(msg_converter);
+                        signal->setSharedConverter(*msg_converter);
                     }
                 }
             }
@@ -665,22 +1198,396 @@ bool XmlFileCanMsgDatabase::loadSignals(void* root_node)
             }
             if (ret)
             {
-                // Add signal to the list
-                auto sp = shared_ptr<CanMsgSignal>(signal);
-                m_can_msg_signals[id] = sp;
-
+                // Add signal to the CAN message
                 CanMsgDesc* can_msg = can_value.getCanMsg();
-                can_msg->addSignal(sp);
+                can_msg->addSignal(signal);
+            }
+        }
+
+        // Next signal
+        signal_node = signal_node->NextSiblingElement();
+    }
+
+    return ret;
+}
+/** \brief Load a CAN message in lazy mode */
+const CanMsgDesc* XmlFileCanMsgDatabase::loadCanMsg(const uint32_t id, const bool extended) const
+{
+    const CanMsgDesc* can_msg = nullptr;
+
+    // The index is not modified once the file is loaded, only the building of the CAN messages must be serialized.
+    // The building only modifies the lazy state of the database, never the list of CAN messages or the index of the names
+    XmlFileCanMsgDatabase* database = const_cast<XmlFileCanMsgDatabase*>(this);
+    auto iter = database->m_lazy_can_msgs.find(id);
+    if ((iter != database->m_lazy_can_msgs.end()) && (iter->second.extended == extended))
+    {
+        lock_guard<mutex> lock(m_lazy_mutex);
+        can_msg = database->getLazyCanMsg(iter->second);
+    }
+
+    return can_msg;
+}
+
+/** \brief Load the CAN message containing a signal in lazy mode */
+const CanMsgDesc* XmlFileCanMsgDatabase::loadSignalCanMsg(const std::string& signal_name) const
+{
+    const CanMsgDesc* can_msg = nullptr;
+
+    XmlFileCanMsgDatabase* database = const_cast<XmlFileCanMsgDatabase*>(this);
+    auto signal_iter = m_lazy_signals.find(signal_name);
+    if (signal_iter != m_lazy_signals.cend())
+    {
+        auto iter = database->m_lazy_can_msgs.find(signal_iter->second);
+        if (iter != database->m_lazy_can_msgs.end())
+        {
+            lock_guard<mutex> lock(m_lazy_mutex);
+            can_msg = database->getLazyCanMsg(iter->second);
+        }
+    }
+
+    return can_msg;
+}
+
+/** \brief List all the CAN messages of the database, they are all built in lazy mode */
+void XmlFileCanMsgDatabase::loadAllCanMsgs(std::vector<const CanMsgDesc*>& can_msgs) const
+{
+    if (m_lazy)
+    {
+        // Build the messages in the order of their id
+        vector<uint32_t> ids;
+        ids.reserve(m_lazy_can_msgs.size());
+        for (auto iter = m_lazy_can_msgs.cbegin(); iter != m_lazy_can_msgs.cend(); ++iter)
+        {
+            ids.push_back(iter->first);
+        }
+        sort(ids.begin(), ids.end());
+
+        can_msgs.clear();
+        XmlFileCanMsgDatabase* database = const_cast<XmlFileCanMsgDatabase*>(this);
+        lock_guard<mutex> lock(m_lazy_mutex);
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            const CanMsgDesc* can_msg = database->getLazyCanMsg(database->m_lazy_can_msgs.find(ids[i])->second);
+            if (can_msg != nullptr)
+            {
+                can_msgs.push_back(can_msg);
+            }
+        }
+    }
+    else
+    {
+        ICanMsgDatabase::loadAllCanMsgs(can_msgs);
+    }
+}
+
+/** \brief Index the position of the CAN messages, signals and converters in the mapped file (lazy mode) */
+bool XmlFileCanMsgDatabase::indexFile()
+{
+    bool ret = true;
+
+    // Signal element waiting for the indexing of all the CAN message values
+    struct SignalElement
+    {
+        LazyElement element;
+        string id;
+        string value;
+    };
+    vector<SignalElement> signal_elements;
+    unordered_map<string, uint32_t> value_msgs;
+
+    // Element of the database being indexed (children of the messages, converters and signals nodes)
+    enum ElementType
+    {
+        ELEMENT_OTHER,
+        ELEMENT_MESSAGE,
+        ELEMENT_CONVERTER,
+        ELEMENT_SIGNAL
+    };
+    LazyElement element = { 0u, 0u, 0 };
+    ElementType element_type = ELEMENT_OTHER;
+    string element_id;
+    string signal_value;
+    uint32_t msg_id = 0;
+    bool msg_extended = false;
+
+    bool root_found = false;
+    bool messages_found = false;
+    bool signals_found = false;
+    vector<string_view> path;
+    XmlTag tag;
+    XmlTagScanner scanner(m_xml_file.getData(), m_xml_file.getSize());
+    while (ret && scanner.next(tag))
+    {
+        bool element_end = false;
+        if (tag.end_tag)
+        {
+            if (path.empty() || (path.back() != tag.name))
+            {
+                ret = false;
+                setErrorMessage(string(tag.name), tag.line, "End tag doesn't match the start tag");
+            }
+            else
+            {
+                path.pop_back();
+                element_end = (path.size() == 2u);
+            }
+        }
+        else
+        {
+            const bool in_root = (!path.empty() && (path[0] == "message_db"));
+            if (path.empty())
+            {
+                root_found = (root_found || (tag.name == "message_db"));
+            }
+            else if (in_root && (path.size() == 1u))
+            {
+                messages_found = (messages_found || (tag.name == "messages"));
+                signals_found = (signals_found || (tag.name == "signals"));
+            }
+            else if (in_root && (path.size() == 2u))
+            {
+                // Start of an element of the database
+                string_view value;
+                element = { tag.offset, 0u, tag.line };
+                element_type = ELEMENT_OTHER;
+                if ((path[1] == "messages") && (tag.name == "message"))
+                {
+                    element_type = ELEMENT_MESSAGE;
+                }
+                else if ((path[1] == "converters") && (tag.name == "converter"))
+                {
+                    element_type = ELEMENT_CONVERTER;
+                }
+                else if ((path[1] == "signals") && (tag.name == "signal"))
+                {
+                    element_type = ELEMENT_SIGNAL;
+                }
+                element_id = (tag.getAttribute("id", value) ? decodeXmlText(value) : "");
+                if (element_type == ELEMENT_MESSAGE)
+                {
+                    uint64_t id = 0;
+                    msg_extended = false;
+                    if (!tag.getAttribute("id", value))
+                    {
+                        ret = false;
+                        setErrorMessage("message", tag.line, "No id attribute defined for the CAN message");
+                    }
+                    else if (!parseUint(value, id))
+                    {
+                        ret = false;
+                        setErrorMessage("message", tag.line, "Invalid value for the CAN message's id");
+                    }
+                    else if (tag.getAttribute("extended", value) && !parseBool(value, msg_extended))
+                    {
+                        ret = false;
+                        setErrorMessage("message", tag.line, "Extended attribute of a CAN message must be a boolean value");
+                    }
+                    msg_id = static_cast<uint32_t>(id);
+                }
+                else if ((element_type == ELEMENT_CONVERTER) && !tag.getAttribute("id", value))
+                {
+                    ret = false;
+                    setErrorMessage("converter", tag.line, "No id attribute defined for the CAN values converter");
+                }
+                else if (element_type == ELEMENT_SIGNAL)
+                {
+                    if (!tag.getAttribute("id", value))
+                    {
+                        ret = false;
+                        setErrorMessage("signal", tag.line, "No id attribute defined for the CAN signal");
+                    }
+                    else if (!tag.getAttribute("value", value))
+                    {
+                        ret = false;
+                        setErrorMessage("signal", tag.line, "No value attribute defined for the CAN signal");
+                    }
+                    else
+                    {
+                        signal_value = decodeXmlText(value);
+                    }
+                }
+            }
+            else if (in_root && (path.size() == 4u) && (path[1] == "messages") && (path[3] == "values") && (tag.name == "value"))
+            {
+                // The signals are attached to the CAN message of their value
+                string_view value;
+                if (tag.getAttribute("id", value))
+                {
+                    value_msgs[decodeXmlText(value)] = msg_id;
+                }
+            }
+
+            if (tag.empty_element)
+            {
+                element_end = (path.size() == 2u);
             }
             else
             {
-                delete signal;
+                path.push_back(tag.name);
             }
         }
 
-        // Next signal
-        signal_node = signal_node->NextSiblingElement();
+        // End of an element of the database
+        if (ret && element_end)
+        {
+            element.size = scanner.getOffset() - element.offset;
+            if (element_type == ELEMENT_MESSAGE)
+            {
+                LazyCanMsg& lazy_can_msg = m_lazy_can_msgs[msg_id];
+                lazy_can_msg.element = element;
+                lazy_can_msg.extended = msg_extended;
+                lazy_can_msg.built = false;
+            }
+            else if (element_type == ELEMENT_CONVERTER)
+            {
+                m_lazy_converters[element_id] = element;
+            }
+            else if (element_type == ELEMENT_SIGNAL)
+            {
+                signal_elements.push_back({ element, element_id, signal_value });
+            }
+        }
+    }
+    if (ret)
+    {
+        if (scanner.getError() != nullptr)
+        {
+            ret = false;
+            setErrorMessage("message_db", scanner.getLine(), scanner.getError());
+        }
+        else if (!path.empty())
+        {
+            ret = false;
+            setErrorMessage(string(path.back()), scanner.getLine(), "Unexpected end of file");
+        }
+        else if (!root_found)
+        {
+            ret = false;
+            m_last_error = "Unable to find root XML node";
+        }
+        else if (!messages_found)
+        {
+            ret = false;
+            m_last_error = "Unable to find messages XML node";
+        }
+        else if (!signals_found)
+        {
+            ret = false;
+            m_last_error = "Unable to find signals XML node";
+        }
+    }
+
+    // Attach the signals to their CAN message
+    for (size_t i = 0; ret && (i < signal_elements.size()); i++)
+    {
+        const SignalElement& signal_element = signal_elements[i];
+        auto iter = value_msgs.find(signal_element.value);
+        if (iter == value_msgs.end())
+        {
+            ret = false;
+            setErrorMessage("signal", signal_element.element.line, "Unknown CAN value for the CAN signal");
+        }
+        else
+        {
+            m_lazy_can_msgs[iter->second].signals.push_back(signal_element.element);
+            m_lazy_signals[signal_element.id] = iter->second;
+        }
     }
 
     return ret;
-}
\ No newline at end of file
+}
+
+/** \brief Get a CAN message and build it if it has not been built yet, return nullptr if it can't be built (lazy mode) */
+const CanMsgDesc* XmlFileCanMsgDatabase::getLazyCanMsg(LazyCanMsg& lazy_can_msg)
+{
+    if (!lazy_can_msg.built)
+    {
+        // The building is tried only once, a message which can't be built is left out of the database
+        lazy_can_msg.built = true;
+        if (!buildCanMsg(lazy_can_msg))
+        {
+            lazy_can_msg.can_msg.reset();
+        }
+    }
+
+    return lazy_can_msg.can_msg.get();
+}
+
+/** \brief Build a CAN message from its XML elements (lazy mode) */
+bool XmlFileCanMsgDatabase::buildCanMsg(LazyCanMsg& lazy_can_msg)
+{
+    // Message and values
+    XMLDocument messages_doc;
+    bool ret = loadElement(lazy_can_msg.element, "messages", &messages_doc);
+    if (ret)
+    {
+        map<uint32_t, shared_ptr<CanMsgDesc>> can_msgs;
+        ret = (loadMessages(messages_doc.FirstChildElement(), can_msgs) && (can_msgs.size() == 1u));
+        if (ret)
+        {
+            lazy_can_msg.can_msg = can_msgs.begin()->second;
+        }
+    }
+
+    // Signals with their converters
+    for (size_t i = 0; ret && (i < lazy_can_msg.signals.size()); i++)
+    {
+        XMLDocument signals_doc;
+        ret = loadElement(lazy_can_msg.signals[i], "signals", &signals_doc);
+        if (ret)
+        {
+            XMLElement* signals_node = signals_doc.FirstChildElement();
+            const XMLElement* signal_node = signals_node->FirstChildElement("signal");
+            const XMLAttribute* converter_attribute = ((signal_node != nullptr) ? signal_node->FindAttribute("converter") : nullptr);
+            if (converter_attribute != nullptr)
+            {
+                // The converters are shared between the CAN messages and are loaded only once
+                const string converter = converter_attribute->Value();
+                auto iter = m_lazy_converters.find(converter);
+                if ((iter != m_lazy_converters.end()) && (m_can_msg_value_converters.find(converter) == m_can_msg_value_converters.end()))
+                {
+                    XMLDocument converters_doc;
+                    ret = loadElement(iter->second, "converters", &converters_doc);
+                    if (ret)
+                    {
+                        ret = loadConverters(converters_doc.FirstChildElement());
+                    }
+                }
+            }
+            if (ret)
+            {
+                m_line_offset = lazy_can_msg.signals[i].line - 1;
+                ret = loadSignals(signals_node);
+            }
+        }
+    }
+    m_line_offset = 0;
+
+    return ret;
+}
+
+/** \brief Load an XML element of the mapped file inside a parent element (lazy mode) */
+bool XmlFileCanMsgDatabase::loadElement(const LazyElement& element, const char* parent, void* xml_doc)
+{
+    // The parent element is added on the same line so that the line numbers only have to be shifted
+    string xml = "<";
+    xml += parent;
+    xml += ">";
+    xml.append(m_xml_file.getData() + element.offset, element.size);
+    xml += "</";
+    xml += parent;
+    xml += ">";
+
+    XMLDocument* doc = reinterpret_cast<XMLDocument*>(xml_doc);
+    const bool ret = (doc->Parse(xml.c_str(), xml.size()) == XML_SUCCESS);
+    if (ret)
+    {
+        m_line_offset = element.line - 1;
+    }
+    else
+    {
+        setErrorMessage(parent, element.line, doc->ErrorStr());
+    }
+
+    return ret;
+}
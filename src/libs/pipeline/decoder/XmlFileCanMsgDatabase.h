@@ -23,14 +23,24 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #include "ICanMsgDatabase.h"
 #include "CanMsgSignal.h"
 #include "ICanMsgValueConverter.h"
+#include "CanMsgDatabaseStorage.h"
+#include "MappedFile.h"
 
 #include <string>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 class EnumCanMsgValueConverter;
 class FunctionCanMsgValueConverter;
-
-/** \brief CAN message database stored in an XML file */
+class LinearCanMsgValueConverter;
+
+/** \brief CAN message database stored in an XML file. In lazy mode, the file stays mapped in memory and only the position
+           of the CAN messages, signals and converters is indexed at load time : a CAN message with its values, signals
+           and converters is built the first time it is requested with loadCanMsg(), loadSignalCanMsg() or loadAllCanMsgs().
+           The built CAN messages are kept apart so that getCanMsgs() and the index of the names stay empty and the database
+           stays immutable for its users : it can be shared between threads which build CAN messages concurrently.
+           The errors in a CAN message are only detected when it is built */
 class XmlFileCanMsgDatabase : public ICanMsgDatabase
 {
     public:
@@ -42,41 +52,107 @@ class XmlFileCanMsgDatabase : public ICanMsgDatabase
         virtual ~XmlFileCanMsgDatabase();
 
 
-        /** \brief Load the message database from the file */
-        bool load(const std::string& xml_file);
+        /** \brief Load the message database from the file, in lazy mode the CAN messages are built on demand */
+        bool load(const std::string& xml_file, const bool lazy = false);
 
 
-        /** \brief Get the list of CAN messages */
+        /** \brief Get the list of CAN messages (empty in lazy mode) */
         virtual const std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& getCanMsgs() const override { return m_can_msgs; }
 
+        /** \brief Get the index of the names of the CAN messages and signals (empty in lazy mode) */
+        virtual const CanMsgNameIndex& getNameIndex() const override { return m_name_index; }
+
+        /** \brief Indicate if the database builds its CAN messages on demand */
+        virtual bool isLazy() const override { return m_lazy; }
+
+        /** \brief Load a CAN message in lazy mode, return nullptr if the database doesn't contain the message */
+        virtual const CanMsgDesc* loadCanMsg(const uint32_t id, const bool extended) const override;
+
+        /** \brief Load the CAN message containing a signal in lazy mode, return nullptr if the database doesn't contain the signal */
+        virtual const CanMsgDesc* loadSignalCanMsg(const std::string& signal_name) const override;
+
+        /** \brief List all the CAN messages of the database, they are all built in lazy mode */
+        virtual void loadAllCanMsgs(std::vector<const CanMsgDesc*>& can_msgs) const override;
+
 
         /** \brief Get the last error string */
         const std::string& getLastError() { return m_last_error; }
 
     private:
 
+        /** \brief Position of an XML element in the file (lazy mode) */
+        struct LazyElement
+        {
+            /** \brief Offset of the element in the file */
+            size_t offset;
+            /** \brief Size of the element in bytes */
+            size_t size;
+            /** \brief Line of the element in the file */
+            int line;
+        };
+
+        /** \brief CAN message built on demand (lazy mode) */
+        struct LazyCanMsg
+        {
+            /** \brief Message element */
+            LazyElement element;
+            /** \brief Extended flag */
+            bool extended;
+            /** \brief Indicate if the building of the message has already been tried */
+            bool built;
+            /** \brief Signal elements of the message */
+            std::vector<LazyElement> signals;
+            /** \brief Built message (nullptr if it has not been built yet or if it can't be built) */
+            std::shared_ptr<CanMsgDesc> can_msg;
+        };
+
+
+        /** \brief Storage of the CAN messages, values and signals, declared first so that it outlives their references */
+        CanMsgDatabaseStorage m_storage;
+
         /** \brief Get the last error string */
         std::string m_last_error;
 
-        /** \brief List of CAN messages */
+        /** \brief List of CAN messages (empty in lazy mode) */
         std::map<uint32_t, std::shared_ptr<CanMsgDesc>> m_can_msgs;
 
+        /** \brief Index of the names of the CAN messages and signals */
+        CanMsgNameIndex m_name_index;
+
         /** \brief List of CAN messages values */
         std::map<std::string, std::shared_ptr<ICanMsgValue>> m_can_msg_values;
 
         /** \brief List of CAN messages values converters */
         std::map<std::string, std::shared_ptr<ICanMsgValueConverter>> m_can_msg_value_converters;
 
-        /** \brief List of cloned CAN messages values converters */
-        std::vector<std::shared_ptr<ICanMsgValueConverter>> m_cloned_can_msg_value_converters;
+        /** \brief Indicate if the CAN messages are built on demand */
+        bool m_lazy;
+
+        /** \brief Mapped XML file (lazy mode) */
+        MappedFile m_xml_file;
+
+        /** \brief CAN messages to build on demand indexed by id (lazy mode) */
+        std::unordered_map<uint32_t, LazyCanMsg> m_lazy_can_msgs;
 
-        /** \brief List of CAN messages signals */
-        std::map<std::string, std::shared_ptr<CanMsgSignal>> m_can_msg_signals;
+        /** \brief Id of the CAN message of each signal (lazy mode) */
+        std::unordered_map<std::string, uint32_t> m_lazy_signals;
+
+        /** \brief Converter elements indexed by id (lazy mode) */
+        std::unordered_map<std::string, LazyElement> m_lazy_converters;
+
+        /** \brief Mutex to build the CAN messages on demand and to access the built messages (lazy mode) */
+        mutable std::mutex m_lazy_mutex;
+
+        /** \brief Line in the file of the first line of the XML document being loaded */
+        int m_line_offset;
 
 
         /** \brief Set the error message based on an xml node */
         void setErrorMessage(void* xml_node, const char* error_msg);
 
+        /** \brief Set the error message based on an xml element name and line */
+        void setErrorMessage(const std::string& element, const int line, const char* error_msg);
+
         /** \brief Convert a string value representing either a decimal or an hexadecimal unsigned integer value */
         bool toUint(const void* attribute, uint64_t& value);
 
@@ -84,7 +160,7 @@ class XmlFileCanMsgDatabase : public ICanMsgDatabase
         bool toInt(const void* attribute, int64_t& value);
 
         /** \brief Load the list of CAN messages */
-        bool loadMessages(void* root_node);
+        bool loadMessages(void* root_node, std::map<uint32_t, std::shared_ptr<CanMsgDesc>>& can_msgs);
 
         /** \brief Load the list of CAN message values */
         bool loadValues(void* root_node, CanMsgDesc& can_msg);
@@ -98,9 +174,25 @@ class XmlFileCanMsgDatabase : public ICanMsgDatabase
         /** \brief Load a function CAN values converter */
         bool loadFunctionConverter(FunctionCanMsgValueConverter& converter, void* root_node);
 
+        /** \brief Load a linear CAN values converter */
+        bool loadLinearConverter(LinearCanMsgValueConverter& converter, void* root_node);
+
         /** \brief Load the list of CAN signals */
         bool loadSignals(void* root_node);
 
+        /** \brief Index the position of the CAN messages, signals and converters in the mapped file (lazy mode) */
+        bool indexFile();
+
+        /** \brief Get a CAN message and build it if it has not been built yet, return nullptr if it can't be built (lazy mode),
+                   the lazy mutex must be locked */
+        const CanMsgDesc* getLazyCanMsg(LazyCanMsg& lazy_can_msg);
+
+        /** \brief Build a CAN message from its XML elements (lazy mode) */
+        bool buildCanMsg(LazyCanMsg& lazy_can_msg);
+
+        /** \brief Load an XML element of the mapped file inside a parent element (lazy mode) */
+        bool loadElement(const LazyElement& element, const char* parent, void* xml_doc);
+
 };
 
 
@@ -24,8 +24,7 @@ using namespace std;
 /** \brief Constructor */
 BlackListCanMsgFilter::BlackListCanMsgFilter()
 : CanPipelineStageBase(true)
-, m_black_list_std()
-, m_black_list_ext()
+, m_rules(new Rules())
 {}
 
 /** \brief Destructor */
@@ -35,63 +34,58 @@ BlackListCanMsgFilter::~BlackListCanMsgFilter()
 /** \brief Add a CAN message id to the black list */
 void BlackListCanMsgFilter::add(const uint32_t id, const bool extended)
 {
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        m_black_list_ext.insert(id);
-    }
-    else
-    {
-        m_black_list_std.insert(id);
-    }
+        getBlackList(rules, extended).insert(id);
+    });
 }
 
 /** \brief Add a range of CAN message ids to the black list */
 void BlackListCanMsgFilter::add(const CanMsgIdRange& range, const bool extended)
 {
-    black_list_t* black_list;
-    if (extended)
-    {
-        black_list = &m_black_list_ext;
-    }
-    else
-    {
-        black_list = &m_black_list_std;
-    }
-    for (uint32_t id = range.minId(); id <= range.maxId(); id++)
+    m_rules.update([&](Rules& rules)
     {
-        black_list->insert(id);
-    }
+        black_list_t& black_list = getBlackList(rules, extended);
+        for (uint32_t id = range.minId(); id <= range.maxId(); id++)
+        {
+            black_list.insert(id);
+        }
+    });
 }
 
 /** \brief Remove a CAN message id from the black list */
 void BlackListCanMsgFilter::remove(const uint32_t id, const bool extended)
 {
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        m_black_list_ext.erase(id);
-    }
-    else
-    {
-        m_black_list_std.erase(id);
-    }
+        getBlackList(rules, extended).erase(id);
+    });
 }
 
 /** \brief Remove a range of CAN message ids from the black list */
 void BlackListCanMsgFilter::remove(const CanMsgIdRange& range, const bool extended)
 {
-    black_list_t* black_list;
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        black_list = &m_black_list_ext;
-    }
-    else
-    {
-        black_list = &m_black_list_std;
-    }
-    for (uint32_t id = range.minId(); id <= range.maxId(); id++)
-    {
-        black_list->erase(id);
-    }
+        black_list_t& black_list = getBlackList(rules, extended);
+        for (uint32_t id = range.minId(); id <= range.maxId(); id++)
+        {
+            black_list.erase(id);
+        }
+    });
+}
+
+/** \brief Get a copy of the current black list rules */
+BlackListCanMsgFilter::Rules BlackListCanMsgFilter::getRules() const
+{
+    RcuPtr<Rules>::ReadGuard rules(m_rules);
+    return *rules;
+}
+
+/** \brief Replace all the black list rules at once */
+void BlackListCanMsgFilter::setRules(const Rules& rules)
+{
+    m_rules.publish(new Rules(rules));
 }
 
 
@@ -102,14 +96,16 @@ bool BlackListCanMsgFilter::processCanData(const CanData& can_data)
 
     if (CAN_DATA_IS_CANMSG(can_data))
     {
-        black_list_t* black_list;
+        RcuPtr<Rules>::ReadGuard rules(m_rules);
+
+        const black_list_t* black_list;
         if (can_data.msg.extended)
         {
-            black_list = &m_black_list_ext;
+            black_list = &rules->ext_ids;
         }
         else
         {
-            black_list = &m_black_list_std;
+            black_list = &rules->std_ids;
         }
 
         forward_data = (black_list->find(can_data.msg.id) == black_list->end());
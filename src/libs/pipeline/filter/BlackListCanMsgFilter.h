@@ -22,16 +22,29 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CanPipelineStageBase.h"
 #include "CanMsgIdRange.h"
+#include "RcuPtr.h"
 
 #include <vector>
 #include <unordered_set>
 
 
-/** \brief CAN message filter based on a black list */
+/** \brief CAN message filter based on a black list, the list can be modified while the filter is running */
 class BlackListCanMsgFilter : public CanPipelineStageBase
 {
     public:
 
+        /** \brief Black list */
+        typedef std::unordered_set<uint32_t> black_list_t;
+
+        /** \brief Black list rules */
+        struct Rules
+        {
+            /** \brief Black list for standard messages */
+            black_list_t std_ids;
+            /** \brief Black list for extended messages */
+            black_list_t ext_ids;
+        };
+
 
         /** \brief Constructor */
         BlackListCanMsgFilter();
@@ -52,24 +65,28 @@ class BlackListCanMsgFilter : public CanPipelineStageBase
         /** \brief Remove a range of CAN message ids from the black list */
         void remove(const CanMsgIdRange& range, const bool extended);
 
+        /** \brief Get a copy of the current black list rules */
+        Rules getRules() const;
+
+        /** \brief Replace all the black list rules at once */
+        void setRules(const Rules& rules);
+
 
 
     protected:
 
         /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
-        virtual bool processCanData(const CanData& can_data);
+        virtual bool processCanData(const CanData& can_data) override;
 
 
     private:
 
-        /** \brief Black list */
-        typedef std::unordered_set<uint32_t> black_list_t;
+        /** \brief Current rules */
+        RcuPtr<Rules> m_rules;
 
-        /** \brief Black list for standard messages */
-        black_list_t m_black_list_std;
 
-        /** \brief Black list for extended messages */
-        black_list_t m_black_list_ext;
+        /** \brief Select the black list matching the message type */
+        static black_list_t& getBlackList(Rules& rules, const bool extended) { return (extended ? rules.ext_ids : rules.std_ids); }
 };
 
 
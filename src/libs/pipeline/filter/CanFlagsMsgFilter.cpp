@@ -30,6 +30,28 @@ CanFlagsMsgFilter::CanFlagsMsgFilter(const uint8_t acceptance_mask)
 CanFlagsMsgFilter::~CanFlagsMsgFilter()
 {}
 
+/** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list */
+bool CanFlagsMsgFilter::getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const
+{
+    // Messages are filtered only when the standard flag is set (see processCanData()), 
+    // and remote transmission requests cannot be selected with an id and a mask
+    bool ret = (isEnabled() && 
+                ((m_acceptance_flags & CANMSG_FLAG_STD) != 0) &&
+                ((m_acceptance_flags & CANMSG_FLAG_RTR) == 0));
+    if (ret)
+    {
+        const CanAdapterFilter std_filter = { 0u, 0u, false };
+        filters.push_back(std_filter);
+        if ((m_acceptance_flags & CANMSG_FLAG_EXT) != 0)
+        {
+            const CanAdapterFilter filter = { 0u, 0u, true };
+            filters.push_back(filter);
+        }
+    }
+
+    return ret;
+}
+
 /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
 bool CanFlagsMsgFilter::processCanData(const CanData& can_data)
 {
@@ -49,10 +49,15 @@ class CanFlagsMsgFilter : public CanPipelineStageBase
 
 
         /** \brief Add a flag to the acceptance mask */
-        void add(const Flags flag) { m_acceptance_flags |= flag; }
+        void add(const Flags flag) { m_acceptance_flags |= flag; notifyAcceptanceFiltersChanged(); }
 
         /** \brief Remove a flag from the acceptance mask */
-        void remove(const Flags flag) { m_acceptance_flags &= ~flag; }
+        void remove(const Flags flag) { m_acceptance_flags &= ~flag; notifyAcceptanceFiltersChanged(); }
+
+
+        /** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list,
+                   return false if the stage needs all the CAN messages */
+        virtual bool getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const override;
 
 
     protected:
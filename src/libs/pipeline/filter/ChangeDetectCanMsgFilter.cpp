@@ -0,0 +1,144 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ChangeDetectCanMsgFilter.h"
+
+#include <cstring>
+
+using namespace std;
+
+/** \brief Constructor */
+ChangeDetectCanMsgFilter::ChangeDetectCanMsgFilter(const uint32_t heartbeat_ms)
+: CanPipelineStageBase(true)
+, m_rules(new Rules())
+, m_last_payloads()
+, m_reset_requested(false)
+{
+    setHeartbeat(heartbeat_ms);
+}
+
+/** \brief Destructor */
+ChangeDetectCanMsgFilter::~ChangeDetectCanMsgFilter()
+{}
+
+/** \brief Set the heartbeat period in milliseconds */
+void ChangeDetectCanMsgFilter::setHeartbeat(const uint32_t heartbeat_ms)
+{
+    m_rules.update([&](Rules& rules)
+    {
+        rules.heartbeat_ns = static_cast<int64_t>(heartbeat_ms) * 1000000;
+    });
+}
+
+/** \brief Set the mask of the payload bits to compare for a CAN message id */
+void ChangeDetectCanMsgFilter::setMask(const uint32_t id, const bool extended, const uint64_t mask)
+{
+    m_rules.update([&](Rules& rules)
+    {
+        rules.masks[getKey(id, extended)] = mask;
+    });
+}
+
+/** \brief Remove the payload mask of a CAN message id */
+void ChangeDetectCanMsgFilter::removeMask(const uint32_t id, const bool extended)
+{
+    m_rules.update([&](Rules& rules)
+    {
+        rules.masks.erase(getKey(id, extended));
+    });
+}
+
+/** \brief Forget the last payloads received so that the next message of each id is forwarded */
+void ChangeDetectCanMsgFilter::reset()
+{
+    m_reset_requested.store(true, std::memory_order_release);
+}
+
+
+/** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
+bool ChangeDetectCanMsgFilter::processCanData(const CanData& can_data)
+{
+    bool forward_data = true;
+
+    if (CAN_DATA_IS_CANMSG(can_data))
+    {
+        // Load the payload as a single word, ignoring the bytes after the message size
+        const uint8_t size = ((can_data.msg.size <= CAN_MSG_MAX_LEN) ? can_data.msg.size : CAN_MSG_MAX_LEN);
+        uint64_t payload;
+        memcpy(&payload, can_data.msg.data, sizeof(payload));
+        if (size < CAN_MSG_MAX_LEN)
+        {
+            payload &= ((1ull << (size * 8u)) - 1u);
+        }
+        const int64_t timestamp = can_data.header.timestamp_sec * 1000000000 + can_data.header.timestamp_nsec;
+
+        // Forget the last payloads on request
+        if (m_reset_requested.load(std::memory_order_relaxed) && m_reset_requested.exchange(false, std::memory_order_acquire))
+        {
+            for (auto iter = m_last_payloads.begin(); iter != m_last_payloads.end(); ++iter)
+            {
+                iter->second.valid = false;
+            }
+        }
+
+        // Mask of the message
+        RcuPtr<Rules>::ReadGuard rules(m_rules);
+        const uint32_t key = getKey(can_data.msg.id, can_data.msg.extended);
+        uint64_t mask = 0xFFFFFFFFFFFFFFFFull;
+        if (!rules->masks.empty())
+        {
+            auto mask_iter = rules->masks.find(key);
+            if (mask_iter != rules->masks.end())
+            {
+                mask = mask_iter->second;
+            }
+        }
+
+        // Look for the last forwarded payload
+        auto iter = m_last_payloads.find(key);
+        if (iter == m_last_payloads.end())
+        {
+            LastPayload& last_payload = m_last_payloads[key];
+            last_payload.payload = payload;
+            last_payload.mask = mask;
+            last_payload.timestamp = timestamp;
+            last_payload.size = size;
+            last_payload.valid = true;
+        }
+        else
+        {
+            LastPayload& last_payload = iter->second;
+            forward_data = (!last_payload.valid ||
+                            (mask != last_payload.mask) ||
+                            (size != last_payload.size) ||
+                            (((payload ^ last_payload.payload) & mask) != 0) ||
+                            ((rules->heartbeat_ns != 0) && ((timestamp - last_payload.timestamp) >= rules->heartbeat_ns)));
+            if (forward_data)
+            {
+                last_payload.payload = payload;
+                last_payload.mask = mask;
+                last_payload.timestamp = timestamp;
+                last_payload.size = size;
+                last_payload.valid = true;
+            }
+        }
+    }
+
+    return forward_data;
+}
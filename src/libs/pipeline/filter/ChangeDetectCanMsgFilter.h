@@ -0,0 +1,118 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHANGEDETECTCANMSGFILTER_H
+#define CHANGEDETECTCANMSGFILTER_H
+
+#include "CanPipelineStageBase.h"
+#include "RcuPtr.h"
+
+#include <unordered_map>
+#include <atomic>
+
+
+/** \brief CAN message filter which forwards a message only when its payload has changed
+           since the last forwarded message with the same id. The heartbeat and the masks can be modified
+           and the filter can be reset while the filter is running */
+class ChangeDetectCanMsgFilter : public CanPipelineStageBase
+{
+    public:
+
+
+        /** \brief Constructor (heartbeat period in milliseconds, 0 = no heartbeat) */
+        ChangeDetectCanMsgFilter(const uint32_t heartbeat_ms = 0u);
+
+        /** \brief Destructor */
+        virtual ~ChangeDetectCanMsgFilter();
+
+
+        /** \brief Set the heartbeat period in milliseconds : an unchanged message is forwarded
+                   at least once per period (0 = no heartbeat) */
+        void setHeartbeat(const uint32_t heartbeat_ms);
+
+        /** \brief Set the mask of the payload bits to compare for a CAN message id
+                   (byte 0 of the payload is the least significant byte of the mask),
+                   the next message with this id is forwarded */
+        void setMask(const uint32_t id, const bool extended, const uint64_t mask);
+
+        /** \brief Remove the payload mask of a CAN message id, the next message with this id is forwarded
+                   if the removed mask was not comparing the whole payload */
+        void removeMask(const uint32_t id, const bool extended);
+
+        /** \brief Forget the last payloads received so that the next message of each id is forwarded,
+                   the last payloads are forgotten by the thread which processes the CAN messages */
+        void reset();
+
+
+
+    protected:
+
+        /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
+        virtual bool processCanData(const CanData& can_data) override;
+
+
+    private:
+
+        /** \brief Payload masks by CAN message id */
+        typedef std::unordered_map<uint32_t, uint64_t> mask_map_t;
+
+        /** \brief Change detection rules */
+        struct Rules
+        {
+            /** \brief Heartbeat period in nanoseconds */
+            int64_t heartbeat_ns;
+            /** \brief Masks of the CAN message ids which don't compare the whole payload */
+            mask_map_t masks;
+        };
+
+        /** \brief Last forwarded payload of a CAN message id */
+        struct LastPayload
+        {
+            /** \brief Payload as a 64 bits word */
+            uint64_t payload;
+            /** \brief Mask applied on the payload for the last comparison, a new mask forwards the next message */
+            uint64_t mask;
+            /** \brief Timestamp in nanoseconds of the last forwarded message */
+            int64_t timestamp;
+            /** \brief Payload size */
+            uint8_t size;
+            /** \brief Indicate if a message has already been forwarded */
+            bool valid;
+        };
+
+        /** \brief Last payloads by CAN message id */
+        typedef std::unordered_map<uint32_t, LastPayload> last_payload_map_t;
+
+
+        /** \brief Current rules */
+        RcuPtr<Rules> m_rules;
+
+        /** \brief Last payloads, only accessed by the thread which processes the CAN messages */
+        last_payload_map_t m_last_payloads;
+
+        /** \brief Indicate if the last payloads must be forgotten before processing the next CAN message */
+        std::atomic<bool> m_reset_requested;
+
+
+        /** \brief Compute the key of a CAN message id in the last payloads map */
+        static uint32_t getKey(const uint32_t id, const bool extended) { return (extended ? (id | 0x80000000u) : id); }
+};
+
+
+#endif // CHANGEDETECTCANMSGFILTER_H
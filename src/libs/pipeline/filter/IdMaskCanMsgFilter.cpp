@@ -24,8 +24,7 @@ using namespace std;
 /** \brief Constructor */
 IdMaskCanMsgFilter::IdMaskCanMsgFilter()
 : CanPipelineStageBase(true)
-, m_filters_std()
-, m_filters_ext()
+, m_rules(new Rules())
 {}
 
 /** \brief Destructor */
@@ -35,27 +34,32 @@ IdMaskCanMsgFilter::~IdMaskCanMsgFilter()
 /** \brief Add a message id mask filter */
 void IdMaskCanMsgFilter::add(const uint32_t id, const uint32_t mask, const bool extended)
 {
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        m_filters_ext.push_back(pair<uint32_t, uint32_t>(id, mask));
-    }
-    else
-    {
-        m_filters_std.push_back(pair<uint32_t, uint32_t>(id, mask));
-    }
+        getFilters(rules, extended).push_back(pair<uint32_t, uint32_t>(id, mask));
+    });
 }
 
 /** \brief Remove a message id mask filter */
 void IdMaskCanMsgFilter::remove(const uint32_t id, const uint32_t mask, const bool extended)
 {
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        m_filters_ext.remove(pair<uint32_t, uint32_t>(id, mask));
-    }
-    else
-    {
-        m_filters_std.remove(pair<uint32_t, uint32_t>(id, mask));
-    }
+        getFilters(rules, extended).remove(pair<uint32_t, uint32_t>(id, mask));
+    });
+}
+
+/** \brief Get a copy of the current mask filter rules */
+IdMaskCanMsgFilter::Rules IdMaskCanMsgFilter::getRules() const
+{
+    RcuPtr<Rules>::ReadGuard rules(m_rules);
+    return *rules;
+}
+
+/** \brief Replace all the mask filter rules at once */
+void IdMaskCanMsgFilter::setRules(const Rules& rules)
+{
+    m_rules.publish(new Rules(rules));
 }
 
 
@@ -66,14 +70,16 @@ bool IdMaskCanMsgFilter::processCanData(const CanData& can_data)
 
     if (CAN_DATA_IS_CANMSG(can_data))
     {
-        filter_mask_list_t* filters;
+        RcuPtr<Rules>::ReadGuard rules(m_rules);
+
+        const filter_mask_list_t* filters;
         if (can_data.msg.extended)
         {
-            filters = &m_filters_ext;
+            filters = &rules->ext_filters;
         }
         else
         {
-            filters = &m_filters_std;
+            filters = &rules->std_filters;
         }
 
         for (auto iter = filters->begin(); (forward_data && (iter != filters->end())); ++iter)
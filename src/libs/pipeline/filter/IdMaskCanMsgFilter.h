@@ -21,15 +21,28 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define IDMASKCANMSGFILTER_H
 
 #include "CanPipelineStageBase.h"
+#include "RcuPtr.h"
 
 #include <list>
 
 
-/** \brief CAN message filter based on a mask on the message id */
+/** \brief CAN message filter based on a mask on the message id, the filters can be modified while the filter is running */
 class IdMaskCanMsgFilter : public CanPipelineStageBase
 {
     public:
 
+        /** \brief List of mask filters */
+        typedef std::list<std::pair<uint32_t, uint32_t>> filter_mask_list_t;
+
+        /** \brief Mask filter rules */
+        struct Rules
+        {
+            /** \brief Message id mask filters for standard messages */
+            filter_mask_list_t std_filters;
+            /** \brief Message id mask filters for extended messages */
+            filter_mask_list_t ext_filters;
+        };
+
 
         /** \brief Constructor */
         IdMaskCanMsgFilter();
@@ -44,6 +57,12 @@ class IdMaskCanMsgFilter : public CanPipelineStageBase
         /** \brief Remove a message id mask filter */
         void remove(const uint32_t id, const uint32_t mask, const bool extended);
 
+        /** \brief Get a copy of the current mask filter rules */
+        Rules getRules() const;
+
+        /** \brief Replace all the mask filter rules at once */
+        void setRules(const Rules& rules);
+
 
 
     protected:
@@ -54,15 +73,12 @@ class IdMaskCanMsgFilter : public CanPipelineStageBase
 
     private:
 
-        /** \brief List of mask filters */
-        typedef std::list<std::pair<uint32_t, uint32_t>> filter_mask_list_t;
-
+        /** \brief Current rules */
+        RcuPtr<Rules> m_rules;
 
-        /** \brief Message id mask filters for standard messages */
-        filter_mask_list_t m_filters_std;
 
-        /** \brief Message id mask filters for extended messages */
-        filter_mask_list_t m_filters_ext;
+        /** \brief Select the mask filters matching the message type */
+        static filter_mask_list_t& getFilters(Rules& rules, const bool extended) { return (extended ? rules.ext_filters : rules.std_filters); }
 };
 
 
@@ -0,0 +1,342 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SignalPredicateCanMsgFilter.h"
+#include "ICanMsgDatabase.h"
+#include "CanMsgSignal.h"
+#include "LinearCanMsgValueConverter.h"
+#include "FunctionCanMsgValueConverter.h"
+#include "EnumCanMsgValueConverter.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+/** \brief Relative tolerance under which a reference value converted back to an integer raw value is rounded to this integer */
+static const double INTEGER_TOLERANCE = 1e-9;
+
+/** \brief Constructor */
+SignalPredicateCanMsgFilter::SignalPredicateCanMsgFilter(const ICanMsgDatabase& can_msg_database)
+: CanPipelineStageBase(true)
+, m_can_msg_database(can_msg_database)
+, m_rules(new Rules())
+{}
+
+/** \brief Destructor */
+SignalPredicateCanMsgFilter::~SignalPredicateCanMsgFilter()
+{}
+
+/** \brief Add a predicate on the raw value of a signal */
+bool SignalPredicateCanMsgFilter::add(const std::string& signal_name, const Operator op, const double value)
+{
+    bool ret = false;
+
+    // Look for the first signal with this name which has a value
+    const CanMsgNameIndex& name_index = m_can_msg_database.getNameIndex();
+    for (CanMsgNameIndex::handle_t handle = name_index.findSignal(signal_name); !ret && (handle != CanMsgNameIndex::INVALID_HANDLE); handle = name_index.getSignal(handle).next)
+    {
+        ret = add(handle, op, value);
+    }
+    if (!ret && m_can_msg_database.isLazy())
+    {
+        // The messages built on demand by a database are not in its name index
+        const CanMsgDesc* can_msg = m_can_msg_database.loadSignalCanMsg(signal_name);
+        if (can_msg != nullptr)
+        {
+            const auto& signals = can_msg->getSignals();
+            for (size_t i = 0; !ret && (i < signals.size()); i++)
+            {
+                ret = ((signals[i]->getName() == signal_name) && addPredicate(*can_msg, i, op, value));
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Add a predicate on the raw value of a signal identified by its handle in the name index of the database,
+           return false if the handle is invalid */
+bool SignalPredicateCanMsgFilter::add(const CanMsgNameIndex::handle_t signal_handle, const Operator op, const double value)
+{
+    bool ret = false;
+
+    const CanMsgNameIndex& name_index = m_can_msg_database.getNameIndex();
+    if (signal_handle < name_index.getSignalCount())
+    {
+        const CanMsgNameIndex::SignalEntry& entry = name_index.getSignal(signal_handle);
+        ret = addPredicate(*entry.can_msg, entry.signal_index, op, value);
+    }
+
+    return ret;
+}
+
+/** \brief Add a predicate on the converted value of a signal of a CAN message, return false if the signal has no value
+           or if its converter can't be inverted */
+bool SignalPredicateCanMsgFilter::addPredicate(const CanMsgDesc& can_msg, const size_t signal_index, const Operator op, const double value)
+{
+    bool ret = false;
+
+    const CanMsgSignal& signal = *can_msg.getSignals()[signal_index];
+    if (signal.getCanMsgValue() != nullptr)
+    {
+        // Compile the predicate, the raw values are compared with the reference value in the raw domain
+        Predicate predicate;
+        ret = (compilePredicate(can_msg, can_msg.getSignalValueIndex(signal_index), op, value, predicate) && revertPredicate(signal, predicate));
+        if (ret)
+        {
+            m_rules.update([&](Rules& rules)
+            {
+                rules.predicates[getKey(can_msg.getId(), can_msg.isExtented())].push_back(predicate);
+            });
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Remove all the predicates */
+void SignalPredicateCanMsgFilter::clear()
+{
+    m_rules.publish(new Rules());
+}
+
+
+/** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
+bool SignalPredicateCanMsgFilter::processCanData(const CanData& can_data)
+{
+    bool forward_data = true;
+
+    if (CAN_DATA_IS_CANMSG(can_data))
+    {
+        RcuPtr<Rules>::ReadGuard rules(m_rules);
+
+        auto iter = rules->predicates.find(getKey(can_data.msg.id, can_data.msg.extended));
+        if (iter != rules->predicates.end())
+        {
+            // Load the payload as a single word
+            const uint64_t payload = CanMsgExtractionPlan::loadPayload(can_data.msg);
+
+            // Check all the predicates of the message
+            const vector<Predicate>& predicates = iter->second;
+            for (size_t i = 0; forward_data && (i < predicates.size()); i++)
+            {
+                const Predicate& predicate = predicates[i];
+                forward_data = ((can_data.msg.size >= predicate.min_size) &&
+                                (CanMsgExtractionPlan::extractBits(payload, predicate.multiplexer_field) == predicate.multiplexer_value) &&
+                                evaluatePredicate(predicate, payload));
+            }
+        }
+    }
+
+    return forward_data;
+}
+
+/** \brief Compile a predicate on a CAN message value */
+bool SignalPredicateCanMsgFilter::compilePredicate(const CanMsgDesc& can_msg, const size_t value_index, const Operator op, const double value, Predicate& predicate)
+{
+    const ICanMsgValue& can_value = *can_msg.getValues()[value_index];
+    bool ret = CanMsgExtractionPlan::compileField(can_value, predicate.field);
+    if (ret)
+    {
+        // The multiplexer check always holds for the values which are not multiplexed
+        predicate.multiplexer_field = { 0u, 0u, 0u, CanMsgExtractionPlan::EXTRACT_INTEGER, false };
+        predicate.multiplexer_value = 0u;
+        if (can_msg.getValueMultiplexerValue(value_index, predicate.multiplexer_value))
+        {
+            ret = CanMsgExtractionPlan::compileField(*can_msg.getMultiplexer(), predicate.multiplexer_field);
+        }
+    }
+    if (ret)
+    {
+        predicate.value = value;
+        predicate.min_size = CanMsgExtractionPlan::getPayloadSize(can_value);
+        predicate.op = op;
+    }
+
+    return ret;
+}
+
+/** \brief Convert back the reference value of a predicate to a raw value through the converter of its signal,
+           return false if the converter can't be inverted */
+bool SignalPredicateCanMsgFilter::revertPredicate(const CanMsgSignal& signal, Predicate& predicate)
+{
+    bool ret = true;
+
+    // The signals without converter and the enumerates are compared on their raw value
+    const ICanMsgValueConverter* converter = signal.getConverter();
+    if ((converter != nullptr) && (dynamic_cast<const EnumCanMsgValueConverter*>(converter) == nullptr))
+    {
+        double factor = 0.;
+        double offset = 0.;
+        const LinearCanMsgValueConverter* linear_converter = dynamic_cast<const LinearCanMsgValueConverter*>(converter);
+        const FunctionCanMsgValueConverter* function_converter = dynamic_cast<const FunctionCanMsgValueConverter*>(converter);
+        if (linear_converter != nullptr)
+        {
+            factor = linear_converter->getFactor();
+            offset = linear_converter->getOffset();
+        }
+        else if ((function_converter == nullptr) || !function_converter->getLinearCoefficients(factor, offset))
+        {
+            // Only the linear transfer functions can be inverted
+            factor = 0.;
+        }
+        ret = (factor != 0.);
+        if (ret)
+        {
+            // (raw * factor + offset) op value <=> raw op' ((value - offset) / factor), a negative factor reverses the order
+            double raw_value = ((predicate.value - offset) / factor);
+            const double integer_value = round(raw_value);
+            if ((predicate.field.type != CanMsgExtractionPlan::EXTRACT_FLOAT) && (predicate.field.type != CanMsgExtractionPlan::EXTRACT_DOUBLE) &&
+                (fabs(raw_value - integer_value) <= (INTEGER_TOLERANCE * max(1., fabs(raw_value)))))
+            {
+                // Rounding errors of the division must not exclude the integer raw value which converts exactly to the reference value
+                raw_value = integer_value;
+            }
+            predicate.value = raw_value;
+            if (factor < 0.)
+            {
+                switch (predicate.op)
+                {
+                    case OP_LOWER:
+                    {
+                        predicate.op = OP_GREATER;
+                        break;
+                    }
+
+                    case OP_LOWER_OR_EQUAL:
+                    {
+                        predicate.op = OP_GREATER_OR_EQUAL;
+                        break;
+                    }
+
+                    case OP_GREATER:
+                    {
+                        predicate.op = OP_LOWER;
+                        break;
+                    }
+
+                    case OP_GREATER_OR_EQUAL:
+                    {
+                        predicate.op = OP_LOWER_OR_EQUAL;
+                        break;
+                    }
+
+                    default:
+                    {
+                        // The equality doesn't depend on the order
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Evaluate a predicate on a payload word */
+bool SignalPredicateCanMsgFilter::evaluatePredicate(const Predicate& predicate, const uint64_t payload)
+{
+    // Extract the raw value
+    const CanMsgValueData raw_value = CanMsgExtractionPlan::extractValue(payload, predicate.field);
+    double value;
+    switch (predicate.field.type)
+    {
+        case CanMsgExtractionPlan::EXTRACT_BOOL:
+        {
+            value = (raw_value.bool_value ? 1. : 0.);
+            break;
+        }
+
+        case CanMsgExtractionPlan::EXTRACT_FLOAT:
+        {
+            value = raw_value.float_value;
+            break;
+        }
+
+        case CanMsgExtractionPlan::EXTRACT_DOUBLE:
+        {
+            value = raw_value.double_value;
+            break;
+        }
+
+        default:
+        {
+            if (predicate.field.sign_bit != 0u)
+            {
+                value = static_cast<double>(raw_value.int_value);
+            }
+            else
+            {
+                value = static_cast<double>(raw_value.uint_value);
+            }
+            break;
+        }
+    }
+
+    // Compare with the reference value
+    bool ret;
+    switch (predicate.op)
+    {
+        case OP_EQUAL:
+        {
+            ret = (value == predicate.value);
+            break;
+        }
+
+        case OP_NOT_EQUAL:
+        {
+            ret = (value != predicate.value);
+            break;
+        }
+
+        case OP_LOWER:
+        {
+            ret = (value < predicate.value);
+            break;
+        }
+
+        case OP_LOWER_OR_EQUAL:
+        {
+            ret = (value <= predicate.value);
+            break;
+        }
+
+        case OP_GREATER:
+        {
+            ret = (value > predicate.value);
+            break;
+        }
+
+        case OP_GREATER_OR_EQUAL:
+        {
+            ret = (value >= predicate.value);
+            break;
+        }
+
+        default:
+        {
+            ret = false;
+            break;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,148 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SIGNALPREDICATECANMSGFILTER_H
+#define SIGNALPREDICATECANMSGFILTER_H
+
+#include "CanPipelineStageBase.h"
+#include "RcuPtr.h"
+#include "CanMsgExtractionPlan.h"
+#include "CanMsgNameIndex.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class ICanMsgDatabase;
+class CanMsgDesc;
+class CanMsgSignal;
+
+
+/** \brief CAN message filter which forwards a CAN message only when predicates on its signals' converted values hold,
+           the reference values are converted back once to raw values through the linear converters of the signals so that
+           only the bits of the signals referenced by the predicates are extracted from the payload and never converted.
+           The clamping bounds of the converters are not taken into account.
+           The messages without predicates are always forwarded */
+class SignalPredicateCanMsgFilter : public CanPipelineStageBase
+{
+    public:
+
+        /** \brief Comparison operators */
+        enum Operator
+        {
+            /** \brief Signal value == reference value */
+            OP_EQUAL = 0,
+            /** \brief Signal value != reference value */
+            OP_NOT_EQUAL = 1u,
+            /** \brief Signal value < reference value */
+            OP_LOWER = 2u,
+            /** \brief Signal value <= reference value */
+            OP_LOWER_OR_EQUAL = 3u,
+            /** \brief Signal value > reference value */
+            OP_GREATER = 4u,
+            /** \brief Signal value >= reference value */
+            OP_GREATER_OR_EQUAL = 5u
+        };
+
+
+        /** \brief Constructor */
+        SignalPredicateCanMsgFilter(const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Destructor */
+        virtual ~SignalPredicateCanMsgFilter();
+
+
+        /** \brief Add a predicate on the converted value of a signal (the enumerate value for the signals with an enumerate
+                   converter), all the predicates of a CAN message must hold for the message to be forwarded (a predicate on
+                   a multiplexed signal doesn't hold when the signal is not selected). Return false if the signal doesn't exist
+                   in the database or if its converter can't be inverted */
+        bool add(const std::string& signal_name, const Operator op, const double value);
+
+        /** \brief Add a predicate on the converted value of a signal identified by its handle in the name index of the database,
+                   return false if the handle is invalid or if the converter of the signal can't be inverted */
+        bool add(const CanMsgNameIndex::handle_t signal_handle, const Operator op, const double value);
+
+        /** \brief Remove all the predicates */
+        void clear();
+
+
+
+    protected:
+
+        /** \brief Process received CAN data, return true if CAN data must be forwarded to childs */
+        virtual bool processCanData(const CanData& can_data) override;
+
+
+    private:
+
+        /** \brief Predicate on a signal's value, precompiled to extract the value from the payload word */
+        struct Predicate
+        {
+            /** \brief Location of the value in the payload word */
+            CanMsgExtractionPlan::Field field;
+            /** \brief Location of the multiplexer in the payload word (null mask if the value is not multiplexed) */
+            CanMsgExtractionPlan::Field multiplexer_field;
+            /** \brief Multiplexer value which selects the value (0 if the value is not multiplexed) */
+            uint64_t multiplexer_value;
+            /** \brief Reference value converted back to a raw value */
+            double value;
+            /** \brief Minimal payload size to contain the value */
+            uint8_t min_size;
+            /** \brief Comparison operator */
+            Operator op;
+        };
+
+        /** \brief Predicates by CAN message id */
+        typedef std::unordered_map<uint32_t, std::vector<Predicate>> predicates_map_t;
+
+        /** \brief Predicates rules */
+        struct Rules
+        {
+            /** \brief Predicates */
+            predicates_map_t predicates;
+        };
+
+
+        /** \brief CAN messages database */
+        const ICanMsgDatabase& m_can_msg_database;
+
+        /** \brief Current rules */
+        RcuPtr<Rules> m_rules;
+
+
+        /** \brief Add a predicate on the converted value of a signal of a CAN message, return false if the signal has no value
+                   or if its converter can't be inverted */
+        bool addPredicate(const CanMsgDesc& can_msg, const size_t signal_index, const Operator op, const double value);
+
+        /** \brief Compile a predicate on a CAN message value */
+        static bool compilePredicate(const CanMsgDesc& can_msg, const size_t value_index, const Operator op, const double value, Predicate& predicate);
+
+        /** \brief Convert back the reference value of a predicate to a raw value through the converter of its signal,
+                   return false if the converter can't be inverted */
+        static bool revertPredicate(const CanMsgSignal& signal, Predicate& predicate);
+
+        /** \brief Evaluate a predicate on a payload word */
+        static bool evaluatePredicate(const Predicate& predicate, const uint64_t payload);
+
+        /** \brief Compute the key of a CAN message id in the predicates map */
+        static uint32_t getKey(const uint32_t id, const bool extended) { return (extended ? (id | 0x80000000u) : id); }
+};
+
+
+#endif // SIGNALPREDICATECANMSGFILTER_H
@@ -24,8 +24,7 @@ using namespace std;
 /** \brief Constructor */
 WhiteListCanMsgFilter::WhiteListCanMsgFilter()
 : CanPipelineStageBase(true)
-, m_white_list_std()
-, m_white_list_ext()
+, m_rules(new Rules())
 {}
 
 /** \brief Destructor */
@@ -35,63 +34,88 @@ WhiteListCanMsgFilter::~WhiteListCanMsgFilter()
 /** \brief Add a CAN message id to the white list */
 void WhiteListCanMsgFilter::add(const uint32_t id, const bool extended)
 {
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        m_white_list_ext.insert(id);
-    }
-    else
-    {
-        m_white_list_std.insert(id);
-    }
+        getWhiteList(rules, extended).insert(id);
+    });
+    notifyAcceptanceFiltersChanged();
 }
 
 /** \brief Add a range of CAN message ids to the white list */
 void WhiteListCanMsgFilter::add(const CanMsgIdRange& range, const bool extended)
 {
-    white_list_t* white_list;
-    if (extended)
-    {
-        white_list = &m_white_list_ext;
-    }
-    else
+    m_rules.update([&](Rules& rules)
     {
-        white_list = &m_white_list_std;
-    }
-    for (uint32_t id = range.minId(); id <= range.maxId(); id++)
-    {
-        white_list->insert(id);
-    }
+        white_list_t& white_list = getWhiteList(rules, extended);
+        for (uint32_t id = range.minId(); id <= range.maxId(); id++)
+        {
+            white_list.insert(id);
+        }
+    });
+    notifyAcceptanceFiltersChanged();
 }
 
 /** \brief Remove a CAN message id from the white list */
 void WhiteListCanMsgFilter::remove(const uint32_t id, const bool extended)
 {
-    if (extended)
-    {
-        m_white_list_ext.erase(id);
-    }
-    else
+    m_rules.update([&](Rules& rules)
     {
-        m_white_list_std.erase(id);
-    }
+        getWhiteList(rules, extended).erase(id);
+    });
+    notifyAcceptanceFiltersChanged();
 }
 
 /** \brief Remove a range of CAN message ids from the white list */
 void WhiteListCanMsgFilter::remove(const CanMsgIdRange& range, const bool extended)
 {
-    white_list_t* white_list;
-    if (extended)
+    m_rules.update([&](Rules& rules)
     {
-        white_list = &m_white_list_ext;
-    }
-    else
-    {
-        white_list = &m_white_list_std;
-    }
-    for (uint32_t id = range.minId(); id <= range.maxId(); id++)
+        white_list_t& white_list = getWhiteList(rules, extended);
+        for (uint32_t id = range.minId(); id <= range.maxId(); id++)
+        {
+            white_list.erase(id);
+        }
+    });
+    notifyAcceptanceFiltersChanged();
+}
+
+/** \brief Get a copy of the current white list rules */
+WhiteListCanMsgFilter::Rules WhiteListCanMsgFilter::getRules() const
+{
+    RcuPtr<Rules>::ReadGuard rules(m_rules);
+    return *rules;
+}
+
+/** \brief Replace all the white list rules at once */
+void WhiteListCanMsgFilter::setRules(const Rules& rules)
+{
+    m_rules.publish(new Rules(rules));
+    notifyAcceptanceFiltersChanged();
+}
+
+
+/** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list */
+bool WhiteListCanMsgFilter::getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const
+{
+    bool ret = false;
+
+    if (isEnabled())
     {
-        white_list->erase(id);
+        RcuPtr<Rules>::ReadGuard rules(m_rules);
+        for (auto iter = rules->std_ids.begin(); iter != rules->std_ids.end(); ++iter)
+        {
+            const CanAdapterFilter filter = { *iter, 0x7FFu, false };
+            filters.push_back(filter);
+        }
+        for (auto iter = rules->ext_ids.begin(); iter != rules->ext_ids.end(); ++iter)
+        {
+            const CanAdapterFilter filter = { *iter, 0x1FFFFFFFu, true };
+            filters.push_back(filter);
+        }
+        ret = true;
     }
+
+    return ret;
 }
 
 
@@ -102,14 +126,16 @@ bool WhiteListCanMsgFilter::processCanData(const CanData& can_data)
 
     if (CAN_DATA_IS_CANMSG(can_data))
     {
-        white_list_t* white_list;
+        RcuPtr<Rules>::ReadGuard rules(m_rules);
+
+        const white_list_t* white_list;
         if (can_data.msg.extended)
         {
-            white_list = &m_white_list_ext;
+            white_list = &rules->ext_ids;
         }
         else
         {
-            white_list = &m_white_list_std;
+            white_list = &rules->std_ids;
         }
 
         forward_data = (white_list->find(can_data.msg.id) != white_list->end());
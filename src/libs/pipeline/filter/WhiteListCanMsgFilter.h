@@ -22,16 +22,30 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "CanPipelineStageBase.h"
 #include "CanMsgIdRange.h"
+#include "RcuPtr.h"
 
 #include <vector>
 #include <unordered_set>
 
 
-/** \brief CAN message filter based on a white list */
+/** \brief CAN message filter based on a white list, the list can be modified while the filter is running
+           and the acceptance filters pushed down to the CAN controller follow its modifications */
 class WhiteListCanMsgFilter : public CanPipelineStageBase
 {
     public:
 
+        /** \brief White list */
+        typedef std::unordered_set<uint32_t> white_list_t;
+
+        /** \brief White list rules */
+        struct Rules
+        {
+            /** \brief White list for standard messages */
+            white_list_t std_ids;
+            /** \brief White list for extended messages */
+            white_list_t ext_ids;
+        };
+
 
         /** \brief Constructor */
         WhiteListCanMsgFilter();
@@ -52,6 +66,17 @@ class WhiteListCanMsgFilter : public CanPipelineStageBase
         /** \brief Remove a range of CAN message ids from the white list */
         void remove(const CanMsgIdRange& range, const bool extended);
 
+        /** \brief Get a copy of the current white list rules */
+        Rules getRules() const;
+
+        /** \brief Replace all the white list rules at once */
+        void setRules(const Rules& rules);
+
+
+        /** \brief Append the acceptance filters matching the CAN messages processed by the stage to the list,
+                   return false if the stage needs all the CAN messages */
+        virtual bool getAcceptanceFilters(std::vector<CanAdapterFilter>& filters) const override;
+
 
 
     protected:
@@ -62,14 +87,12 @@ class WhiteListCanMsgFilter : public CanPipelineStageBase
 
     private:
 
-        /** \brief White list */
-        typedef std::unordered_set<uint32_t> white_list_t;
+        /** \brief Current rules */
+        RcuPtr<Rules> m_rules;
 
-        /** \brief White list for standard messages */
-        white_list_t m_white_list_std;
 
-        /** \brief White list for extended messages */
-        white_list_t m_white_list_ext;
+        /** \brief Select the white list matching the message type */
+        static white_list_t& getWhiteList(Rules& rules, const bool extended) { return (extended ? rules.ext_ids : rules.std_ids); }
 };
 
 
@@ -18,12 +18,10 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "DecodedCanMsgStreamLogger.h"
-#include "CanMsgDesc.h"
 #include "CanMsgSignal.h"
 #include "osal.h"
 
 #include <sstream>
-#include <algorithm>
 using namespace std;
 
 /** \brief Constructor */
@@ -45,7 +43,7 @@ void DecodedCanMsgStreamLogger::setOutputOptions(std::ostream& output_stream, co
 }
 
 /** \brief Called when message has been decoded */
-void DecodedCanMsgStreamLogger::canMsgDecoded(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg)
+void DecodedCanMsgStreamLogger::canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame)
 {
     // Check if the output stream has been configured
     if (m_output_stream != nullptr)
@@ -55,13 +53,13 @@ void DecodedCanMsgStreamLogger::canMsgDecoded(const CanMsg& can_msg, const CanMs
         {
             case OUT_TEXT:
             {
-                textOutput(can_msg, decoded_can_msg);
+                textOutput(can_msg, decoded_frame);
                 break;
             }
 
             case OUT_CSV:
             {
-                csvOutput(can_msg, decoded_can_msg);
+                csvOutput(can_msg, decoded_frame);
                 break;
             }
 
@@ -75,7 +73,7 @@ void DecodedCanMsgStreamLogger::canMsgDecoded(const CanMsg& can_msg, const CanMs
 }
 
 /** \brief Output data in text mode */
-void DecodedCanMsgStreamLogger::textOutput(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg)
+void DecodedCanMsgStreamLogger::textOutput(const CanMsg& can_msg, const DecodedFrame& decoded_frame)
 {
     std::ostream& output_stream = *m_output_stream;
 
@@ -87,9 +85,12 @@ void DecodedCanMsgStreamLogger::textOutput(const CanMsg& can_msg, const CanMsgDe
     timestamp_str << timestamp.tm_hour << ":" << timestamp.tm_min << ":" << timestamp.tm_sec << ".";
     timestamp_str << can_msg.header.timestamp_nsec << " - ";
 
-    auto signals = decoded_can_msg.getSignals();
-    auto print_signal = [this, can_msg, &output_stream, &timestamp_str](const shared_ptr<CanMsgSignal>& signal)
+    const auto& signals = decoded_frame.getCanMsg()->getSignals();
+    const auto& decoded_signals = decoded_frame.getDecodedSignals();
+    for (size_t j = 0; j < decoded_signals.size(); j++)
     {
+        const size_t i = decoded_signals[j];
+        const CanMsgSignal* signal = signals[i].get();
         output_stream << timestamp_str.str();
         if (can_msg.header.type == CAN_DATA_RX_MSG)
         {
@@ -100,23 +101,21 @@ void DecodedCanMsgStreamLogger::textOutput(const CanMsg& can_msg, const CanMsgDe
             output_stream << "TX - ";
         }
         output_stream << signal->getName() << " - ";
-        printValue(signal->getConvertedValue(), signal->getConvertedValueType());
+        printValue(decoded_frame.getTypedConvertedValue(i));
         if (!signal->getUnit().empty())
         {
             output_stream << " " << signal->getUnit();
         }
         output_stream << " (";
-        printValue(signal->getRawValue(), signal->getRawValueType());
+        printValue(decoded_frame.getTypedRawValue(i));
         output_stream << ")";
 
         output_stream << endl;
-    };
-
-    for_each(signals.cbegin(), signals.cend(), print_signal);
+    }
 }
 
 /** \brief Output data in CSV mode */
-void DecodedCanMsgStreamLogger::csvOutput(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg)
+void DecodedCanMsgStreamLogger::csvOutput(const CanMsg& can_msg, const DecodedFrame& decoded_frame)
 {
     std::ostream& output_stream = *m_output_stream;
 
@@ -128,9 +127,12 @@ void DecodedCanMsgStreamLogger::csvOutput(const CanMsg& can_msg, const CanMsgDes
     timestamp_str << timestamp.tm_hour << ":" << timestamp.tm_min << ":" << timestamp.tm_sec << ".";
     timestamp_str << can_msg.header.timestamp_nsec << ";";
 
-    auto signals = decoded_can_msg.getSignals();
-    auto print_signal = [this, can_msg, &output_stream, &timestamp_str](const shared_ptr<CanMsgSignal>& signal)
+    const auto& signals = decoded_frame.getCanMsg()->getSignals();
+    const auto& decoded_signals = decoded_frame.getDecodedSignals();
+    for (size_t j = 0; j < decoded_signals.size(); j++)
     {
+        const size_t i = decoded_signals[j];
+        const CanMsgSignal* signal = signals[i].get();
         output_stream << timestamp_str.str();
         if (can_msg.header.type == CAN_DATA_RX_MSG)
         {
@@ -141,47 +143,66 @@ void DecodedCanMsgStreamLogger::csvOutput(const CanMsg& can_msg, const CanMsgDes
             output_stream << "TX;";
         }
         output_stream << signal->getName() << ";";
-        printValue(signal->getConvertedValue(), signal->getConvertedValueType());
+        printValue(decoded_frame.getTypedConvertedValue(i));
         if (!signal->getUnit().empty())
         {
             output_stream << ";" << signal->getUnit();
         }
         output_stream << ";";
-        printValue(signal->getRawValue(), signal->getRawValueType());
+        printValue(decoded_frame.getTypedRawValue(i));
 
         output_stream << endl;
-    };
-
-    for_each(signals.cbegin(), signals.cend(), print_signal);
+    }
 }
 
 /** \brief Outputs a value to the stream */
-void DecodedCanMsgStreamLogger::printValue(const void* value, const std::string& value_type)
+void DecodedCanMsgStreamLogger::printValue(const CanMsgTypedValue& typed_value)
 {
     std::ostream& output_stream = *m_output_stream;
+    const CanMsgValueData& value = typed_value.value;
 
-    if (value_type == "uint")
+    switch (typed_value.type)
     {
-        output_stream << *reinterpret_cast<const uint64_t*>(value);
-    }
-    else if (value_type == "int")
-    {
-        output_stream << *reinterpret_cast<const int64_t*>(value);
-    }
-    else if (value_type == "double")
-    {
-        output_stream << *reinterpret_cast<const double*>(value);
-    }
-    else if (value_type == "float")
-    {
-        output_stream << *reinterpret_cast<const float*>(value);
-    }
-    else if (value_type == "string")
-    {
-        output_stream << *reinterpret_cast<const string*>(value);
-    }
-    else
-    {
-        output_stream << "Unknown type (" << value_type << ")";
+        case CANMSGVALUE_BOOL:
+        {
+            output_stream << (value.bool_value ? "true" : "false");
+            break;
+        }
+
+        case CANMSGVALUE_UINT:
+        {
+            output_stream << value.uint_value;
+            break;
+        }
+
+        case CANMSGVALUE_INT:
+        {
+            output_stream << value.int_value;
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            output_stream << value.float_value;
+            break;
+        }
+
+        case CANMSGVALUE_DOUBLE:
+        {
+            output_stream << value.double_value;
+            break;
+        }
+
+        case CANMSGVALUE_STRING:
+        {
+            output_stream << *value.string_value;
+            break;
+        }
+
+        default:
+        {
+            output_stream << "Unknown type (" << getCanMsgValueTypeName(typed_value.type) << ")";
+            break;
+        }
     }
 }
@@ -53,7 +53,7 @@ class DecodedCanMsgStreamLogger : public ICanMsgDecoderListener
 
 
         /** \brief Called when message has been decoded */
-        virtual void canMsgDecoded(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg) override;
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) override;
 
 
     
@@ -67,13 +67,13 @@ class DecodedCanMsgStreamLogger : public ICanMsgDecoderListener
 
 
         /** \brief Output data in text mode */
-        void textOutput(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg);
+        void textOutput(const CanMsg& can_msg, const DecodedFrame& decoded_frame);
 
         /** \brief Output data in CSV mode */
-        void csvOutput(const CanMsg& can_msg, const CanMsgDesc& decoded_can_msg);
+        void csvOutput(const CanMsg& can_msg, const DecodedFrame& decoded_frame);
 
         /** \brief Outputs a value to the stream */
-        void printValue(const void* value, const std::string& value_type);
+        void printValue(const CanMsgTypedValue& typed_value);
 };
 
 
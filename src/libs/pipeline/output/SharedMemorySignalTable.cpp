@@ -0,0 +1,210 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SharedMemorySignalTable.h"
+#include "ICanMsgDatabase.h"
+#include "CanMsgSignal.h"
+#include "EnumCanMsgValueConverter.h"
+
+#include <algorithm>
+using namespace std;
+
+
+/** \brief Constructor */
+SharedMemorySignalTable::SharedMemorySignalTable()
+: m_shared_memory()
+, m_can_msg_index()
+, m_first_targets()
+, m_targets()
+{}
+
+/** \brief Destructor */
+SharedMemorySignalTable::~SharedMemorySignalTable()
+{
+    close();
+}
+
+/** \brief Create the shared memory segment with the layout of the signals of a database */
+bool SharedMemorySignalTable::create(const std::string& name, const ICanMsgDatabase& can_msg_database)
+{
+    bool ret = false;
+
+    // List all the signals of the database, including the ones of the CAN messages which are built on demand
+    m_can_msg_index.build(can_msg_database);
+    vector<const CanMsgSignal*> signals;
+    m_first_targets.clear();
+    const auto& can_msgs = m_can_msg_index.getCanMsgs();
+    for (size_t msg_index = 0; msg_index < can_msgs.size(); msg_index++)
+    {
+        m_first_targets.push_back(signals.size());
+        const auto& msg_signals = can_msgs[msg_index]->getSignals();
+        for (size_t i = 0; i < msg_signals.size(); i++)
+        {
+            signals.push_back(msg_signals[i].get());
+        }
+    }
+
+    // The directory is sorted by name so that the readers can look for a signal with a binary search
+    vector<uint32_t> directory_order(signals.size());
+    for (size_t i = 0; i < directory_order.size(); i++)
+    {
+        directory_order[i] = static_cast<uint32_t>(i);
+    }
+    stable_sort(directory_order.begin(), directory_order.end(), [&signals](const uint32_t left, const uint32_t right) { return (signals[left]->getName() < signals[right]->getName()); });
+
+    // Compute the size of each part of the table
+    size_t label_count = 0;
+    size_t strings_size = 0;
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+        strings_size += signals[i]->getName().size() + 1u;
+        const EnumCanMsgValueConverter* enum_converter = dynamic_cast<const EnumCanMsgValueConverter*>(signals[i]->getConverter());
+        if (enum_converter != nullptr)
+        {
+            label_count += enum_converter->getLabelCount();
+            for (size_t label_index = 0; label_index < enum_converter->getLabelCount(); label_index++)
+            {
+                strings_size += enum_converter->getLabel(static_cast<uint32_t>(label_index)).size() + 1u;
+            }
+        }
+    }
+    const size_t directory_offset = sizeof(SignalTableHeader);
+    size_t entries_offset = directory_offset + signals.size() * sizeof(SignalTableDirectoryEntry);
+    entries_offset = ((entries_offset + SIGNAL_TABLE_ENTRIES_ALIGNMENT - 1u) / SIGNAL_TABLE_ENTRIES_ALIGNMENT) * SIGNAL_TABLE_ENTRIES_ALIGNMENT;
+    const size_t labels_offset = entries_offset + signals.size() * sizeof(SignalTableEntry);
+    const size_t strings_offset = labels_offset + label_count * sizeof(SignalTableString);
+    const size_t size = strings_offset + strings_size;
+
+    // Create the segment
+    close();
+    if ((size <= 0xFFFFFFFFu) && m_shared_memory.create(name, size))
+    {
+        uint8_t* base = reinterpret_cast<uint8_t*>(m_shared_memory.getAddress());
+        memset(base, 0, size);
+        SignalTableDirectoryEntry* directory = reinterpret_cast<SignalTableDirectoryEntry*>(base + directory_offset);
+        SignalTableEntry* entries = reinterpret_cast<SignalTableEntry*>(base + entries_offset);
+        SignalTableString* labels = reinterpret_cast<SignalTableString*>(base + labels_offset);
+        char* strings = reinterpret_cast<char*>(base + strings_offset);
+
+        // Fill the directory and the strings
+        uint32_t label_index = 0;
+        uint32_t string_offset = 0;
+        m_targets.resize(signals.size());
+        for (size_t i = 0; i < directory_order.size(); i++)
+        {
+            const CanMsgSignal& signal = *signals[directory_order[i]];
+            SignalTableDirectoryEntry& directory_entry = directory[i];
+            directory_entry.name.offset = string_offset;
+            directory_entry.name.length = static_cast<uint32_t>(signal.getName().size());
+            memcpy(&strings[string_offset], signal.getName().c_str(), signal.getName().size());
+            string_offset += directory_entry.name.length + 1u;
+            directory_entry.raw_type = static_cast<uint8_t>(signal.getRawValueType());
+            directory_entry.converted_type = static_cast<uint8_t>(signal.getConvertedValueType());
+
+            const EnumCanMsgValueConverter* enum_converter = dynamic_cast<const EnumCanMsgValueConverter*>(signal.getConverter());
+            directory_entry.first_label = label_index;
+            if (enum_converter != nullptr)
+            {
+                directory_entry.label_count = static_cast<uint32_t>(enum_converter->getLabelCount());
+                for (uint32_t j = 0; j < directory_entry.label_count; j++)
+                {
+                    const string_view label = enum_converter->getLabel(j);
+                    labels[label_index].offset = string_offset;
+                    labels[label_index].length = static_cast<uint32_t>(label.size());
+                    memcpy(&strings[string_offset], label.data(), label.size());
+                    string_offset += labels[label_index].length + 1u;
+                    label_index++;
+                }
+            }
+
+            SignalTarget& target = m_targets[directory_order[i]];
+            target.entry = &entries[i];
+            target.raw_type = signal.getRawValueType();
+            target.converted_type = signal.getConvertedValueType();
+            target.enum_converter = enum_converter;
+        }
+
+        // Fill the header, the magic number is written last to publish the table
+        SignalTableHeader* header = reinterpret_cast<SignalTableHeader*>(base);
+        header->version = SIGNAL_TABLE_VERSION;
+        header->size = static_cast<uint32_t>(size);
+        header->signal_count = static_cast<uint32_t>(signals.size());
+        header->directory_offset = static_cast<uint32_t>(directory_offset);
+        header->entries_offset = static_cast<uint32_t>(entries_offset);
+        header->labels_offset = static_cast<uint32_t>(labels_offset);
+        header->strings_offset = static_cast<uint32_t>(strings_offset);
+        header->magic.store(SIGNAL_TABLE_MAGIC, std::memory_order_release);
+
+        ret = true;
+    }
+    if (!ret)
+    {
+        m_targets.clear();
+    }
+
+    return ret;
+}
+
+/** \brief Remove the shared memory segment */
+bool SharedMemorySignalTable::close()
+{
+    m_targets.clear();
+    return m_shared_memory.close();
+}
+
+/** \brief Called when message has been decoded */
+void SharedMemorySignalTable::canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame)
+{
+    if (!m_targets.empty())
+    {
+        const CanMsgDesc* can_msg_desc = decoded_frame.getCanMsg();
+        const uint32_t position = m_can_msg_index.findPosition(can_msg_desc->getId(), can_msg_desc->isExtented());
+        if ((position != CanMsgDescIndex::NOT_FOUND) && (m_can_msg_index.getCanMsgs()[position] == can_msg_desc))
+        {
+            const int64_t timestamp = can_msg.header.timestamp_sec * 1000000000 + can_msg.header.timestamp_nsec;
+            const SignalTarget* targets = &m_targets[m_first_targets[position]];
+            const vector<size_t>& decoded_signals = decoded_frame.getDecodedSignals();
+            for (size_t i = 0; i < decoded_signals.size(); i++)
+            {
+                const size_t signal_index = decoded_signals[i];
+                const SignalTarget& target = targets[signal_index];
+                const CanMsgValueData& raw_value = decoded_frame.getRawValue(signal_index);
+                uint64_t converted_bits;
+                if (target.enum_converter != nullptr)
+                {
+                    converted_bits = target.enum_converter->getLabelIndex(raw_value.int_value);
+                }
+                else
+                {
+                    converted_bits = toSignalTableBits(target.converted_type, decoded_frame.getConvertedValue(signal_index));
+                }
+
+                // Update the entry under its sequence lock
+                SignalTableEntry& entry = *target.entry;
+                const uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+                entry.sequence.store(sequence + 1u, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                entry.timestamp.store(timestamp, std::memory_order_relaxed);
+                entry.raw_value.store(toSignalTableBits(target.raw_type, raw_value), std::memory_order_relaxed);
+                entry.converted_value.store(converted_bits, std::memory_order_relaxed);
+                entry.sequence.store(sequence + 2u, std::memory_order_release);
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHAREDMEMORYSIGNALTABLE_H
+#define SHAREDMEMORYSIGNALTABLE_H
+
+#include "CanMsgDecoder.h"
+#include "SharedMemorySignalTableLayout.h"
+#include "SharedMemory.h"
+
+#include <string>
+#include <vector>
+
+class ICanMsgDatabase;
+class EnumCanMsgValueConverter;
+
+
+/** \brief Publish the latest value and timestamp of every decoded signal into a shared memory segment
+           so that any number of local processes can read them without system calls
+           (see SharedMemorySignalTableReader) */
+class SharedMemorySignalTable : public ICanMsgDecoderListener
+{
+    public:
+
+        /** \brief Constructor */
+        SharedMemorySignalTable();
+
+        /** \brief Destructor */
+        virtual ~SharedMemorySignalTable();
+
+
+        /** \brief Create the shared memory segment with the layout of the signals of a database, the database must
+                   be loaded and must outlive the table. All the CAN messages of a database which builds them on demand are built */
+        bool create(const std::string& name, const ICanMsgDatabase& can_msg_database);
+
+        /** \brief Remove the shared memory segment */
+        bool close();
+
+
+        /** \brief Called when message has been decoded */
+        virtual void canMsgDecoded(const CanMsg& can_msg, const DecodedFrame& decoded_frame) override;
+
+
+    private:
+
+        /** \brief Publication of a signal */
+        struct SignalTarget
+        {
+            /** \brief Entry of the signal in the table */
+            SignalTableEntry* entry;
+            /** \brief Raw value type */
+            CanMsgValueType raw_type;
+            /** \brief Converted value type */
+            CanMsgValueType converted_type;
+            /** \brief Enumerate converter of the signal (nullptr if the signal is not converted to an enumerate label) */
+            const EnumCanMsgValueConverter* enum_converter;
+        };
+
+
+        /** \brief Shared memory segment */
+        SharedMemory m_shared_memory;
+
+        /** \brief Lookup index of the CAN messages database */
+        CanMsgDescIndex m_can_msg_index;
+
+        /** \brief Index of the first signal of each CAN message in the targets, at the position of the message in the lookup index */
+        std::vector<size_t> m_first_targets;
+
+        /** \brief Publications of all the signals of the database */
+        std::vector<SignalTarget> m_targets;
+};
+
+
+#endif // SHAREDMEMORYSIGNALTABLE_H
@@ -0,0 +1,171 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHAREDMEMORYSIGNALTABLELAYOUT_H
+#define SHAREDMEMORYSIGNALTABLELAYOUT_H
+
+#include "CanMsgValueData.h"
+
+#include <atomic>
+#include <cstring>
+
+/* Layout of the shared memory signal table, all the offsets are relative to the beginning of the segment :
+
+   | header | directory sorted by signal name | entries in the directory order | enumerate labels | strings |
+
+   Each entry is protected by a sequence lock : the writer increments the sequence number before and after
+   updating the entry so that readers retry when they see an odd number or a number which has changed
+   during their read.
+*/
+
+/** \brief Magic number of the shared memory signal table ("CSTB") */
+static const uint32_t SIGNAL_TABLE_MAGIC = 0x42545343u;
+
+/** \brief Version of the shared memory signal table layout */
+static const uint32_t SIGNAL_TABLE_VERSION = 1u;
+
+/** \brief Alignment of the entries to avoid false sharing between the signals of different messages */
+static const uint32_t SIGNAL_TABLE_ENTRIES_ALIGNMENT = 64u;
+
+
+/** \brief Header of the shared memory signal table */
+struct SignalTableHeader
+{
+    /** \brief Magic number, written last when the table is ready */
+    std::atomic<uint32_t> magic;
+    /** \brief Layout version */
+    uint32_t version;
+    /** \brief Size of the table in bytes */
+    uint32_t size;
+    /** \brief Number of signals */
+    uint32_t signal_count;
+    /** \brief Offset of the directory */
+    uint32_t directory_offset;
+    /** \brief Offset of the entries */
+    uint32_t entries_offset;
+    /** \brief Offset of the enumerate labels */
+    uint32_t labels_offset;
+    /** \brief Offset of the strings */
+    uint32_t strings_offset;
+};
+
+/** \brief String of the shared memory signal table */
+struct SignalTableString
+{
+    /** \brief Offset of the string's characters relative to the strings offset */
+    uint32_t offset;
+    /** \brief Length of the string in characters */
+    uint32_t length;
+};
+
+/** \brief Directory entry of a signal */
+struct SignalTableDirectoryEntry
+{
+    /** \brief Signal's name */
+    SignalTableString name;
+    /** \brief Index of the signal's first enumerate label */
+    uint32_t first_label;
+    /** \brief Number of enumerate labels, the converted value of an enumerate signal is the index of its label */
+    uint32_t label_count;
+    /** \brief Raw value type */
+    uint8_t raw_type;
+    /** \brief Converted value type */
+    uint8_t converted_type;
+    /** \brief Padding */
+    uint8_t reserved[6u];
+};
+
+/** \brief Latest value of a signal */
+struct SignalTableEntry
+{
+    /** \brief Sequence number, odd while the entry is being updated and 0 if the signal has never been received */
+    std::atomic<uint32_t> sequence;
+    /** \brief Padding */
+    uint32_t reserved;
+    /** \brief Timestamp in nanoseconds */
+    std::atomic<int64_t> timestamp;
+    /** \brief Raw value */
+    std::atomic<uint64_t> raw_value;
+    /** \brief Converted value */
+    std::atomic<uint64_t> converted_value;
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Shared memory signal table needs lock-free 64 bits atomics");
+
+
+/** \brief Convert a CAN message value to its representation in the shared memory signal table */
+inline uint64_t toSignalTableBits(const CanMsgValueType type, const CanMsgValueData& value)
+{
+    uint64_t bits = 0u;
+    switch (type)
+    {
+        case CANMSGVALUE_BOOL:
+        {
+            bits = (value.bool_value ? 1u : 0u);
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            uint32_t bits_32;
+            memcpy(&bits_32, &value.float_value, sizeof(bits_32));
+            bits = bits_32;
+            break;
+        }
+
+        default:
+        {
+            bits = value.uint_value;
+            break;
+        }
+    }
+    return bits;
+}
+
+/** \brief Convert a representation in the shared memory signal table to a CAN message value */
+inline CanMsgValueData fromSignalTableBits(const CanMsgValueType type, const uint64_t bits)
+{
+    CanMsgValueData value;
+    value.uint_value = 0u;
+    switch (type)
+    {
+        case CANMSGVALUE_BOOL:
+        {
+            value.bool_value = (bits != 0u);
+            break;
+        }
+
+        case CANMSGVALUE_FLOAT:
+        {
+            const uint32_t bits_32 = static_cast<uint32_t>(bits);
+            memcpy(&value.float_value, &bits_32, sizeof(bits_32));
+            break;
+        }
+
+        default:
+        {
+            value.uint_value = bits;
+            break;
+        }
+    }
+    return value;
+}
+
+
+#endif // SHAREDMEMORYSIGNALTABLELAYOUT_H
@@ -0,0 +1,168 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SharedMemorySignalTableReader.h"
+
+using namespace std;
+
+
+/** \brief Constructor */
+SharedMemorySignalTableReader::SharedMemorySignalTableReader()
+: m_shared_memory()
+, m_header(nullptr)
+, m_directory(nullptr)
+, m_entries(nullptr)
+, m_labels(nullptr)
+, m_strings(nullptr)
+{}
+
+/** \brief Destructor */
+SharedMemorySignalTableReader::~SharedMemorySignalTableReader()
+{
+    close();
+}
+
+/** \brief Open a shared memory signal table, return false if the table doesn't exist or is not valid */
+bool SharedMemorySignalTableReader::open(const std::string& name)
+{
+    bool ret = false;
+
+    if ((m_header == nullptr) && m_shared_memory.open(name))
+    {
+        // Check the layout
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(m_shared_memory.getAddress());
+        const SignalTableHeader* header = reinterpret_cast<const SignalTableHeader*>(base);
+        if ((m_shared_memory.getSize() >= sizeof(SignalTableHeader)) &&
+            (header->magic.load(std::memory_order_acquire) == SIGNAL_TABLE_MAGIC) &&
+            (header->version == SIGNAL_TABLE_VERSION) &&
+            (header->size <= m_shared_memory.getSize()) &&
+            (header->directory_offset <= header->entries_offset) &&
+            (header->entries_offset <= header->labels_offset) &&
+            (header->labels_offset <= header->strings_offset) &&
+            (header->strings_offset <= header->size))
+        {
+            m_header = header;
+            m_directory = reinterpret_cast<const SignalTableDirectoryEntry*>(base + header->directory_offset);
+            m_entries = reinterpret_cast<SignalTableEntry*>(const_cast<uint8_t*>(base + header->entries_offset));
+            m_labels = reinterpret_cast<const SignalTableString*>(base + header->labels_offset);
+            m_strings = reinterpret_cast<const char*>(base + header->strings_offset);
+            ret = true;
+        }
+        else
+        {
+            m_shared_memory.close();
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Close the shared memory signal table */
+bool SharedMemorySignalTableReader::close()
+{
+    m_header = nullptr;
+    m_directory = nullptr;
+    m_entries = nullptr;
+    m_labels = nullptr;
+    m_strings = nullptr;
+    return m_shared_memory.close();
+}
+
+/** \brief Look for the id of a signal in the table, return false if the signal doesn't exist */
+bool SharedMemorySignalTableReader::findSignal(const std::string& signal_name, size_t& signal_id) const
+{
+    bool ret = false;
+
+    // Binary search in the directory sorted by name
+    size_t first = 0;
+    size_t count = getSignalCount();
+    while (count != 0)
+    {
+        const size_t step = count / 2u;
+        if (getString(m_directory[first + step].name) < signal_name)
+        {
+            first += step + 1u;
+            count -= step + 1u;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    if ((first < getSignalCount()) && (getString(m_directory[first].name) == signal_name))
+    {
+        signal_id = first;
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** \brief Get an enumerate label of a signal (empty if the label doesn't exist) */
+std::string_view SharedMemorySignalTableReader::getLabel(const size_t signal_id, const uint64_t label_index) const
+{
+    string_view label;
+    const SignalTableDirectoryEntry& directory_entry = m_directory[signal_id];
+    if (label_index < directory_entry.label_count)
+    {
+        label = getString(m_labels[directory_entry.first_label + label_index]);
+    }
+    return label;
+}
+
+/** \brief Read the latest value of a signal, return false if the signal has not been received yet */
+bool SharedMemorySignalTableReader::read(const size_t signal_id, Sample& sample) const
+{
+    const SignalTableEntry& entry = m_entries[signal_id];
+    uint32_t sequence;
+    uint64_t raw_bits;
+    uint64_t converted_bits;
+    bool consistent = false;
+    do
+    {
+        // Retry while the writer is updating the entry
+        sequence = entry.sequence.load(std::memory_order_acquire);
+        if ((sequence & 1u) == 0)
+        {
+            sample.timestamp = entry.timestamp.load(std::memory_order_relaxed);
+            raw_bits = entry.raw_value.load(std::memory_order_relaxed);
+            converted_bits = entry.converted_value.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            consistent = (entry.sequence.load(std::memory_order_relaxed) == sequence);
+        }
+    }
+    while (!consistent);
+
+    const bool ret = (sequence != 0);
+    if (ret)
+    {
+        const SignalTableDirectoryEntry& directory_entry = m_directory[signal_id];
+        sample.raw_value = fromSignalTableBits(static_cast<CanMsgValueType>(directory_entry.raw_type), raw_bits);
+        if (directory_entry.label_count != 0)
+        {
+            sample.converted_value.uint_value = converted_bits;
+        }
+        else
+        {
+            sample.converted_value = fromSignalTableBits(static_cast<CanMsgValueType>(directory_entry.converted_type), converted_bits);
+        }
+    }
+
+    return ret;
+}
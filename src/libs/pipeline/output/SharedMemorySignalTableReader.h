@@ -0,0 +1,111 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHAREDMEMORYSIGNALTABLEREADER_H
+#define SHAREDMEMORYSIGNALTABLEREADER_H
+
+#include "SharedMemorySignalTableLayout.h"
+#include "SharedMemory.h"
+
+#include <string>
+#include <string_view>
+
+
+/** \brief Read the latest values of the signals published by a SharedMemorySignalTable in another process,
+           the values are read directly from the shared memory without any system call */
+class SharedMemorySignalTableReader
+{
+    public:
+
+        /** \brief Latest value of a signal */
+        struct Sample
+        {
+            /** \brief Timestamp in nanoseconds */
+            int64_t timestamp;
+            /** \brief Raw value */
+            CanMsgValueData raw_value;
+            /** \brief Converted value (index of the label in uint_value for the enumerate signals) */
+            CanMsgValueData converted_value;
+        };
+
+
+        /** \brief Constructor */
+        SharedMemorySignalTableReader();
+
+        /** \brief Destructor */
+        virtual ~SharedMemorySignalTableReader();
+
+
+        /** \brief Open a shared memory signal table, return false if the table doesn't exist or is not valid */
+        bool open(const std::string& name);
+
+        /** \brief Close the shared memory signal table */
+        bool close();
+
+
+        /** \brief Get the number of signals in the table */
+        size_t getSignalCount() const { return (m_header != nullptr) ? m_header->signal_count : 0u; }
+
+        /** \brief Look for the id of a signal in the table, return false if the signal doesn't exist */
+        bool findSignal(const std::string& signal_name, size_t& signal_id) const;
+
+        /** \brief Get the name of a signal */
+        std::string_view getSignalName(const size_t signal_id) const { return getString(m_directory[signal_id].name); }
+
+        /** \brief Get the raw value type of a signal */
+        CanMsgValueType getRawValueType(const size_t signal_id) const { return static_cast<CanMsgValueType>(m_directory[signal_id].raw_type); }
+
+        /** \brief Get the converted value type of a signal */
+        CanMsgValueType getConvertedValueType(const size_t signal_id) const { return static_cast<CanMsgValueType>(m_directory[signal_id].converted_type); }
+
+        /** \brief Get an enumerate label of a signal (empty if the label doesn't exist) */
+        std::string_view getLabel(const size_t signal_id, const uint64_t label_index) const;
+
+
+        /** \brief Read the latest value of a signal, return false if the signal has not been received yet */
+        bool read(const size_t signal_id, Sample& sample) const;
+
+
+    private:
+
+        /** \brief Shared memory segment */
+        SharedMemory m_shared_memory;
+
+        /** \brief Header */
+        const SignalTableHeader* m_header;
+
+        /** \brief Directory */
+        const SignalTableDirectoryEntry* m_directory;
+
+        /** \brief Entries */
+        SignalTableEntry* m_entries;
+
+        /** \brief Enumerate labels */
+        const SignalTableString* m_labels;
+
+        /** \brief Strings */
+        const char* m_strings;
+
+
+        /** \brief Get a string of the table */
+        std::string_view getString(const SignalTableString& str) const { return std::string_view(&m_strings[str.offset], str.length); }
+};
+
+
+#endif // SHAREDMEMORYSIGNALTABLEREADER_H
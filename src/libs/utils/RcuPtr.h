@@ -0,0 +1,153 @@
+/*
+Copyright(c) 2019 Cedric Jimenez
+
+This file is part of cantools.
+
+cantools is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+cantools is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with cantools.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RCUPTR_H
+#define RCUPTR_H
+
+
+#include "NoCopy.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+
+/** \brief Read-copy-update pointer : readers access the current immutable object without locking
+           while writers publish a new object with an atomic pointer swap. The previous object
+           is released once all the readers of the previous epoch have left */
+template <typename T>
+class RcuPtr : public INoCopy
+{
+    public:
+
+        /** \brief Read access to the current object, valid for the lifetime of the guard */
+        class ReadGuard : public INoCopy
+        {
+            public:
+
+                /** \brief Constructor */
+                ReadGuard(const RcuPtr& rcu_ptr)
+                : m_readers(rcu_ptr.enter())
+                , m_object(rcu_ptr.m_current.load())
+                {}
+
+                /** \brief Destructor */
+                ~ReadGuard()
+                {
+                    m_readers.fetch_sub(1u);
+                }
+
+                /** \brief Access to the object */
+                const T& operator * () const { return *m_object; }
+
+                /** \brief Access to the object */
+                const T* operator -> () const { return m_object; }
+
+
+            private:
+
+                /** \brief Readers counter of the epoch */
+                std::atomic<uint32_t>& m_readers;
+
+                /** \brief Object */
+                const T* const m_object;
+        };
+
+
+        /** \brief Constructor */
+        RcuPtr(T* object)
+        : m_current(object)
+        , m_epoch(0u)
+        , m_writer_mutex()
+        {
+            m_readers[0u] = 0u;
+            m_readers[1u] = 0u;
+        }
+
+        /** \brief Destructor */
+        virtual ~RcuPtr()
+        {
+            delete m_current.load();
+        }
+
+
+        /** \brief Publish a new object, the previous one is released when no reader accesses it anymore */
+        void publish(T* object)
+        {
+            std::lock_guard<std::mutex> lock(m_writer_mutex);
+            swap(object);
+        }
+
+        /** \brief Publish a modified copy of the current object */
+        template <typename UpdateFunc>
+        void update(UpdateFunc update_func)
+        {
+            std::lock_guard<std::mutex> lock(m_writer_mutex);
+            T* object = new T(*m_current.load());
+            update_func(*object);
+            swap(object);
+        }
+
+
+    private:
+
+        /** \brief Current object */
+        std::atomic<T*> m_current;
+
+        /** \brief Current epoch */
+        std::atomic<uint32_t> m_epoch;
+
+        /** \brief Readers counters for the current and the previous epoch */
+        mutable std::atomic<uint32_t> m_readers[2u];
+
+        /** \brief Mutex to serialize the writers */
+        std::mutex m_writer_mutex;
+
+
+        /** \brief Register a reader in the current epoch */
+        std::atomic<uint32_t>& enter() const
+        {
+            while (true)
+            {
+                const uint32_t epoch = m_epoch.load();
+                std::atomic<uint32_t>& readers = m_readers[epoch & 1u];
+                readers.fetch_add(1u);
+                if (m_epoch.load() == epoch)
+                {
+                    return readers;
+                }
+                readers.fetch_sub(1u);
+            }
+        }
+
+        /** \brief Swap the current object and wait for the readers of the previous epoch before releasing it */
+        void swap(T* object)
+        {
+            T* previous = m_current.exchange(object);
+            const uint32_t epoch = m_epoch.fetch_add(1u);
+            while (m_readers[epoch & 1u].load() != 0u)
+            {
+                std::this_thread::yield();
+            }
+            delete previous;
+        }
+};
+
+
+#endif // RCUPTR_H
@@ -53,6 +53,8 @@ class TcpCanSerializer : public INoCopy
             CMD_MSG = 0xF00Du,
             /** \brief Error frame */
             CMD_ERR_FRAME = 0xBAADu,
+            /** \brief Acceptance filters : filter count (16 bits) followed by id (32 bits), mask (32 bits) and flags (8 bits) for each filter */
+            CMD_FILTERS = 0xF117u,
         };
 
         /** \brief Flags */
@@ -21,6 +21,7 @@ along with cantools.  If not, see <http://www.gnu.org/licenses/>.
 #define VECTORHELPER_H
 
 #include <vector>
+#include <cstddef>
 
 
 /** \brief Look for a value in the vector from the start of the vector */